@@ -0,0 +1,75 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/camera_file_wrapper.hpp>
+#include <gphoto2pp/camera_file_path_wrapper.hpp>
+#include <gphoto2pp/focus_stack.hpp>
+
+#include <gphoto2pp/exceptions.hpp>
+
+#include <iostream>
+
+/*
+ * Example 12 takes the same 10 preview pictures as example 8, stepping through the manual focus range, but with the FocusStack sequencer.
+ * The configuration is only read once, and the sequencer waits for the focus to settle instead of sleeping half a second on every step.
+ */
+
+int main(int argc, char* argv[]) {
+	try
+	{
+		std::cout << "#############################" << std::endl;
+		std::cout << "# Focus stack               #" << std::endl;
+		std::cout << "#############################" << std::endl;
+		
+		gphoto2pp::CameraWrapper cameraWrapper;
+		
+		gphoto2pp::FocusStack focusStack(cameraWrapper);
+		
+		// Same values as example 8, 10 steps of 512 covers my Nikon D90 with the DX 35mm 1.8 lens from close to infinity
+		focusStack.setSteps(10);
+		focusStack.setRangeStep(512);
+		
+		// The Nikon driver only returns once the lens stopped, other cameras may need more time
+		focusStack.setSettleTime(std::chrono::milliseconds(50));
+		
+		auto result = focusStack.run([](gphoto2pp::CameraFilePathWrapper const & cameraFilePath, gphoto2pp::CameraFileWrapper& cameraFile)
+		{
+			// This is called on a worker thread while the focus moves for the next picture
+			cameraFile.save("example12_" + cameraFilePath.Name);
+		});
+		
+		for(std::size_t i = 0; i < result.Steps.size(); ++i)
+		{
+			std::cout << "Step " << i << ": drive " << result.Steps[i].Drive.count() << "ms, settle " << result.Steps[i].Settle.count() << "ms, capture " << result.Steps[i].Capture.count() << "ms" << std::endl;
+		}
+		
+		std::cout << "Total: " << result.Total.count() << "ms" << std::endl;
+	}
+	catch (const gphoto2pp::exceptions::gphoto2_exception& e)
+	{
+		std::cout << "GPhoto Exception Code: " << e.getResultCode() << std::endl;
+		std::cout << "Exception Message: " << e.what() << std::endl;
+	}
+}
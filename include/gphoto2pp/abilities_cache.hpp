@@ -0,0 +1,85 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#ifndef ABILITIESCACHE_HPP
+#define ABILITIESCACHE_HPP
+
+#include <string>
+#include <vector>
+
+namespace gphoto2pp
+{
+	class CameraAbilitiesListWrapper;
+	
+	/**
+	 * \class AbilitiesCache
+	 * A file holding a copy of the camera abilities list, so a new process doesn't have to query every camera driver again.
+	 * 
+	 * The file is only used while its key still matches, the key is made of the libgphoto2 version, the size of the abilities struct, and the modification time of every driver directory (the directories given plus the CAMLIBS environment variable, if set). Installing, removing or upgrading a driver changes its directory, which makes the file stale.
+	 * 
+	 * The file is memory mapped when loading and replaced atomically when saving, so several processes can share one.
+	 */
+	class AbilitiesCache
+	{
+	public:
+		/**
+		 * \param[in]	cacheFile	path of the cache file, its directory must exist
+		 * \param[in]	driverDirectories	where the camera drivers are installed (e.g. /usr/lib/libgphoto2/2.5.4), changes to them invalidate the cache
+		 */
+		explicit AbilitiesCache(std::string cacheFile, std::vector<std::string> driverDirectories = {});
+		
+		std::string const & getCacheFile() const;
+		
+		std::vector<std::string> const & getDriverDirectories() const;
+		
+		/**
+		 * \brief Computes the key the cache file has to match, from the current library version and driver directories
+		 * \return the key
+		 */
+		std::string computeKey() const;
+		
+		/**
+		 * \brief Appends the cached abilities to the list, if the cache file exists and is still valid
+		 * \param[in]	abilitiesList	to append to, should be empty
+		 * \return true if the list was filled from the file, false if it has to be loaded from the drivers (the list is then left empty)
+		 * \note Calls <tt>gp_abilities_list_append(...)</tt> for each cached camera model
+		 */
+		bool load(CameraAbilitiesListWrapper& abilitiesList) const;
+		
+		/**
+		 * \brief Writes the list to the cache file, with the current key
+		 * \param[in]	abilitiesList	to save
+		 * \return true if the file was written, failures are logged but not thrown since the cache is optional
+		 */
+		bool save(CameraAbilitiesListWrapper const & abilitiesList) const;
+		
+	private:
+		std::string m_cacheFile;
+		std::vector<std::string> m_driverDirectories;
+	};
+}
+
+#endif // ABILITIESCACHE_HPP
@@ -0,0 +1,134 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef ASYNCLOGWRITER_HPP
+#define ASYNCLOGWRITER_HPP
+
+#include <gphoto2pp/log.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		class AsyncLogRing;
+	}
+	
+	/**
+	 * \class AsyncLogWriter
+	 * Takes over the output of FILE_LOG(...) for its lifetime, moving the timestamp formatting and the writes off the logging threads.
+	 * 
+	 * Each logging thread copies its messages into its own fixed size ring, without locking. The writer thread collects the rings every flush interval, formats the records and writes them to Output2FILE::Stream() with one write and one flush per batch. While a thread's ring is full its messages are dropped and counted, so the memory used stays bounded, and the count is reported in the log.
+	 * 
+	 * \code
+	 * gphoto2pp::AsyncLogWriter logWriter;	// at the start of main
+	 * FILELog::ReportingLevel() = logINFO;
+	 * FILELog::SetSubsystemLevel(logsysPORT, logDEBUG);
+	 * \endcode
+	 */
+	class AsyncLogWriter
+	{
+	public:
+		/**
+		 * Longer messages are truncated
+		 */
+		static const std::size_t MaxMessageLength = 480;
+		
+		/**
+		 * \brief Installs the writer as the sink of FILE_LOG(...) and starts its thread
+		 * \param[in]	recordsPerThread	capacity of each logging thread's ring
+		 * \param[in]	flushInterval	between two batches of the writer thread
+		 * \throw GPhoto2ppException if another writer is already installed
+		 */
+		explicit AsyncLogWriter(std::size_t recordsPerThread = 256, std::chrono::milliseconds flushInterval = std::chrono::milliseconds(20));
+		
+		/**
+		 * \brief Uninstalls the writer, then writes the messages left and stops its thread
+		 */
+		~AsyncLogWriter();
+		
+		AsyncLogWriter(AsyncLogWriter const & other) = delete;
+		AsyncLogWriter& operator=(AsyncLogWriter const & other) = delete;
+		
+		/**
+		 * \brief Blocks until every message logged before the call has been written
+		 */
+		void flush();
+		
+		/**
+		 * \brief Counts the messages written so far
+		 * \return the number of messages written
+		 */
+		std::uint64_t getWrittenCount() const;
+		
+		/**
+		 * \brief Counts the messages dropped so far because their thread's ring was full
+		 * \return the number of messages dropped
+		 */
+		std::uint64_t getDroppedCount() const;
+		
+	private:
+		static void sink(TLogLevel level, TLogSubsystem subsystem, std::ostringstream& message);
+		
+		void push(TLogLevel level, TLogSubsystem subsystem, std::ostringstream& message);
+		void run();
+		void writeBatch();
+		
+		std::size_t const m_recordsPerThread;
+		std::chrono::milliseconds const m_flushInterval;
+		std::uint64_t const m_generation;
+		
+		std::mutex m_ringsMutex;
+		std::vector<std::shared_ptr<detail::AsyncLogRing>> m_rings;
+		
+		std::atomic<std::uint64_t> m_written;
+		std::atomic<std::uint64_t> m_dropped;
+		std::uint64_t m_droppedReported;
+		
+		// Only used by the writer thread
+		std::string m_buffer;
+		
+		std::mutex m_mutex;
+		std::condition_variable m_wakeup;
+		std::condition_variable m_batchWritten;
+		bool m_stop;
+		bool m_flushRequested;
+		std::uint64_t m_batchesStarted;
+		std::uint64_t m_batchesWritten;
+		
+		std::thread m_thread;
+	};
+}
+
+#endif // ASYNCLOGWRITER_HPP
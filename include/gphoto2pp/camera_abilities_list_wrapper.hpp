@@ -25,6 +25,7 @@
 #ifndef CAMERAABILITIESLISTWRAPPER_H
 #define CAMERAABILITIESLISTWRAPPER_H
 
+#include <chrono>
 #include <string>
 
 namespace gphoto2
@@ -37,6 +38,17 @@ namespace gphoto2pp
 {
 	class GPPortInfoListWrapper;
 	class CameraListWrapper;
+	class AbilitiesCache;
+	
+	/**
+	 * \struct AbilitiesLoadStatistics
+	 * How long an abilities list took to load, and where it came from.
+	 */
+	struct AbilitiesLoadStatistics
+	{
+		std::chrono::microseconds Duration;
+		bool FromCache;		///< true if the list was read from an AbilitiesCache file instead of the drivers
+	};
 	
 	/**
 	 * \class CameraAbilitiesListWrapper
@@ -46,6 +58,14 @@ namespace gphoto2pp
 	{
 	public:
 		CameraAbilitiesListWrapper();
+		
+		/**
+		 * \brief Loads the list from the cache file if it is still valid, otherwise loads it from the drivers and saves it to the cache file
+		 * \param[in]	cache	to load from and save to
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		explicit CameraAbilitiesListWrapper(AbilitiesCache const & cache);
+		
 		~CameraAbilitiesListWrapper();
 		
 		// Move constructor and move assignment are allowed
@@ -56,6 +76,28 @@ namespace gphoto2pp
 		CameraAbilitiesListWrapper(CameraAbilitiesListWrapper const & other) = delete;
 		CameraAbilitiesListWrapper& operator=(CameraAbilitiesListWrapper const & other) = delete;
 		
+		/**
+		 * \brief Gets the abilities list shared by the whole process.
+		 * Loading the list queries every camera driver, which takes a while, so this list is loaded once (on first use, thread safe) and then reused for every camera opened or detected.
+		 * \return the shared list, which must not be modified
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		static CameraAbilitiesListWrapper const & getShared();
+		
+		/**
+		 * \brief Makes the shared list (see getShared()) load from and save to the given cache.
+		 * Has to be called before the shared list is first used.
+		 * \param[in]	cache	to use
+		 * \return false if the shared list was already loaded, so the cache wasn't used
+		 */
+		static bool setSharedCache(AbilitiesCache cache);
+		
+		/**
+		 * \brief Gets how long this list took to load
+		 * \return the statistics
+		 */
+		AbilitiesLoadStatistics const & getLoadStatistics() const;
+		
 		gphoto2::_CameraAbilitiesList* getPtr() const;
 		
 		/**
@@ -64,7 +106,7 @@ namespace gphoto2pp
 		 * \note Direct wrapper for <tt>gp_abilities_list_detect(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
-		CameraListWrapper listDetect(GPPortInfoListWrapper const & portInfoList);
+		CameraListWrapper listDetect(GPPortInfoListWrapper const & portInfoList) const;
 		
 		/**
 		 * \brief Resets the abilities list
@@ -92,6 +134,7 @@ namespace gphoto2pp
 		
 	private:
 		gphoto2::_CameraAbilitiesList* m_cameraAbilitiesList;
+		AbilitiesLoadStatistics m_loadStatistics;
 	};
 }
 
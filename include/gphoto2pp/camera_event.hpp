@@ -0,0 +1,176 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#ifndef CAMERAEVENT_HPP
+#define CAMERAEVENT_HPP
+
+#include <gphoto2pp/camera_event_type_wrapper.hpp>
+#include <gphoto2pp/camera_file_path_wrapper.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		/**
+		 * \class InlineString
+		 * A string kept in a fixed buffer, only texts of N characters or more are allocated.
+		 */
+		template <std::size_t N>
+		class InlineString
+		{
+		public:
+			InlineString()
+				: m_length{0}
+				, m_overflow{}
+			{
+				m_buffer[0] = '\0';
+			}
+			
+			void assign(char const * text)
+			{
+				m_length = std::strlen(text);
+				
+				if(m_length < N)
+				{
+					std::memcpy(m_buffer, text, m_length + 1);
+					m_overflow.clear();
+				}
+				else
+				{
+					m_buffer[0] = '\0';
+					m_overflow.assign(text, m_length);
+				}
+			}
+			
+			char const * c_str() const
+			{
+				return m_length < N ? m_buffer : m_overflow.c_str();
+			}
+			
+			std::size_t size() const
+			{
+				return m_length;
+			}
+			
+		private:
+			char m_buffer[N];
+			std::size_t m_length;
+			std::string m_overflow;
+		};
+	}
+	
+	/**
+	 * \class CameraEvent
+	 * An event from the camera with its typed payload: the path of a FileAdded or FolderAdded event, or the text of an Unknown event (with the property code if it is a PTP property change).
+	 * 
+	 * The payload is kept in small inline buffers, so building and passing an event doesn't allocate. toFilePath() and toText() make owning copies.
+	 */
+	class CameraEvent
+	{
+	public:
+		/**
+		 * \brief An event without payload (Timeout, CaptureComplete, or an Unknown event without data)
+		 * \param[in]	type	of the event
+		 */
+		explicit CameraEvent(CameraEventTypeWrapper type);
+		
+		/**
+		 * \brief A FileAdded or FolderAdded event
+		 * \param[in]	type	of the event
+		 * \param[in]	folder	of the file or folder
+		 * \param[in]	name	of the file or folder
+		 */
+		CameraEvent(CameraEventTypeWrapper type, char const * folder, char const * name);
+		
+		/**
+		 * \brief An Unknown event with its text, parsed for a property change
+		 * \param[in]	text	of the event
+		 */
+		explicit CameraEvent(char const * text);
+		
+		CameraEventTypeWrapper getType() const;
+		
+		/**
+		 * \brief Checks if the event carries a path (FileAdded and FolderAdded)
+		 * \return true if getFolder() and getName() are set
+		 */
+		bool hasFilePath() const;
+		
+		char const * getFolder() const;
+		
+		char const * getName() const;
+		
+		/**
+		 * \brief Checks if the event carries a text (Unknown events with data)
+		 * \return true if getText() is set
+		 */
+		bool hasText() const;
+		
+		char const * getText() const;
+		
+		/**
+		 * \brief Checks if the text reported a PTP property change (see parsePropertyChangedEvent(...))
+		 * \return true if getPropertyCode() is set
+		 */
+		bool isPropertyChanged() const;
+		
+		int getPropertyCode() const;
+		
+		/**
+		 * \brief Copies the path
+		 * \return the path, empty if the event has none
+		 */
+		CameraFilePathWrapper toFilePath() const;
+		
+		/**
+		 * \brief Copies the text
+		 * \return the text, empty if the event has none
+		 */
+		std::string toText() const;
+		
+	private:
+		enum class Payload : int
+		{
+			None,
+			FilePath,
+			Text
+		};
+		
+		CameraEventTypeWrapper m_type;
+		Payload m_payload;
+		int m_propertyCode;
+		
+		// The folder or the text, and the name
+		detail::InlineString<96> m_first;
+		detail::InlineString<32> m_second;
+	};
+}
+
+#endif // CAMERAEVENT_HPP
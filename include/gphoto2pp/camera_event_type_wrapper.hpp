@@ -25,6 +25,8 @@
 #ifndef CAMERAEVENTTYPEWRAPPER_HPP
 #define CAMERAEVENTTYPEWRAPPER_HPP
 
+#include <gphoto2pp/observer.hpp>
+
 namespace gphoto2pp
 {
 	/**
@@ -38,6 +40,16 @@ namespace gphoto2pp
 		FolderAdded = 3,		///< Maps to GP_EVENT_FOLDER_ADDED
 		CaptureComplete = 4,	///< Maps to GP_EVENT_CAPTURE_COMPLETE
 	};
+	
+	namespace observer
+	{
+		// Dispatched through a fixed array, the listener raises an event every 400ms
+		template <>
+		struct DenseEventTraits<CameraEventTypeWrapper>
+		{
+			static const std::size_t Count = 5;
+		};
+	}
 }
 
 #endif // CAMERAEVENTTYPEWRAPPER_HPP
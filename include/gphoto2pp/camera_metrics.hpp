@@ -0,0 +1,199 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef CAMERAMETRICS_HPP
+#define CAMERAMETRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gphoto2pp
+{
+	/**
+	 * \class CameraMetrics
+	 * The counters of one camera, updated by its CameraWrapper with relaxed atomic operations only.
+	 * 
+	 * The counters outlive the CameraWrapper: a wrapper connecting to the same model and port later continues them (see MetricsRegistry::connectCamera(...)).
+	 */
+	class CameraMetrics
+	{
+	public:
+		/**
+		 * Error codes are counted individually from -1 to -(ErrorCodeCount - 1), the others together
+		 */
+		static const std::size_t ErrorCodeCount = 128;
+		
+		CameraMetrics(std::string model, std::string port);
+		
+		CameraMetrics(CameraMetrics const & other) = delete;
+		CameraMetrics& operator=(CameraMetrics const & other) = delete;
+		
+		std::string const & getModel() const;
+		std::string const & getPort() const;
+		
+		void addCapture();
+		void addPreviewFrame();
+		void addBytesDownloaded(std::uint64_t bytes);
+		void addError(int resultCode);
+		void addReconnect();
+		
+		/**
+		 * \brief Counts a call waiting for the camera while another call uses it, until removeWaitingCall()
+		 */
+		void addWaitingCall();
+		void removeWaitingCall();
+		
+		std::uint64_t getCaptures() const;
+		std::uint64_t getPreviewFrames() const;
+		std::uint64_t getBytesDownloaded() const;
+		std::uint64_t getReconnects() const;
+		std::int64_t getWaitingCalls() const;
+		
+		/**
+		 * \brief Gets the errors counted for a result code
+		 * \param[in]	resultCode	a GP_ERROR_* code, or 0 for the codes which aren't counted individually
+		 * \return the count
+		 */
+		std::uint64_t getErrors(int resultCode) const;
+		
+	private:
+		static std::size_t errorIndex(int resultCode);
+		
+		std::string const m_model;
+		std::string const m_port;
+		
+		std::atomic<std::uint64_t> m_captures;
+		std::atomic<std::uint64_t> m_previewFrames;
+		std::atomic<std::uint64_t> m_bytesDownloaded;
+		std::atomic<std::uint64_t> m_reconnects;
+		std::atomic<std::int64_t> m_waitingCalls;
+		std::array<std::atomic<std::uint64_t>, ErrorCodeCount> m_errors;
+	};
+	
+	/**
+	 * \class MetricsRegistry
+	 * The metrics of every camera connected in the process, with a rendering in the Prometheus text format.
+	 * 
+	 * Every CameraWrapper reports to the shared registry (see getShared()). Besides the per camera counters, the rendering includes the errors of all gphoto2 methods (see getResponseErrorCounts()).
+	 */
+	class MetricsRegistry
+	{
+	public:
+		/**
+		 * \brief The registry the CameraWrappers report to
+		 * \return the process wide registry
+		 */
+		static MetricsRegistry& getShared();
+		
+		MetricsRegistry();
+		
+		MetricsRegistry(MetricsRegistry const & other) = delete;
+		MetricsRegistry& operator=(MetricsRegistry const & other) = delete;
+		
+		/**
+		 * \brief Gets the metrics of a camera being connected, a camera which was connected before counts a reconnect
+		 * \param[in]	model	of the camera
+		 * \param[in]	port	of the camera
+		 * \return the camera's metrics
+		 */
+		std::shared_ptr<CameraMetrics> connectCamera(std::string const & model, std::string const & port);
+		
+		/**
+		 * \brief Gets the metrics of every camera connected so far
+		 * \return the metrics, by model then port
+		 */
+		std::vector<std::shared_ptr<CameraMetrics const>> getCameras() const;
+		
+		/**
+		 * \brief Renders all metrics in the Prometheus text exposition format, to be served for scraping
+		 * \return the text
+		 */
+		std::string renderPrometheus() const;
+		
+	private:
+		mutable std::mutex m_mutex;
+		std::map<std::pair<std::string, std::string>, std::shared_ptr<CameraMetrics>> m_cameras;
+	};
+	
+	/**
+	 * \class MetricsFileWriter
+	 * Rewrites a file with the rendering of a registry periodically, from its own thread, eg. for the node exporter's textfile collector.
+	 * 
+	 * The file is replaced atomically, a reader never sees a partial file.
+	 */
+	class MetricsFileWriter
+	{
+	public:
+		/**
+		 * \brief Starts the writer thread, which writes the file right away
+		 * \param[in]	registry	to render, must outlive the writer
+		 * \param[in]	file	to rewrite
+		 * \param[in]	interval	between two writes
+		 */
+		MetricsFileWriter(MetricsRegistry const & registry, std::string file, std::chrono::milliseconds interval = std::chrono::seconds(15));
+		
+		/**
+		 * \brief Stops the writer thread, after a last write
+		 */
+		~MetricsFileWriter();
+		
+		MetricsFileWriter(MetricsFileWriter const & other) = delete;
+		MetricsFileWriter& operator=(MetricsFileWriter const & other) = delete;
+		
+		/**
+		 * \brief Writes the file now, safe to call while the writer thread writes it
+		 * \return true if the file was replaced, false if it couldn't be written (the reason is logged)
+		 */
+		bool write() const;
+		
+	private:
+		void run();
+		
+		MetricsRegistry const & m_registry;
+		std::string const m_file;
+		std::chrono::milliseconds const m_interval;
+		
+		// Every write goes through the same temporary file
+		mutable std::mutex m_writeMutex;
+		
+		std::mutex m_mutex;
+		std::condition_variable m_stopCondition;
+		bool m_stopRequested;
+		
+		std::thread m_thread;
+	};
+}
+
+#endif // CAMERAMETRICS_HPP
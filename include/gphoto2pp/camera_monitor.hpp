@@ -0,0 +1,173 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#ifndef CAMERAMONITOR_HPP
+#define CAMERAMONITOR_HPP
+
+#include <gphoto2pp/observer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gphoto2pp
+{
+	/**
+	 * \enum CameraMonitorEvent
+	 * The events raised by a CameraMonitor
+	 */
+	enum class CameraMonitorEvent : int
+	{
+		CameraArrived,
+		CameraDeparted
+	};
+	
+	namespace observer
+	{
+		template <>
+		struct DenseEventTraits<CameraMonitorEvent>
+		{
+			static const std::size_t Count = 2;
+		};
+	}
+	
+	/**
+	 * \struct DetectedCamera
+	 * A camera found by a scan, identified by its model and port (e.g. "usb:001,005")
+	 */
+	struct DetectedCamera
+	{
+		std::string Model;
+		std::string Port;
+		
+		bool operator==(DetectedCamera const & other) const;
+		bool operator<(DetectedCamera const & other) const;
+	};
+	
+	/**
+	 * \class CameraMonitor
+	 * Scans for cameras on a background thread and raises an event whenever one is plugged in or removed.
+	 * 
+	 * A scan reuses the process-wide abilities list (see CameraAbilitiesListWrapper::getShared()), so only the ports are enumerated again. The interval starts at the minimum, doubles after every scan which found no change up to the maximum, and drops back to the minimum when something changed.
+	 * 
+	 * The callbacks run on the monitor's thread. Subscribing and unsubscribing is safe while the monitor runs.
+	 */
+	class CameraMonitor
+	{
+	public:
+		/**
+		 * \param[in]	minInterval	between two scans, used after a change was seen
+		 * \param[in]	maxInterval	between two scans, reached while nothing changes
+		 */
+		CameraMonitor(std::chrono::milliseconds minInterval = std::chrono::milliseconds(500), std::chrono::milliseconds maxInterval = std::chrono::milliseconds(4000));
+		
+		/**
+		 * \brief Stops the monitor and waits for its thread
+		 */
+		~CameraMonitor();
+		
+		CameraMonitor(CameraMonitor const & other) = delete;
+		CameraMonitor& operator=(CameraMonitor const & other) = delete;
+		
+		/**
+		 * \brief Subscribes to arrivals or departures.
+		 * Cameras attached when the monitor starts are reported as arrived by the first scan. The callback runs on the monitor's thread, an exception it throws is logged and the remaining subscribers miss that camera.
+		 * \param[in]	event	type to subscribe to
+		 * \param[in]	func	callback, called with the camera which arrived or departed
+		 * \return the registration, the subscription ends when it is destroyed
+		 */
+		observer::Registration subscribe(CameraMonitorEvent const & event, std::function<void(DetectedCamera const &)> func);
+		
+		/**
+		 * \brief Starts scanning, the first scan happens right away
+		 * \return true if started, false if it is already running
+		 */
+		bool start();
+		
+		/**
+		 * \brief Stops scanning and waits for the current scan to finish
+		 */
+		void stop();
+		
+		bool isRunning() const;
+		
+		/**
+		 * \brief Gets the cameras found by the last scan
+		 * \return the cameras, sorted by model then port
+		 */
+		std::vector<DetectedCamera> getCameras() const;
+		
+		/**
+		 * \brief Gets the time until the next scan, as adapted so far
+		 * \return the current interval
+		 */
+		std::chrono::milliseconds getCurrentInterval() const;
+		
+		/**
+		 * \brief Scans all ports once. Unlike autoDetectAll(), finding no camera is not an error.
+		 * \return the cameras found, sorted by model then port
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		static std::vector<DetectedCamera> scan();
+		
+		/**
+		 * \brief Compares two scans
+		 * \param[in]	previous	scan, sorted
+		 * \param[in]	current	scan, sorted
+		 * \param[out]	arrived	the cameras only in the current scan
+		 * \param[out]	departed	the cameras only in the previous scan
+		 * \return true if anything changed
+		 */
+		static bool diff(std::vector<DetectedCamera> const & previous, std::vector<DetectedCamera> const & current, std::vector<DetectedCamera>& arrived, std::vector<DetectedCamera>& departed);
+		
+	private:
+		void notify(CameraMonitorEvent event, DetectedCamera const & camera);
+		
+		void run();
+		
+		std::chrono::milliseconds m_minInterval;
+		std::chrono::milliseconds m_maxInterval;
+		std::chrono::milliseconds m_currentInterval;
+		
+		std::atomic<bool> m_running;
+		bool m_stopRequested;
+		std::thread m_thread;
+		
+		mutable std::mutex m_mutex;
+		std::condition_variable m_stopCondition;
+		
+		std::vector<DetectedCamera> m_cameras;
+		
+		observer::SubjectEvent<CameraMonitorEvent, void(DetectedCamera const &)> m_events;
+	};
+}
+
+#endif // CAMERAMONITOR_HPP
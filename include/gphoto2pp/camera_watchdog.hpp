@@ -0,0 +1,178 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#ifndef CAMERAWATCHDOG_HPP
+#define CAMERAWATCHDOG_HPP
+
+#include <gphoto2pp/observer.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gphoto2pp
+{
+	class ContextCancellation;
+	
+	/**
+	 * \struct CameraHungEvent
+	 * A camera call which is still running past its deadline
+	 */
+	struct CameraHungEvent
+	{
+		std::string Camera;						///< Model and port of the camera
+		std::string Operation;					///< The gphoto2 method called, eg. "gp_camera_file_get"
+		std::chrono::milliseconds Elapsed;		///< Since the call started, including the wait for the camera's lock
+		std::chrono::milliseconds Allowed;		///< Time the call had until its deadline
+		bool HoldsCamera;						///< false if the call was still waiting for the camera's lock, it isn't cancelled then
+	};
+	
+	/**
+	 * \class CameraWatchdog
+	 * Watches the calls in flight on any number of cameras, from its own thread.
+	 * 
+	 * A call still running past its deadline is cancelled on every check until it returns, and reported once through the CameraHung event. The cancellation is cooperative, a driver which never polls its context stays blocked, the event lets a supervisor recycle that camera.
+	 * 
+	 * Only a call which holds the camera (see Call::locked()) is cancelled, and only while its context is still tagged with it, so a healthy call which took over the camera is never aborted. A call which ran out of time while waiting for the camera's lock is only reported.
+	 * 
+	 * Use CameraWrapper::setWatchdog(...) to have a camera's calls watched. One watchdog can be shared by all cameras.
+	 */
+	class CameraWatchdog
+	{
+	public:
+		/**
+		 * \class Call
+		 * Registration of one call in flight, the call ends when it is destroyed
+		 */
+		class Call
+		{
+		public:
+			Call();
+			Call(CameraWatchdog* watchdog, std::uint64_t id);
+			~Call();
+			
+			Call(Call&& other);
+			Call& operator=(Call&& other);
+			
+			Call(Call const & other) = delete;
+			Call& operator=(Call const & other) = delete;
+			
+			/**
+			 * \brief Marks the call as holding the camera, from then on it can be cancelled once hung
+			 */
+			void locked() const;
+			
+		private:
+			CameraWatchdog* m_watchdog;
+			std::uint64_t m_id;
+		};
+		
+		/**
+		 * \brief Starts the watchdog thread
+		 * \param[in]	checkInterval	between two checks of the calls in flight, a hung call is found within this delay after its deadline
+		 */
+		explicit CameraWatchdog(std::chrono::milliseconds checkInterval = std::chrono::milliseconds(100));
+		
+		/**
+		 * \brief Stops the watchdog thread. All cameras using it must be destroyed (or stop using it) first.
+		 */
+		~CameraWatchdog();
+		
+		CameraWatchdog(CameraWatchdog const & other) = delete;
+		CameraWatchdog& operator=(CameraWatchdog const & other) = delete;
+		
+		/**
+		 * \brief Registers a call starting now
+		 * \param[in]	camera	name of the camera, for the event. It is shared, so a camera builds it once for all its calls
+		 * \param[in]	operation	name of the call, for the event
+		 * \param[in]	deadline	after which the call counts as hung
+		 * \param[in]	cancellation	of the camera's context, the call is cancelled through it once hung and holding the camera (can be null)
+		 * \return the registration, which must be destroyed when the call returns
+		 */
+		Call begin(std::shared_ptr<std::string const> camera, char const * operation, std::chrono::steady_clock::time_point deadline, ContextCancellation* cancellation);
+		
+		/**
+		 * \brief Same as begin(...) with a shared name, for a name only used by this call
+		 * \param[in]	camera	name of the camera, for the event
+		 * \param[in]	operation	name of the call, for the event
+		 * \param[in]	deadline	after which the call counts as hung
+		 * \param[in]	cancellation	of the camera's context (can be null)
+		 * \return the registration, which must be destroyed when the call returns
+		 */
+		Call begin(std::string camera, char const * operation, std::chrono::steady_clock::time_point deadline, ContextCancellation* cancellation);
+		
+		/**
+		 * \brief Subscribes to hung calls. The callback runs on the watchdog thread, an exception it throws is logged and the remaining subscribers miss that call.
+		 * \param[in]	func	callback
+		 * \return the registration, the subscription ends when it is destroyed
+		 */
+		observer::Registration subscribeToCameraHung(std::function<void(const CameraHungEvent&)> func);
+		
+		/**
+		 * \brief Counts the calls in flight
+		 * \return the number of calls registered and not yet ended
+		 */
+		std::size_t getInFlightCount() const;
+		
+	private:
+		struct InFlightCall
+		{
+			std::shared_ptr<std::string const> Camera;
+			char const * Operation;
+			std::chrono::steady_clock::time_point Start;
+			std::chrono::steady_clock::time_point Deadline;
+			ContextCancellation* Cancellation;
+			bool HoldsCamera;
+			bool Reported;
+		};
+		
+		void locked(std::uint64_t id);
+		void end(std::uint64_t id);
+		void run();
+		
+		std::chrono::milliseconds m_checkInterval;
+		
+		mutable std::mutex m_mutex;
+		std::condition_variable m_stopCondition;
+		bool m_stopRequested;
+		
+		std::map<std::uint64_t, InFlightCall> m_calls;
+		std::uint64_t m_nextId;
+		
+		observer::Subject<void(const CameraHungEvent&)> m_cameraHungEvents;
+		
+		std::thread m_thread;
+	};
+}
+
+#endif // CAMERAWATCHDOG_HPP
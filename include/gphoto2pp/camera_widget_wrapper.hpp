@@ -25,6 +25,8 @@
 #ifndef CAMERAWIDGETWRAPPER_HPP
 #define CAMERAWIDGETWRAPPER_HPP
 
+#include <gphoto2pp/widget_view.hpp>
+
 #include <string>
 
 namespace gphoto2
@@ -62,6 +64,8 @@ namespace gphoto2pp
 	 */
 	class CameraWidgetWrapper
 	{
+	friend class WidgetView;
+	
 	public:
 		virtual ~CameraWidgetWrapper();
 		
@@ -138,6 +142,30 @@ namespace gphoto2pp
 		 */
 		CameraWidgetWrapper getParent() const;
 		
+		/**
+		 * \brief Gets a non-owning view of this widget.
+		 * Reading and traversing through the view costs no reference counting, but the view must not outlive this widget (or the tree's other owners).
+		 * \return the widget's view
+		 */
+		WidgetView getView() const;
+		
+		/**
+		 * \brief Checks if the camera allows the widget to be changed
+		 * \return true if the widget is read only
+		 * \note Direct wrapper for gp_widget_get_readonly(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		bool isReadOnly() const;
+		
+		/**
+		 * \brief Sets or clears the widget's changed flag.
+		 * Only widgets flagged as changed are written to the camera by the next CameraWrapper::setConfig(...). Setting a value flags the widget automatically, so this is mostly useful to exclude a widget from the next write.
+		 * \param[in]	changed	true if the widget should be written, false if it should be skipped
+		 * \note Direct wrapper for gp_widget_set_changed(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		void setChanged(bool changed);
+		
 	protected:
 		CameraWidgetWrapper(gphoto2::_CameraWidget* cameraWidget);
 		
@@ -26,12 +26,18 @@
 #define CAMERA_HPP
 
 #include <gphoto2pp/observer.hpp>
+#include <gphoto2pp/cancellation_token.hpp>
+#include <gphoto2pp/camera_watchdog.hpp>
+#include <gphoto2pp/latency_histogram.hpp>
+#include <gphoto2pp/camera_event_type_wrapper.hpp>
 
 #include <string>
 #include <iosfwd>
+#include <chrono>
 #include <future>
 #include <mutex>
 #include <memory>
+#include <vector>
 
 namespace gphoto2
 {
@@ -42,16 +48,25 @@ namespace gphoto2
 namespace gphoto2pp
 {
 	//Forward Declarations
-	enum class CameraEventTypeWrapper : int;
 	enum class CameraFileTypeWrapper : int;
 	enum class CameraCaptureTypeWrapper : int;
+	enum class ProgressEventType : int;
 	
 	struct CameraFilePathWrapper;
+	struct PropertyChangedEvent;
+	struct ProgressEvent;
+	struct ConfigSnapshotEntry;
 	
+	class CameraEvent;
+	class CameraMetrics;
 	class CameraFileWrapper;
 	class CameraWidgetWrapper;
 	class WindowWidget;
 	class CameraListWrapper;
+	class ConfigSnapshot;
+	class ConfigCache;
+	class ContextProgress;
+	class ContextCancellation;
 	
 	class CameraWrapper
 	{
@@ -100,20 +115,22 @@ namespace gphoto2pp
 		/**
 		 * \brief Captures a preview image from the camera.
 		 * This capture type might not be supported by all cameras (requires a live view/mirror lockup mode for continuous captures). The image does not persist on the camera.
+		 * \param[in]	cancellationToken	aborts the operation when cancelled
 		 * \return the image captured
 		 * \note Direct wrapper for <tt>gp_camera_capture_preview(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
-		CameraFileWrapper capturePreview();
+		CameraFileWrapper capturePreview(CancellationToken const & cancellationToken = CancellationToken::none());
 		
 		/**
 		 * \brief Captures a file from the camera.
 		 * \param[in]	captureType	of file to retrieve from the camera
+		 * \param[in]	cancellationToken	aborts the operation when cancelled
 		 * \return the file path
 		 * \note Direct wrapper for <tt>gp_camera_capture(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
-		CameraFilePathWrapper capture(CameraCaptureTypeWrapper const & captureType);
+		CameraFilePathWrapper capture(CameraCaptureTypeWrapper const & captureType, CancellationToken const & cancellationToken = CancellationToken::none());
 		
 		/**
 		 * \brief Triggers the camera to take a picture (similar to a remote shutter release).
@@ -136,29 +153,71 @@ namespace gphoto2pp
 		 * It's important to note, that if camera settings change (manually by physical interaction), and then you call this method with the old settings, it will change the camera back to the old settings. It's best practice to query the camera, change the settings, and then immediately set the config again.
 		 * \param[in]	cameraWidget	to traverse and write all settings to the camera
 		 * \return the Root widget (which will always be of type Window Widget)
-		 * \note Direct wrapper for <tt>gp_camera_set_config(...)</tt>
+		 * \note Direct wrapper for <tt>gp_camera_set_config(...)</tt>. The changed widgets aren't known, so the whole config cache is invalidated.
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
 		void setConfig(CameraWidgetWrapper const & cameraWidget);
 		
+		/**
+		 * \brief Sets the widgets to the provided settings, only invalidating the cached values of the widgets named.
+		 * Widgets the driver changes as a side effect of the write are invalidated by the camera's events, so without startListeningForEvents() the whole config cache is invalidated instead.
+		 * \param[in]	cameraWidget	to traverse and write all settings to the camera
+		 * \param[in]	changedWidgetNames	every widget flagged as changed in the tree, one missing from the list keeps its old cached value
+		 * \note Direct wrapper for <tt>gp_camera_set_config(...)</tt>
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		void setConfig(CameraWidgetWrapper const & cameraWidget, std::vector<std::string> const & changedWidgetNames);
+		
+		/**
+		 * \brief Gets the camera's configuration from the config cache, reading it from the camera only when needed.
+		 * The cache is read again after any widget was changed through setConfig(...) or reported changed by the camera (which requires startListeningForEvents()), or once it is older than the max age.
+		 * Serving from the cache doesn't wait for the camera, so it can be called while a capture is in progress.
+		 * \return the snapshot of the configuration, which is never modified
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		std::shared_ptr<ConfigSnapshot const> getCachedConfig() const;
+		
+		/**
+		 * \brief Gets one widget's value from the config cache, reading the configuration from the camera only when this widget is stale.
+		 * \param[in]	name	of the widget (eg. "iso")
+		 * \return the widget's saved state
+		 * \throw GPhoto2pp::exceptions::CameraWrapperException if the camera has no value widget with this name
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		ConfigSnapshotEntry getCachedValue(std::string const & name) const;
+		
+		/**
+		 * \brief Sets how long the config cache is served before the configuration is read again.
+		 * Without events, changes made on the camera itself (eg. turning a dial) are only seen once the cache expires.
+		 * \param[in]	maxAge	the maximum age, zero (the default) means the cache only refreshes when invalidated
+		 */
+		void setConfigCacheMaxAge(std::chrono::milliseconds maxAge);
+		
+		/**
+		 * \brief Forces the next cached read to read the configuration from the camera
+		 */
+		void invalidateConfigCache();
+		
 		//Filesystem Operations
 		/**
 		 * \brief Lists all files in the provided folder
 		 * \param[in]	folder	to list all files in
+		 * \param[in]	cancellationToken	aborts the operation when cancelled
 		 * \return the list of files
 		 * \note Direct wrapper for <tt>gp_camera_folder_list_files(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
-		CameraListWrapper folderListFiles(std::string const & folder) const;
+		CameraListWrapper folderListFiles(std::string const & folder, CancellationToken const & cancellationToken = CancellationToken::none()) const;
 		
 		/**
 		 * \brief Lists all folders in the provided folder
 		 * \param[in]	folder	to list all folders in
+		 * \param[in]	cancellationToken	aborts the operation when cancelled
 		 * \return the list of folders
 		 * \note Direct wrapper for <tt>gp_camera_folder_list_folders(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
-		CameraListWrapper folderListFolders(std::string const & folder) const;
+		CameraListWrapper folderListFolders(std::string const & folder, CancellationToken const & cancellationToken = CancellationToken::none()) const;
 		
 		/**
 		 * \brief Delete all files in the provided folder
@@ -174,10 +233,11 @@ namespace gphoto2pp
 		 * \param[in]	fileName	for the new file to be written
 		 * \param[in]	fileType	for the new file to be written
 		 * \param[in]	cameraFile	contains the new file to be written to the folder
+		 * \param[in]	cancellationToken	aborts the operation when cancelled
 		 * \note Direct wrapper for <tt>gp_camera_folder_put_file(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
-		void folderPutFile(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType, CameraFileWrapper cameraFile);
+		void folderPutFile(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType, CameraFileWrapper cameraFile, CancellationToken const & cancellationToken = CancellationToken::none());
 		
 		/**
 		 * \brief Make a new folder in the provided directory
@@ -202,11 +262,12 @@ namespace gphoto2pp
 		 * \param[in]	folder	containing the file to get
 		 * \param[in]	fileName	of the file to retrieve
 		 * \param[in]	fileType	of the file to retrieve
+		 * \param[in]	cancellationToken	aborts the operation when cancelled
 		 * \return the file
 		 * \note Direct wrapper for <tt>gp_camera_file_get(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
-		CameraFileWrapper fileGet(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType) const;
+		CameraFileWrapper fileGet(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType, CancellationToken const & cancellationToken = CancellationToken::none()) const;
 		
 		/**
 		 * \brief Delete a file from the camera
@@ -217,6 +278,20 @@ namespace gphoto2pp
 		 */
 		void fileDelete(std::string const & folder, std::string const & fileName) const;
 		
+		/**
+		 * \brief Waits for the next event from the camera, on the calling thread.
+		 * Use this when a sequence needs to react to its own events (eg. the file added by a triggerCapture()). It can't be used while listening for events, since the listener would consume them.
+		 * \param[in]	timeout	in milliseconds to wait for an event
+		 * \param[out]	cameraFilePath	receives the file or folder of FileAdded and FolderAdded events
+		 * \param[out]	eventText	receives the data of Unknown events
+		 * \param[in]	cancellationToken	aborts the wait when cancelled, its deadline also shortens the timeout
+		 * \return the event type, Timeout if nothing happened
+		 * \note Direct wrapper for <tt>gp_camera_wait_for_event(...)</tt>
+		 * \throw GPhoto2pp::exceptions::CameraWrapperException if startListeningForEvents() is running
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		CameraEventTypeWrapper waitForEvent(int timeout, CameraFilePathWrapper& cameraFilePath, std::string& eventText, CancellationToken const & cancellationToken = CancellationToken::none());
+		
 		/**
 		 * \brief Helper method used to subscribe to Camera Wait For events.
 		 * This method should be used to setup all the callbacks necessary before calling startListeningForEvents.
@@ -234,6 +309,32 @@ namespace gphoto2pp
 		 */
 		observer::Registration subscribeToCameraEvent(CameraEventTypeWrapper const & event, std::function<void(const CameraFilePathWrapper&, const std::string&)> func);
 		
+		/**
+		 * \brief Subscribes to a camera event type, receiving the event with its typed payload.
+		 * Unlike subscribeToCameraEvent(...) nothing is allocated for the callback, the path or text lives in the CameraEvent and is only copied if the callback asks for it with CameraEvent::toFilePath() or CameraEvent::toText().
+		 * \param[in]	event	type to subscribe to
+		 * \param[in]	func	callback which will be called each time the event type is triggered, the event is only valid during the call
+		 * \note Requires startListeningForEvents()
+		 */
+		observer::Registration subscribeToTypedCameraEvent(CameraEventTypeWrapper const & event, std::function<void(const CameraEvent&)> func);
+		
+		/**
+		 * \brief Subscribes to the camera's property changes.
+		 * PTP cameras report a changed property as an Unknown event with a text like "PTP Property 500f changed". These are parsed while listening for events and also passed to this callback, so only the changed widget needs to be read again. The Unknown event is still fired with the raw text.
+		 * \param[in]	func	callback which will be called each time a property changes
+		 * \note Requires startListeningForEvents()
+		 */
+		observer::Registration subscribeToPropertyChanged(std::function<void(const PropertyChangedEvent&)> func);
+		
+		/**
+		 * \brief Subscribes to the progress of this camera's long operations, such as fileGet(...) or folderPutFile(...).
+		 * The events carry the units done (bytes for transfers), the throughput and the elapsed time, and are raised on the thread doing the operation.
+		 * \param[in]	event	stage of the operations to subscribe to
+		 * \param[in]	func	callback
+		 * \note Wired through <tt>gp_context_set_progress_funcs(...)</tt> on this camera's context
+		 */
+		observer::Registration subscribeToProgress(ProgressEventType const & event, std::function<void(const ProgressEvent&)> func);
+		
 		/**
 		 * \brief Starts monitoring the camera events
 		 * You must subscribe to at least one event type and then perform some action on the camera to see this in action.
@@ -243,10 +344,37 @@ namespace gphoto2pp
 		
 		/**
 		 * \brief Signals the thread to stop listening.
-		 * If there is no thread, it leaves the method immediately, if there is a thread running, it is a blocking call which will not return until the thread exits.
+		 * If there is no thread, it leaves the method immediately, if there is a thread running, it is a blocking call which will not return until the thread exits. The wait for an event in progress is cancelled.
 		 */
 		void stopListeningForEvents();
 		
+		/**
+		 * \brief Cancels the operation currently running on this camera (from another thread), whatever its token. Operations started afterwards aren't affected.
+		 * The camera driver stops at its next poll of the context, and the operation throws a gphoto2_exception with GP_ERROR_CANCEL.
+		 */
+		void cancelCurrentOperation();
+		
+		/**
+		 * \brief Has every call on this camera watched for hangs, call it before using the camera from several threads.
+		 * A call counts as hung once it runs past the operation deadline, or past the deadline of its cancellation token if that is earlier. The time spent waiting for another call on the same camera counts, but a call which runs out of time before it got the camera is only reported, the call holding the camera isn't cancelled for it.
+		 * \param[in]	watchdog	to report to, null to stop watching
+		 * \param[in]	operationDeadline	time allowed to any call
+		 */
+		void setWatchdog(std::shared_ptr<CameraWatchdog> watchdog, std::chrono::milliseconds operationDeadline = std::chrono::seconds(30));
+		
+		/**
+		 * \brief Gets the latencies of this camera's calls, such as "gp_camera_capture" or "gp_camera_file_get".
+		 * Every call is timed, the wait for another call on the camera to finish is recorded apart from the call itself.
+		 * \return the latencies, use OperationLatencies::snapshot() to read them
+		 */
+		OperationLatencies const & getLatencies() const;
+		
+		/**
+		 * \brief Gets this camera's counters (captures, downloaded bytes, errors...), also rendered by MetricsRegistry::getShared()
+		 * \return the counters, which continue when the same camera is connected again
+		 */
+		std::shared_ptr<CameraMetrics const> getMetrics() const;
+		
 	private:
 		/**
 		 * \brief Initializes the camera by connecting to the first camera found.
@@ -260,6 +388,53 @@ namespace gphoto2pp
 		 */
 		void initialize(std::string const & model, std::string const & port);
 		
+		/**
+		 * \brief Writes the widget's tree to the camera, invalidating the whole config cache if it fails
+		 * \param[in]	cameraWidget	any widget of the tree
+		 */
+		void writeConfig(CameraWidgetWrapper const & cameraWidget);
+		
+		/**
+		 * \brief Reads the configuration from the camera and publishes it to the config cache
+		 * \return the new snapshot
+		 */
+		std::shared_ptr<ConfigSnapshot const> refreshConfigCache() const;
+		
+		/**
+		 * \brief Registers a call with the watchdog, if there is one
+		 * \param[in]	operation	name of the gphoto2 method
+		 * \param[in]	cancellationToken	of the call, its deadline applies if earlier than the operation deadline
+		 * \return the registration, to keep until the call returned
+		 */
+		CameraWatchdog::Call watchCall(char const * operation, CancellationToken const & cancellationToken) const;
+		
+		/**
+		 * \struct TimedIOLock
+		 * The camera's I/O lock, with the timer of the call holding it
+		 */
+		struct TimedIOLock
+		{
+			OperationLatencies::Timer Timer;
+			std::unique_lock<std::mutex> Lock;
+		};
+		
+		/**
+		 * \brief Locks the camera for a call, timing the wait and then the call
+		 * \param[in]	operation	name of the gphoto2 method, a string literal
+		 * \param[in]	watchedCall	registration of the call, from then on the watchdog may cancel it
+		 * \return the lock, to keep until the call returned
+		 */
+		TimedIOLock lockIO(char const * operation, CameraWatchdog::Call const & watchedCall) const;
+		
+		/**
+		 * \brief Same as checkResponse(...), also counting the error in the camera's metrics unless it is a cancellation
+		 * \param[in]	result	of the gphoto2 method
+		 * \param[in]	methodName	of the gphoto2 method
+		 * \return the result
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int checkCameraResponse(int result, char const * methodName) const;
+		
 		gphoto2::_Camera* m_camera = nullptr;
 		
 		std::shared_ptr<gphoto2::_GPContext> m_context;
@@ -268,11 +443,31 @@ namespace gphoto2pp
 		std::string m_port;
 		
 		observer::SubjectEvent<CameraEventTypeWrapper, void(const CameraFilePathWrapper&, const std::string&)> m_cameraEvents;
+		observer::SubjectEvent<CameraEventTypeWrapper, void(const CameraEvent&)> m_typedCameraEvents;
+		observer::Subject<void(const PropertyChangedEvent&)> m_propertyChangedEvents;
 		
 		std::atomic<bool> m_listenForEvents;
 		std::future<bool> m_listenForEventSignalFuture;
+		CancellationToken m_listenForEventsCancellation;
 		
 		mutable std::mutex m_cameraIOMutex;
+		
+		// Held by pointer so it keeps its address when the wrapper is moved
+		std::unique_ptr<ConfigCache> m_configCache;
+		
+		// Held by pointer since the context keeps its address
+		std::unique_ptr<ContextProgress> m_contextProgress;
+		std::unique_ptr<ContextCancellation> m_contextCancellation;
+		
+		std::shared_ptr<CameraWatchdog> m_watchdog;
+		std::shared_ptr<std::string const> m_watchdogLabel;	// Built once, so watched calls don't allocate it
+		std::chrono::milliseconds m_operationDeadline;
+		
+		// Held by pointer, as its histograms are atomics
+		std::unique_ptr<OperationLatencies> m_latencies;
+		
+		// Shared with MetricsRegistry::getShared()
+		std::shared_ptr<CameraMetrics> m_metrics;
 	};
 
 }
@@ -0,0 +1,100 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#ifndef CANCELLATIONTOKEN_HPP
+#define CANCELLATIONTOKEN_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace gphoto2pp
+{
+	/**
+	 * \class CancellationToken
+	 * Cancels camera operations from another thread, or once a deadline passes.
+	 * 
+	 * Copies share the same state, so keep one copy to call cancel() on and pass another to the operation. The operation is aborted cooperatively: the camera driver polls the context while it works, and then fails with GP_ERROR_CANCEL (thrown as a gphoto2_exception). A token already cancelled makes the operation fail before it starts.
+	 */
+	class CancellationToken
+	{
+	public:
+		/**
+		 * \brief Creates a token which is only cancelled by cancel()
+		 */
+		CancellationToken();
+		
+		/**
+		 * \brief Creates a token which is cancelled once the timeout elapsed (or by cancel())
+		 * \param[in]	timeout	from now
+		 * \return the token
+		 */
+		static CancellationToken withTimeout(std::chrono::milliseconds timeout);
+		
+		/**
+		 * \brief Gets the token which is never cancelled, the default of all operations
+		 * \return the token
+		 */
+		static CancellationToken const & none();
+		
+		/**
+		 * \brief Cancels every operation using this token (or a copy of it), now and later
+		 */
+		void cancel();
+		
+		/**
+		 * \brief Sets the time after which the token counts as cancelled
+		 * \param[in]	deadline	on the monotonic clock
+		 */
+		void setDeadline(std::chrono::steady_clock::time_point deadline);
+		
+		/**
+		 * \brief Gets the deadline
+		 * \return the deadline, or time_point::max() if there is none
+		 */
+		std::chrono::steady_clock::time_point getDeadline() const;
+		
+		/**
+		 * \brief Checks if cancel() was called or the deadline passed
+		 * \return true if operations should stop
+		 */
+		bool isCancelled() const;
+		
+	private:
+		struct State
+		{
+			std::atomic<bool> Cancelled;
+			std::atomic<std::chrono::steady_clock::rep> Deadline;	///< Ticks since the clock's epoch
+		};
+		
+		explicit CancellationToken(std::shared_ptr<State> state);
+		
+		// Null for none()
+		std::shared_ptr<State> m_state;
+	};
+}
+
+#endif // CANCELLATIONTOKEN_HPP
@@ -0,0 +1,102 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef CAPTUREPIPELINE_HPP
+#define CAPTUREPIPELINE_HPP
+
+#include <gphoto2pp/camera_file_path_wrapper.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace gphoto2pp
+{
+	class CameraWrapper;
+	class CameraFileWrapper;
+	
+	/**
+	 * \class CapturePipeline
+	 * Captures a sequence of images, downloading each image while the camera exposes the next one.
+	 * 
+	 * Every capture() triggers the camera, then downloads the image of the previous capture while the exposure runs, and finally waits for the camera to announce the new file. The last image is downloaded by flush() (or the destructor).
+	 * 
+	 * \note The pipeline expects one file per capture, so the camera shouldn't be set to save RAW+JPEG. It waits for its events itself, so the CameraWrapper must not be listening for events.
+	 */
+	class CapturePipeline
+	{
+	public:
+		/**
+		 * Called with each downloaded image
+		 */
+		using FileHandler = std::function<void(CameraFilePathWrapper const & cameraFilePath, CameraFileWrapper& cameraFile)>;
+		
+		/**
+		 * \brief Prepares a pipeline, nothing is sent to the camera yet
+		 * \param[in]	cameraWrapper	to capture with
+		 * \param[in]	fileHandler	called with every downloaded image, in capture order
+		 * \param[in]	deleteFromCamera	whether each image is deleted from the camera once downloaded
+		 * \param[in]	captureTimeout	how long to wait for the camera to save an image
+		 */
+		CapturePipeline(CameraWrapper& cameraWrapper, FileHandler fileHandler, bool deleteFromCamera = true, std::chrono::milliseconds captureTimeout = std::chrono::milliseconds(30000));
+		
+		/**
+		 * \brief Downloads the last pending image, errors are logged and suppressed
+		 */
+		~CapturePipeline();
+		
+		CapturePipeline(CapturePipeline const & other) = delete;
+		CapturePipeline& operator=(CapturePipeline const & other) = delete;
+		
+		/**
+		 * \brief Captures an image and downloads the previous one during the exposure.
+		 * \return the path of the new image on the camera, which is downloaded by the next capture() or flush()
+		 * \note Uses <tt>gp_camera_trigger_capture(...)</tt> and <tt>gp_camera_wait_for_event(...)</tt>, or <tt>gp_camera_capture(...)</tt> before gphoto 2.5 (the exposure then can't overlap the download)
+		 * \throw GPhoto2pp::exceptions::CameraWrapperException if the camera didn't save an image within the timeout
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		CameraFilePathWrapper capture();
+		
+		/**
+		 * \brief Downloads the pending image, if any
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		void flush();
+		
+	private:
+		CameraFilePathWrapper waitForFileAdded();
+		
+		void download(CameraFilePathWrapper const & cameraFilePath);
+		
+		CameraWrapper& m_cameraWrapper;
+		FileHandler m_fileHandler;
+		bool m_deleteFromCamera;
+		std::chrono::milliseconds m_captureTimeout;
+		
+		bool m_hasPending;
+		CameraFilePathWrapper m_pending;
+	};
+}
+
+#endif // CAPTUREPIPELINE_HPP
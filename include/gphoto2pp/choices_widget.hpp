@@ -28,31 +28,40 @@
 #include <gphoto2pp/string_widget.hpp>
 
 #include <vector>
+#include <memory>
 
 namespace gphoto2pp
 {
+	namespace detail
+	{
+		struct ChoiceTable;
+	}
+	
 	/**
 	 * \class ChoicesWidget
 	 * A class representing gphoto2 widgets which are of the widget type GPhoto2pp::CameraWidgetTypeWrapper::Menu or GPhoto2pp::CameraWidgetTypeWrapper::Radio
+	 * 
+	 * The choices of a fetched widget never change, so they are read from gphoto2 once (on first use) into a table shared by all copies of this widget. Afterwards index and string lookups don't call back into gphoto2.
 	 */
 	class ChoicesWidget : public StringWidget
 	{
 	friend class NonValueWidget;
+	friend class WidgetView;
 
 	public:
 		/**
 		 * \brief Counts the number of choices/options to set for this widget
 		 * \return the number of choices
-		 * \note Direct wrapper for <tt>gp_widget_count_choices(...)</tt>
+		 * \note Cached result of <tt>gp_widget_count_choices(...)</tt>
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
 		int countChoices() const;
 		
 		/**
-		 * \brief Gets the currently set choice at the specified index
+		 * \brief Gets the index of the currently set choice
 		 * \return the choices index
-		 * \note Direct wrapper for <tt>gp_widget_get_choice(...)</tt>
-		 * \throw GPhoto2pp::exceptions::IndexOutOfRange if the index is greater than countChoices of choices
+		 * \note Looks up the value from <tt>gp_widget_get_value(...)</tt> in the cached choices
+		 * \throw GPhoto2pp::exceptions::ValueOutOfLimits if the current value is not one of the choices
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
 		int getChoice() const;
@@ -60,8 +69,8 @@ namespace gphoto2pp
 		/**
 		 * \brief Sets the choice at the specified index
 		 * \param[in]	index	of the choice to set
-		 * \note Helper which calls getChoice with the provided index and then setValue with the response
-		 * \throw GPhoto2pp::exceptions::IndexOutOfRange if the index is greater than countChoices
+		 * \note Helper which sets the cached choice string with <tt>gp_widget_set_value(...)</tt>
+		 * \throw GPhoto2pp::exceptions::IndexOutOfRange if the index is outside of the choices
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
 		void setChoice(int index);
@@ -69,7 +78,7 @@ namespace gphoto2pp
 		/**
 		 * \brief Gets all the possible choices
 		 * \return the choices
-		 * \note Helper which iterates through all choices compiling them into a vector
+		 * \note Helper which copies the cached choices into a vector
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
 		std::vector<std::string> getChoices() const;
@@ -78,12 +87,21 @@ namespace gphoto2pp
 		 * \brief Gets the string representation of the choice at the specified index
 		 * \param[in]	index	of the choice to get
 		 * \return the choices value
-		 * \note Direct wrapper for <tt>gp_widget_get_choice(...)</tt>
-		 * \throw GPhoto2pp::exceptions::IndexOutOfRange if the index is greater than countChoices of choices
+		 * \note Cached result of <tt>gp_widget_get_choice(...)</tt>
+		 * \throw GPhoto2pp::exceptions::IndexOutOfRange if the index is outside of the choices
 		 * \throw GPhoto2pp::exceptions::gphoto2_exception
 		 */
 		std::string choiceToString(int index) const;
 		
+		/**
+		 * \brief Gets the index of the choice matching the provided string
+		 * \param[in]	choice	string to search for
+		 * \return the choices index
+		 * \throw GPhoto2pp::exceptions::ValueOutOfLimits if the string is not one of the choices
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int stringToChoice(std::string const & choice) const;
+		
 		/**
 		 * \brief Formats the choices into a string with optional separator
 		 * \param[in]	separator	used to insert inbetween all the choices for concatenation
@@ -94,6 +112,15 @@ namespace gphoto2pp
 		
 	protected:
 		ChoicesWidget(gphoto2::_CameraWidget* cameraWidget);
+		
+	private:
+		/**
+		 * \brief Gets the choices table, building it on the first call. Several threads may read the same widget.
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		detail::ChoiceTable const & getChoiceTable() const;
+		
+		mutable std::shared_ptr<detail::ChoiceTable const> m_choiceTable;
 	};
 }
 
@@ -0,0 +1,121 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef CONFIGCACHE_HPP
+#define CONFIGCACHE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace gphoto2pp
+{
+	class ConfigSnapshot;
+	
+	/**
+	 * \class ConfigCache
+	 * Holds the last configuration read from a camera and tracks which widgets became stale since.
+	 * 
+	 * The cached snapshot is immutable and published through an atomic shared pointer, so readers never wait on the camera's I/O lock and keep a consistent snapshot even if it is replaced meanwhile. Invalidations copy the small state they change and swap it in, they don't block readers either.
+	 * 
+	 * Refreshing is a two step process: beginRefresh() is called before the configuration is read from the camera and publish(...) afterwards. Any widget invalidated between the two calls stays stale, because the read may have missed the change.
+	 */
+	class ConfigCache
+	{
+	public:
+		ConfigCache();
+		
+		ConfigCache(ConfigCache const & other) = delete;
+		ConfigCache& operator=(ConfigCache const & other) = delete;
+		
+		/**
+		 * \brief Gets the cached snapshot if every widget of it is still valid
+		 * \return the snapshot, or nullptr if there is none, it expired or any widget was invalidated
+		 */
+		std::shared_ptr<ConfigSnapshot const> getSnapshot() const;
+		
+		/**
+		 * \brief Gets the cached snapshot if the widget is still valid in it, other widgets might be stale
+		 * \param[in]	widgetName	name of the widget which will be read from the snapshot
+		 * \return the snapshot, or nullptr if there is none, it expired or the widget was invalidated
+		 */
+		std::shared_ptr<ConfigSnapshot const> getSnapshot(std::string const & widgetName) const;
+		
+		/**
+		 * \brief Must be called right before reading the configuration which will be published
+		 * \return the token to pass to publish(...)
+		 */
+		std::uint64_t beginRefresh() const;
+		
+		/**
+		 * \brief Replaces the cached snapshot.
+		 * Only the invalidations which happened before beginRefresh() are cleared.
+		 * \param[in]	snapshot	the configuration just read
+		 * \param[in]	refreshToken	returned by beginRefresh() before the configuration was read
+		 */
+		void publish(std::shared_ptr<ConfigSnapshot const> snapshot, std::uint64_t refreshToken);
+		
+		/**
+		 * \brief Marks every widget as stale
+		 */
+		void invalidate();
+		
+		/**
+		 * \brief Marks one widget as stale
+		 * \param[in]	widgetName	name of the widget which changed
+		 */
+		void invalidate(std::string const & widgetName);
+		
+		/**
+		 * \brief Sets how long a snapshot is served before it has to be read again
+		 * \param[in]	maxAge	the maximum age, zero (the default) means snapshots don't expire
+		 */
+		void setMaxAge(std::chrono::milliseconds maxAge);
+		
+		/**
+		 * \brief Gets how long a snapshot is served before it has to be read again
+		 * \return the maximum age, zero means snapshots don't expire
+		 */
+		std::chrono::milliseconds getMaxAge() const;
+		
+	private:
+		struct State;
+		
+		std::shared_ptr<State const> getFreshState() const;
+		
+		template<typename Modifier>
+		void modifyState(Modifier modifier);
+		
+		// Only accessed through the std::atomic_load/store/compare_exchange overloads for shared_ptr
+		std::shared_ptr<State const> m_state;
+		
+		mutable std::atomic<std::uint64_t> m_generation;
+		std::atomic<std::chrono::milliseconds::rep> m_maxAge;
+	};
+}
+
+#endif // CONFIGCACHE_HPP
@@ -0,0 +1,84 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef CONFIGDIFF_HPP
+#define CONFIGDIFF_HPP
+
+#include <gphoto2pp/config_snapshot.hpp>
+
+#include <string>
+#include <vector>
+
+namespace gphoto2pp
+{
+	class CameraWrapper;
+	
+	/**
+	 * Describes how a widget differs between two configurations
+	 */
+	enum class ConfigChangeKind : int
+	{
+		Modified = 0,		///< The widget has a different value
+		TypeChanged = 1,	///< The widget has a different type, so the values can't be compared
+		Added = 2,			///< The widget only exists in the second configuration
+		Removed = 3,		///< The widget only exists in the first configuration
+	};
+	
+	/**
+	 * \struct ConfigChange
+	 * One widget which differs between two configurations.
+	 * Old is left default constructed for Added widgets and New for Removed widgets. For Radio and Menu widgets the entries also hold the choice indices of the values.
+	 */
+	struct ConfigChange
+	{
+		ConfigChangeKind Kind;
+		std::string Path;					///< Full name of the widget, eg. "/main/imgsettings/iso"
+		ConfigSnapshotEntry Old;			///< The widget in the first configuration
+		ConfigSnapshotEntry New;			///< The widget in the second configuration
+	};
+	
+	/**
+	 * \brief Compares two snapshots.
+	 * Both snapshots are walked once side by side. As long as they list the widgets in the same order (which is the case for two snapshots of the same camera model) no lookup is needed, otherwise the remaining widgets are matched by their full name.
+	 * \param[in]	from	the reference configuration, eg. the approved profile
+	 * \param[in]	to	the configuration to check
+	 * \param[in]	includeReadOnly	whether read only widgets (battery level, serial number, etc...) should be compared too
+	 * \return the changes, in the order of the widgets in from followed by the added widgets
+	 */
+	std::vector<ConfigChange> diffConfig(ConfigSnapshot const & from, ConfigSnapshot const & to, bool includeReadOnly = false);
+	
+	/**
+	 * \brief Compares a snapshot to the current configuration of the camera.
+	 * \param[in]	from	the reference configuration, eg. the approved profile
+	 * \param[in]	cameraWrapper	to read the current configuration from
+	 * \param[in]	includeReadOnly	whether read only widgets (battery level, serial number, etc...) should be compared too
+	 * \return the changes
+	 * \note Helper which fetches the configuration once with CameraWrapper::getConfig()
+	 * \throw GPhoto2pp::exceptions::gphoto2_exception
+	 */
+	std::vector<ConfigChange> diffConfig(ConfigSnapshot const & from, CameraWrapper& cameraWrapper, bool includeReadOnly = false);
+}
+
+#endif // CONFIGDIFF_HPP
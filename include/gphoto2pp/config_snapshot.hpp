@@ -0,0 +1,141 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef CONFIGSNAPSHOT_HPP
+#define CONFIGSNAPSHOT_HPP
+
+#include <gphoto2pp/camera_widget_type_wrapper.hpp>
+
+#include <string>
+#include <vector>
+
+namespace gphoto2pp
+{
+	class CameraWrapper;
+	class NonValueWidget;
+	
+	/**
+	 * \struct ConfigSnapshotEntry
+	 * The saved state of one value widget (Text, Range, Toggle, Radio, Menu or Date).
+	 * Only the value member(s) matching the Type are meaningful.
+	 */
+	struct ConfigSnapshotEntry
+	{
+		std::string Path;					///< Full name of the widget, eg. "/main/imgsettings/iso"
+		std::string Name;					///< Name of the widget, eg. "iso"
+		CameraWidgetTypeWrapper Type;
+		bool ReadOnly;
+		std::string StringValue;			///< Value of Text, Radio and Menu widgets
+		float FloatValue;					///< Value of Range widgets
+		int IntValue;						///< Value of Toggle and Date widgets
+		int ChoiceIndex;					///< Index of the StringValue in the choices of Radio and Menu widgets, -1 if it isn't one of them
+	};
+	
+	/**
+	 * \class ConfigSnapshot
+	 * A copy of every value widget of a configuration tree, which doesn't depend on the tree or the camera anymore.
+	 * 
+	 * Snapshots can be saved and loaded as a compact binary blob or as JSON, which makes them suitable for shooting profiles. Restoring a snapshot writes every differing widget to the camera in a single <tt>gp_camera_set_config(...)</tt> call.
+	 */
+	class ConfigSnapshot
+	{
+	public:
+		ConfigSnapshot();
+		
+		/**
+		 * \brief Copies every value widget below (and including) the widget.
+		 * \param[in]	rootWidget	of the tree to copy, usually the WindowWidget from CameraWrapper::getConfig()
+		 * \return the snapshot
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		static ConfigSnapshot capture(NonValueWidget const & rootWidget);
+		
+		/**
+		 * \brief Fetches the camera's configuration and copies every value widget.
+		 * \param[in]	cameraWrapper	to read the configuration from
+		 * \return the snapshot
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		static ConfigSnapshot capture(CameraWrapper& cameraWrapper);
+		
+		/**
+		 * \brief Gets the saved widgets, in the order of the configuration tree
+		 * \return the entries
+		 */
+		std::vector<ConfigSnapshotEntry> const & getEntries() const;
+		
+		/**
+		 * \brief Finds a saved widget by its name (eg. "iso") or full name (eg. "/main/imgsettings/iso")
+		 * \param[in]	name	of the widget
+		 * \return the entry, or nullptr if the snapshot doesn't contain the widget
+		 */
+		ConfigSnapshotEntry const * find(std::string const & name) const;
+		
+		/**
+		 * \brief Serializes the snapshot into its compact binary form.
+		 * Numbers are stored little endian, so the blob can be moved between machines.
+		 * \return the binary blob
+		 */
+		std::string toBinary() const;
+		
+		/**
+		 * \brief Deserializes a snapshot created by toBinary()
+		 * \param[in]	data	the binary blob
+		 * \return the snapshot
+		 * \throw GPhoto2pp::exceptions::ArgumentException if the data isn't a valid snapshot
+		 */
+		static ConfigSnapshot fromBinary(std::string const & data);
+		
+		/**
+		 * \brief Serializes the snapshot into JSON, which is easier to read and edit by hand
+		 * \return the JSON document
+		 * \note JSON has no literal for them, so range values which aren't finite are written as the strings "NaN", "Infinity" and "-Infinity"
+		 */
+		std::string toJson() const;
+		
+		/**
+		 * \brief Deserializes a snapshot created by toJson()
+		 * \param[in]	json	the JSON document
+		 * \return the snapshot
+		 * \throw GPhoto2pp::exceptions::ArgumentException if the document isn't a valid snapshot
+		 */
+		static ConfigSnapshot fromJson(std::string const & json);
+		
+		/**
+		 * \brief Applies the snapshot to the camera.
+		 * The configuration is fetched once and every saved widget which still exists, is writable, has the same type and a different value is changed. They are then written in a single call. Widgets which already match are not sent to the camera, and if all of them match the camera is not written to at all. A path saved more than once is restored to its widgets in order, like diffConfig(...) matches them.
+		 * \param[in]	cameraWrapper	to write the snapshot to
+		 * \return the number of widgets written
+		 * \note Helper which uses a ConfigTransaction
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int restoreTo(CameraWrapper& cameraWrapper) const;
+		
+	private:
+		std::vector<ConfigSnapshotEntry> m_entries;
+	};
+}
+
+#endif // CONFIGSNAPSHOT_HPP
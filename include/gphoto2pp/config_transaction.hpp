@@ -0,0 +1,146 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef CONFIGTRANSACTION_HPP
+#define CONFIGTRANSACTION_HPP
+
+#include <gphoto2pp/window_widget.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace gphoto2pp
+{
+	class CameraWrapper;
+	
+	/**
+	 * \class ConfigTransaction
+	 * Groups several widget changes into a single write to the camera.
+	 * 
+	 * The transaction fetches the configuration once when it is created. Every widget that is staged remembers the value it had in that fetched tree, and on commit only the widgets whose value really differs are left flagged as changed. All of them are then written with one <tt>gp_camera_set_config(...)</tt> call, and if nothing differs the camera is not contacted at all.
+	 * 
+	 * \note Widgets changed directly through getRootWidget() (and not staged) are still written as is, by the same commit().
+	 */
+	class ConfigTransaction
+	{
+	public:
+		/**
+		 * \brief Fetches the camera's configuration, which becomes the snapshot that staged values are compared against.
+		 * \param[in]	cameraWrapper	to read the configuration from and commit the changes to
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		ConfigTransaction(CameraWrapper& cameraWrapper);
+		
+		// Staged widgets belong to the one tree fetched by this transaction, so it is neither copyable nor assignable
+		ConfigTransaction(ConfigTransaction const & other) = delete;
+		ConfigTransaction& operator=(ConfigTransaction const & other) = delete;
+		
+		/**
+		 * \brief Gets the root of the configuration tree fetched when the transaction was created.
+		 * \return the Root widget
+		 */
+		WindowWidget const & getRootWidget() const;
+		
+		/**
+		 * \brief Finds the widget by name and stages a new value for it.
+		 * \tparam TWidget the widget type to retrieve (eg. RadioWidget, ToggleWidget, etc...)
+		 * \param[in]	name	of the widget to change
+		 * \param[in]	value	to set the widget to
+		 * \throw GPhoto2pp::exceptions::InvalidWidgetType if the widget is not of type TWidget
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		template<typename TWidget, typename TValue>
+		void setValue(std::string const & name, TValue const & value)
+		{
+			stage(m_rootWidget.getChildByName<TWidget>(name), value);
+		}
+		
+		/**
+		 * \brief Stages a new value for a widget retrieved from getRootWidget().
+		 * The first time a widget is staged its current value is remembered, staging it again only changes the new value.
+		 * \param[in]	widget	to change, it must belong to the tree from getRootWidget()
+		 * \param[in]	value	to set the widget to
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		template<typename TWidget, typename TValue>
+		void stage(TWidget widget, TValue const & value)
+		{
+			if(!isStaged(widget))
+			{
+				auto original = widget.getValue();
+				
+				PendingWidget pending{
+					widget,
+					[widget, original]() { return widget.getValue() != original; },
+					[widget, original]() mutable { widget.setValue(original); }
+				};
+				
+				m_pending.push_back(std::move(pending));
+			}
+			
+			widget.setValue(value);
+		}
+		
+		/**
+		 * \brief Counts the staged widgets whose value differs from the fetched snapshot.
+		 * \return the number of widgets the next commit() would write
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int countChanged() const;
+		
+		/**
+		 * \brief Writes every staged widget that differs from the snapshot in a single call.
+		 * Staged widgets that ended up with their original value are cleared so the driver skips them. Widgets changed directly through getRootWidget() are written too. When no widget in the tree is left flagged as changed the camera is not written to.
+		 * \return the number of widgets actually written, staged or not
+		 * \note Helper which calls CameraWrapper::setConfig(...) at most once
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int commit();
+		
+		/**
+		 * \brief Puts every staged widget back to its original value and forgets them, nothing is written to the camera.
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		void rollback();
+		
+	private:
+		struct PendingWidget
+		{
+			CameraWidgetWrapper Widget;
+			std::function<bool()> IsChanged;
+			std::function<void()> Restore;
+		};
+		
+		bool isStaged(CameraWidgetWrapper const & widget) const;
+		
+		CameraWrapper& m_cameraWrapper;
+		WindowWidget m_rootWidget;
+		
+		std::vector<PendingWidget> m_pending;
+	};
+}
+
+#endif // CONFIGTRANSACTION_HPP
@@ -0,0 +1,131 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#ifndef CONTEXTCANCELLATION_HPP
+#define CONTEXTCANCELLATION_HPP
+
+#include <gphoto2pp/cancellation_token.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace gphoto2
+{
+	struct _GPContext;
+}
+
+namespace gphoto2pp
+{
+	/**
+	 * \class ContextCancellation
+	 * Answers the cancel polls of a GPContext (<tt>gp_context_set_cancel_func(...)</tt>) with the token of the operation currently using the context.
+	 */
+	class ContextCancellation
+	{
+	public:
+		/**
+		 * \class Scope
+		 * Makes a token the one of the current operation, until it goes out of scope.
+		 */
+		class Scope
+		{
+		public:
+			/**
+			 * \param[in]	cancellation	of the context the operation uses
+			 * \param[in]	token	of the operation
+			 * \throw GPhoto2pp::exceptions::gphoto2_exception with GP_ERROR_CANCEL if the token is already cancelled
+			 */
+			Scope(ContextCancellation& cancellation, CancellationToken const & token);
+			~Scope();
+			
+			Scope(Scope const & other) = delete;
+			Scope& operator=(Scope const & other) = delete;
+			
+		private:
+			ContextCancellation& m_cancellation;
+			CancellationToken m_previous;
+		};
+		
+		ContextCancellation();
+		
+		/**
+		 * \brief Detaches from the context
+		 */
+		~ContextCancellation();
+		
+		ContextCancellation(ContextCancellation const & other) = delete;
+		ContextCancellation& operator=(ContextCancellation const & other) = delete;
+		
+		/**
+		 * \brief Installs the cancel callback on the context, replacing any other
+		 * \param[in]	context	to answer the polls of, this object must not move while attached
+		 * \note Wrapper for <tt>gp_context_set_cancel_func(...)</tt>
+		 */
+		void attach(std::shared_ptr<gphoto2::_GPContext> const & context);
+		
+		/**
+		 * \brief Cancels the operation currently running, whatever its token. The next operation isn't affected.
+		 */
+		void cancelCurrent();
+		
+		/**
+		 * \brief Tags the context with the call which now holds the camera, so only that call can be cancelled by id
+		 * \param[in]	callId	of the call, as registered with the CameraWatchdog
+		 */
+		void beginCall(std::uint64_t callId);
+		
+		/**
+		 * \brief Removes the tag of a call which returned, unless another call already replaced it
+		 * \param[in]	callId	of the call
+		 */
+		void endCall(std::uint64_t callId);
+		
+		/**
+		 * \brief Cancels the operation currently running, only if it belongs to the given call
+		 * \param[in]	callId	of the call to cancel
+		 * \return true if the call was still running and got cancelled
+		 */
+		bool cancelCall(std::uint64_t callId);
+		
+		/**
+		 * \brief Checks if the current operation should stop, called by the context
+		 * \return true if its token was cancelled or cancelCurrent() was called
+		 */
+		bool isCancelled() const;
+		
+	private:
+		std::weak_ptr<gphoto2::_GPContext> m_context;
+		
+		mutable std::mutex m_mutex;
+		CancellationToken m_current;
+		std::uint64_t m_currentCall;
+		std::atomic<bool> m_cancelCurrent;
+	};
+}
+
+#endif // CONTEXTCANCELLATION_HPP
@@ -0,0 +1,154 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#ifndef CONTEXTPROGRESS_HPP
+#define CONTEXTPROGRESS_HPP
+
+#include <gphoto2pp/observer.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace gphoto2
+{
+	struct _GPContext;
+}
+
+namespace gphoto2pp
+{
+	/**
+	 * \enum ProgressEventType
+	 * The stages of an operation reporting its progress
+	 */
+	enum class ProgressEventType : int
+	{
+		Started,
+		Updated,
+		Stopped
+	};
+	
+	namespace observer
+	{
+		template <>
+		struct DenseEventTraits<ProgressEventType>
+		{
+			static const std::size_t Count = 3;
+		};
+	}
+	
+	/**
+	 * \struct ProgressEvent
+	 * The progress of one operation, as reported by libgphoto2. The unit depends on the operation, it is bytes for file downloads and uploads.
+	 */
+	struct ProgressEvent
+	{
+		unsigned int Id;						///< Identifies the operation, the same for all its events
+		std::string Text;						///< What the driver said it is doing
+		float Target;							///< Units to do in total
+		float Current;							///< Units done so far
+		double InstantRate;						///< Units per second since the previous update
+		double AverageRate;						///< Units per second since the operation started
+		std::chrono::microseconds Elapsed;		///< Since the operation started
+	};
+	
+	/**
+	 * \class ContextProgress
+	 * Receives the progress callbacks of a GPContext (<tt>gp_context_set_progress_funcs(...)</tt>) and raises them as observer events, with the throughput and elapsed time added.
+	 * 
+	 * The events are raised on the thread doing the operation.
+	 */
+	class ContextProgress
+	{
+	public:
+		ContextProgress();
+		
+		/**
+		 * \brief Detaches from the context
+		 */
+		~ContextProgress();
+		
+		ContextProgress(ContextProgress const & other) = delete;
+		ContextProgress& operator=(ContextProgress const & other) = delete;
+		
+		/**
+		 * \brief Installs the progress callbacks on the context, replacing any others
+		 * \param[in]	context	to receive the progress of, this object must not move while attached
+		 * \note Wrapper for <tt>gp_context_set_progress_funcs(...)</tt>
+		 */
+		void attach(std::shared_ptr<gphoto2::_GPContext> const & context);
+		
+		/**
+		 * \brief Subscribes to a stage of every operation
+		 * \param[in]	event	stage to subscribe to
+		 * \param[in]	func	callback
+		 * \return the registration, the subscription ends when it is destroyed
+		 */
+		observer::Registration subscribe(ProgressEventType const & event, std::function<void(const ProgressEvent&)> func);
+		
+		/**
+		 * \brief Called when an operation starts, normally by the context
+		 * \param[in]	target	units to do
+		 * \param[in]	text	describing the operation
+		 * \return the id of the operation
+		 */
+		unsigned int start(float target, std::string text);
+		
+		/**
+		 * \brief Called when an operation made progress, normally by the context
+		 * \param[in]	id	of the operation
+		 * \param[in]	current	units done so far
+		 */
+		void update(unsigned int id, float current);
+		
+		/**
+		 * \brief Called when an operation finished, normally by the context
+		 * \param[in]	id	of the operation
+		 */
+		void stop(unsigned int id);
+		
+	private:
+		struct Operation
+		{
+			ProgressEvent Event;
+			std::chrono::steady_clock::time_point StartTime;
+			std::chrono::steady_clock::time_point LastTime;
+		};
+		
+		std::weak_ptr<gphoto2::_GPContext> m_context;
+		
+		std::mutex m_mutex;
+		std::map<unsigned int, Operation> m_operations;
+		unsigned int m_nextId;
+		
+		observer::SubjectEvent<ProgressEventType, void(const ProgressEvent&)> m_events;
+	};
+}
+
+#endif // CONTEXTPROGRESS_HPP
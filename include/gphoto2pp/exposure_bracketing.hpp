@@ -0,0 +1,118 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef EXPOSUREBRACKETING_HPP
+#define EXPOSUREBRACKETING_HPP
+
+#include <gphoto2pp/window_widget.hpp>
+#include <gphoto2pp/choices_widget.hpp>
+#include <gphoto2pp/capture_pipeline.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace gphoto2pp
+{
+	class CameraWrapper;
+	
+	/**
+	 * \struct BracketResult
+	 * What an ExposureBracketing::run() captured, one element per frame
+	 */
+	struct BracketResult
+	{
+		std::vector<std::string> Values;							///< The setting's value of each frame
+		std::vector<CameraFilePathWrapper> Files;					///< The path of each frame on the camera
+		std::vector<std::chrono::milliseconds> FrameIntervals;		///< Time between the trigger of each frame and the previous one, zero for the first frame
+		std::chrono::milliseconds Total;							///< Time from the first trigger to the last download
+	};
+	
+	/**
+	 * \class ExposureBracketing
+	 * Captures a bracket of frames stepping one Radio or Menu setting, usually "shutterspeed" (but also "f-number", "iso" or "exposurecompensation").
+	 * 
+	 * The configuration is read and the values are resolved to choice indices once, when the bracket is set up. Each frame then only changes the setting's choice on the already fetched tree and writes it (the only widget flagged as changed), triggers the capture and downloads the previous frame while the camera exposes (see CapturePipeline). The original value is written back at the end.
+	 * 
+	 * \note The camera must be in a mode which allows changing the setting (eg. manual mode for the shutter speed).
+	 */
+	class ExposureBracketing
+	{
+	public:
+		/**
+		 * \brief Reads the configuration and finds the setting to bracket
+		 * \param[in]	cameraWrapper	to capture with
+		 * \param[in]	widgetName	of the Radio or Menu widget which is stepped
+		 * \throw GPhoto2pp::exceptions::InvalidWidgetType if the widget isn't a Radio or Menu widget
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		ExposureBracketing(CameraWrapper& cameraWrapper, std::string const & widgetName = "shutterspeed");
+		
+		ExposureBracketing(ExposureBracketing const & other) = delete;
+		ExposureBracketing& operator=(ExposureBracketing const & other) = delete;
+		
+		/**
+		 * \brief Uses the values, in this order, for the frames
+		 * \param[in]	values	of the setting, they must be among the setting's choices
+		 * \throw GPhoto2pp::exceptions::ValueOutOfLimits if a value isn't one of the setting's choices
+		 */
+		void setValues(std::vector<std::string> const & values);
+		
+		/**
+		 * \brief Uses frames spread evenly around the current value, in order from the lowest to the highest choice index.
+		 * Eg. 5 frames with a step of 3 choices on a 1/3 stop shutter speed list gives -2, -1, 0, +1, +2 stops.
+		 * \param[in]	frames	number of frames, odd numbers keep the current value in the middle
+		 * \param[in]	step	number of choices between two frames, at least one
+		 * \throw GPhoto2pp::exceptions::ArgumentException if the step is less than one
+		 * \throw GPhoto2pp::exceptions::IndexOutOfRange if the bracket goes past the first or last choice
+		 */
+		void setSteps(int frames, int step);
+		
+		/**
+		 * \brief Gets the values the frames will use
+		 * \return the values
+		 */
+		std::vector<std::string> getValues() const;
+		
+		/**
+		 * \brief Captures the bracket, then restores the setting's original value (even if a frame failed).
+		 * \param[in]	fileHandler	called with every downloaded frame, in capture order
+		 * \param[in]	deleteFromCamera	whether each frame is deleted from the camera once downloaded
+		 * \return the frames and their timings
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		BracketResult run(CapturePipeline::FileHandler fileHandler, bool deleteFromCamera = true);
+		
+	private:
+		CameraWrapper& m_cameraWrapper;
+		WindowWidget m_rootWidget;
+		ChoicesWidget m_setting;
+		int m_originalChoice;
+		
+		std::vector<int> m_choices;
+	};
+}
+
+#endif // EXPOSUREBRACKETING_HPP
@@ -36,6 +36,7 @@ namespace gphoto2pp
 	class FloatWidget: public ValueWidgetBase<float>
 	{
 	friend class NonValueWidget;
+	friend class WidgetView;
 
 	public:
 		/**
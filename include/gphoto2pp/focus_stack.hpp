@@ -0,0 +1,155 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef FOCUSSTACK_HPP
+#define FOCUSSTACK_HPP
+
+#include <gphoto2pp/window_widget.hpp>
+#include <gphoto2pp/toggle_widget.hpp>
+#include <gphoto2pp/range_widget.hpp>
+#include <gphoto2pp/radio_widget.hpp>
+#include <gphoto2pp/capture_pipeline.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gphoto2pp
+{
+	class CameraWrapper;
+	
+	/**
+	 * \struct FocusStepTiming
+	 * The measured duration of each part of one focus step
+	 */
+	struct FocusStepTiming
+	{
+		std::chrono::milliseconds Drive;		///< Writing the focus drive command
+		std::chrono::milliseconds Settle;		///< Waiting after the drive command for the rest of the settle time
+		std::chrono::milliseconds Capture;		///< Capturing (and for previews, receiving) the image
+	};
+	
+	/**
+	 * \struct FocusStackResult
+	 * What a FocusStack::run() did, one timing per frame
+	 */
+	struct FocusStackResult
+	{
+		std::vector<FocusStepTiming> Steps;
+		std::chrono::milliseconds Total;		///< Time from the first focus move to the last image handled
+	};
+	
+	/**
+	 * \class FocusStack
+	 * Captures a sequence of frames, moving the manual focus by the same relative amount before each one.
+	 * 
+	 * The configuration is read once and the viewfinder ("viewfinder" or "eosviewfinder") and focus drive ("manualfocusdrive") widgets are kept for the whole sequence. Each step writes the drive command, waits only for what is left of the settle time once the command returned, and captures right away. The download (full captures, see CapturePipeline) or the file handler (previews, run on a worker thread) overlaps with the next focus move.
+	 * 
+	 * \note The viewfinder is turned on for the sequence (the focus can't be driven without it) and turned off afterwards.
+	 */
+	class FocusStack
+	{
+	public:
+		/**
+		 * \brief Reads the configuration and finds the viewfinder and focus drive widgets
+		 * \param[in]	cameraWrapper	to capture with
+		 * \throw GPhoto2pp::exceptions::InvalidWidgetType if the focus drive is neither a Range (eg. Nikon) nor a Radio (eg. Canon) widget
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception if the camera doesn't have a viewfinder or focus drive
+		 */
+		FocusStack(CameraWrapper& cameraWrapper);
+		
+		FocusStack(FocusStack const & other) = delete;
+		FocusStack& operator=(FocusStack const & other) = delete;
+		
+		/**
+		 * \brief Sets the number of frames (10 by default)
+		 * \param[in]	steps	number of frames, the focus is moved before each one
+		 * \throw GPhoto2pp::exceptions::ArgumentException if there is less than one step
+		 */
+		void setSteps(int steps);
+		
+		/**
+		 * \brief Sets the relative amount the focus is moved by, for Range focus drives (512 by default)
+		 * \param[in]	step	drive amount, negative values move towards the closest focus
+		 * \throw GPhoto2pp::exceptions::ArgumentException if the step is zero
+		 * \throw GPhoto2pp::exceptions::ValueOutOfLimits if the focus drive is a Range widget and the step is outside of its range
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		void setRangeStep(float step);
+		
+		/**
+		 * \brief Sets the choice written to move the focus, for Radio focus drives ("Far 2" by default)
+		 * \param[in]	choice	drive choice (eg. "Near 1", "Far 3")
+		 * \throw GPhoto2pp::exceptions::ValueOutOfLimits if the focus drive is a Radio widget without this choice
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		void setChoiceStep(std::string const & choice);
+		
+		/**
+		 * \brief Sets how long the lens needs from the start of the drive command until it can capture (100ms by default).
+		 * Only the part not already spent writing the command is waited for. Cameras whose driver waits for the lens (eg. Nikon) can use zero.
+		 * \param[in]	settleTime	the minimum time between the drive command and the capture
+		 */
+		void setSettleTime(std::chrono::milliseconds settleTime);
+		
+		/**
+		 * \brief Chooses between preview captures (the default, quick and doesn't touch the mirror) and full captures
+		 * \param[in]	usePreview	true for preview captures
+		 */
+		void setUsePreview(bool usePreview);
+		
+		/**
+		 * \brief Captures the stack.
+		 * \param[in]	fileHandler	called with every image in capture order. Previews have an empty folder and a "preview_<n>.jpg" name, and are handled on a worker thread
+		 * \return the timings of each step
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		FocusStackResult run(CapturePipeline::FileHandler fileHandler);
+		
+	private:
+		// Moves the focus and waits for it to settle, the capture timing is left to the caller
+		FocusStepTiming driveFocus();
+		
+		void setViewfinder(int value);
+		
+		CameraWrapper& m_cameraWrapper;
+		WindowWidget m_rootWidget;
+		ToggleWidget m_viewfinder;
+		
+		// Resolved once, only the one matching the focus drive's type is set
+		std::unique_ptr<RangeWidget> m_rangeDrive;
+		std::unique_ptr<RadioWidget> m_radioDrive;
+		std::vector<std::string> m_focusDriveNames;
+		
+		int m_steps;
+		float m_rangeStep;
+		std::string m_choiceStep;
+		std::chrono::milliseconds m_settleTime;
+		bool m_usePreview;
+	};
+}
+
+#endif // FOCUSSTACK_HPP
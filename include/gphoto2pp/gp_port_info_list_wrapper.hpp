@@ -45,6 +45,22 @@ namespace gphoto2pp
 		GPPortInfoListWrapper();
 		~GPPortInfoListWrapper();
 		
+		// Move constructor and move assignment are allowed
+		GPPortInfoListWrapper(GPPortInfoListWrapper&& other);
+		GPPortInfoListWrapper& operator=(GPPortInfoListWrapper&& other);
+		
+		// The list is freed by the destructor, a copy would free it twice
+		GPPortInfoListWrapper(GPPortInfoListWrapper const & other) = delete;
+		GPPortInfoListWrapper& operator=(GPPortInfoListWrapper const & other) = delete;
+		
+		/**
+		 * \brief Gets the port list shared by the whole process.
+		 * The list is loaded once (on first use, thread safe) and then reused. Ports are enumerated when a list is loaded, so a camera plugged in afterwards can be missing from it, use a new list to detect cameras.
+		 * \return the shared list
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		static GPPortInfoListWrapper const & getShared();
+		
 		gphoto2::_GPPortInfoList* getPtr() const;
 		
 		/**
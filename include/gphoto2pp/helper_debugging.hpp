@@ -27,6 +27,11 @@
 
 #include <gphoto2pp/observer.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
 namespace gphoto2pp
 {
 	namespace helper
@@ -40,6 +45,22 @@ namespace gphoto2pp
 				Debug = 2,		// Log message is an debug infomation
 				Data = 3		// Log message is a data hex dump
 			};
+		}
+	}
+	
+	namespace observer
+	{
+		template <>
+		struct DenseEventTraits<helper::debugging::LogLevelWrapper>
+		{
+			static const std::size_t Count = 4;
+		};
+	}
+	
+	namespace helper
+	{
+		namespace debugging
+		{
 			
 			namespace detail
 			{
@@ -53,12 +74,62 @@ namespace gphoto2pp
 				private:
 					int id = 0;
 				};
+				
+				/**
+				 * \brief Dumps the port log ring to its dump file, if it was started with one. Called by checkResponse(...) before it throws.
+				 * \param[in]	error	message of the exception about to be thrown
+				 */
+				void dumpPortLogRingOnError(std::string const & error);
 			}
 			
+			/**
+			 * \struct PortLogRecord
+			 * A libgphoto2 log message kept by the port log ring
+			 */
+			struct PortLogRecord
+			{
+				std::chrono::system_clock::time_point Time;
+				LogLevelWrapper Level;
+				std::string Domain;
+				std::string Text;		///< Truncated to the ring's record size
+			};
+			
 			void startPortLogging(const LogLevelWrapper& level);
 			void stopPortLogging();
 			
+			/**
+			 * \brief Subscribes to libgphoto2's log messages, startPortLogging(...) must be called for them to be received
+			 * \param[in]	event	level to subscribe to, the callback also receives the messages of the more severe levels (like <tt>gp_log_add_func(...)</tt>)
+			 * \param[in]	func	callback, with the level of the message
+			 * \return the registration, the subscription ends when it is destroyed
+			 */
 			observer::Registration subscribeToPortLogEvents(const LogLevelWrapper& event, std::function<void(LogLevelWrapper const & level, std::string const & domain, std::string const & str, void *data)> func);
+			
+			/**
+			 * \brief Starts keeping the most recent libgphoto2 log messages in memory.
+			 * The messages are filtered by level by libgphoto2 and copied into fixed size records, so even Data level logging costs little until it's needed. With a dump file, the ring is written to it each time a gphoto2_exception is thrown, to see what led to the error.
+			 * \param[in]	level	the most verbose level kept
+			 * \param[in]	capacity	number of messages kept, the oldest are overwritten
+			 * \param[in]	dumpFile	rewritten on each error, or empty to only dump with dumpPortLogRing(...)
+			 * \note Restarting replaces the level, capacity and dump file, and clears the ring
+			 */
+			void startPortLogRing(LogLevelWrapper const & level, std::size_t capacity = 1024, std::string dumpFile = "");
+			
+			void stopPortLogRing();
+			
+			/**
+			 * \brief Copies the messages in the ring
+			 * \return the messages, oldest first
+			 */
+			std::vector<PortLogRecord> getPortLogRecords();
+			
+			/**
+			 * \brief Writes the messages in the ring to a file
+			 * \param[in]	file	to (over)write
+			 * \param[in]	reason	written as the first line, eg. the error which caused the dump
+			 * \throw HelperException if the file can't be written
+			 */
+			void dumpPortLogRing(std::string const & file, std::string const & reason = "");
 		}
 	}
 }
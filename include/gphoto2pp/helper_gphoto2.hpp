@@ -25,6 +25,7 @@
 #ifndef HELPERGPHOTO2_HPP
 #define HELPERGPHOTO2_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,29 @@ namespace gphoto2pp
 {
 	class CameraListWrapper;
 	
+	/**
+	 * \struct ResponseErrorCount
+	 * How many times a gphoto2 method failed with one result code
+	 */
+	struct ResponseErrorCount
+	{
+		std::string Operation;		///< The methodName given to checkResponse(...)
+		int ResultCode;				///< The GP_ERROR_* code
+		std::uint64_t Count;
+	};
+	
+	namespace detail
+	{
+		/**
+		 * \brief The failure path of checkResponse(...), counts the error, logs it and throws it
+		 * A GP_ERROR_CANCEL is a cancellation that was asked for, so it is only thrown, without being counted or dumping the port log.
+		 * \param[in]	result	of the gphoto2 method, < 0
+		 * \param[in]	methodName	of the gphoto2 method that was called
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception always
+		 */
+		[[noreturn]] void throwResponseError(int result, char const * methodName);
+	}
+	
 	/**
 	 * \brief Finds the first available and recognized camera type connected to the computer
 	 * \return the model and port of the first camera found
@@ -58,6 +82,23 @@ namespace gphoto2pp
 	 * \param[in]	methodName	of the gphoto2 method that was called
 	 * \return the integer result returned from all gphoto2 methods. All results < 0 will be caught and thrown in the exception type. Some gphoto2 methods return the count of items, and so values > 0 can be returned and unrelated to error codes
 	 * \throw GPhoto2pp::exceptions::gphoto2_exception
+	 * \note The name is only used on failure, so a success costs a single comparison. The name also identifies the method in getResponseErrorCounts().
+	 */
+	inline int checkResponse(int result, char const * methodName)
+	{
+		if(result < 0)
+		{
+			detail::throwResponseError(result, methodName);
+		}
+		return result;
+	}
+	
+	/**
+	 * \brief Same as checkResponse(int, char const *), for a method name built at runtime
+	 * \param[in]	result	of the gphoto2 method
+	 * \param[in]	methodName	of the gphoto2 method that was called
+	 * \return the integer result returned from the gphoto2 method
+	 * \throw GPhoto2pp::exceptions::gphoto2_exception
 	 */
 	int checkResponse(int result, std::string&& methodName);
 	
@@ -67,7 +108,16 @@ namespace gphoto2pp
 	 * \param[in]	methodName	of the gphoto2 method that was called
 	 * \return the integer result returned from all gphoto2 methods. This is usually <= 0 (gphoto2 error codes), but some methods return the count of items, and so values > 0 can be returned and unrelated to error codes
 	 */
+	int checkResponseSilent(int result, char const * methodName);
+	
 	int checkResponseSilent(int result, std::string&& methodName);
+	
+	/**
+	 * \brief Gets the number of failures of each gphoto2 method checked with checkResponse(...) or checkResponseSilent(...), per result code
+	 * \return the counts since the process started, by method name then code
+	 * \note Cancellations (GP_ERROR_CANCEL) aren't failures and aren't counted
+	 */
+	std::vector<ResponseErrorCount> getResponseErrorCounts();
 
 	/**
 	 * \brief Returns the version of gphoto library currently linked in the system
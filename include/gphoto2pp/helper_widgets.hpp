@@ -25,8 +25,11 @@
 #ifndef HELPERWIDGETS_HPP
 #define HELPERWIDGETS_HPP
 
+#include <gphoto2pp/widget_view.hpp>
+
 #include <string>
 #include <vector>
+#include <functional>
 
 //g++ -std=c++11 main.cpp -o main -I. -I/usr/include/boost -I../Library ../Library/logog/liblogog.a ./Debug/libGPhoto2pp.a -lgphoto2
 //g++ -std=c++11 main.cpp -o main -I. -I/usr/include/boost -I../Library ../Library/logog/liblogog.a ./Debug/libGPhoto2pp.a -lgphoto2 -DLOGOG_LEVEL=0
@@ -38,7 +41,80 @@ namespace gphoto2pp
 	enum class CameraWidgetTypeWrapper : int;
 	
 	namespace helper
-	{	
+	{
+		/**
+		 * \class WidgetPath
+		 * The names of the ancestors of a visited widget, from the starting node down to its parent.
+		 * The segments are the names owned by gphoto2, so building the path doesn't copy any strings.
+		 */
+		class WidgetPath
+		{
+		public:
+			WidgetPath();
+			
+			/**
+			 * \brief Gets the number of segments
+			 * \return the depth of the path, 0 for the starting node
+			 */
+			std::size_t size() const;
+			
+			/**
+			 * \brief Gets the segment at the index, 0 being the starting node
+			 * \param[in]	index	of the segment to get
+			 * \return the widget name, owned by gphoto2
+			 */
+			char const * operator[](std::size_t index) const;
+			
+			/**
+			 * \brief Formats the segments as a path, eg... /main/imgsettings
+			 * \return the path, or an empty string for the starting node
+			 */
+			std::string toString() const;
+			
+			// Used by the traversal when it descends into and comes back from a widget's children
+			void push(char const * segment);
+			void pop();
+			
+		private:
+			std::vector<char const *> m_segments;
+		};
+		
+		/**
+		 * Returned by a WidgetVisitor to tell the traversal how to continue
+		 */
+		enum class VisitResult : int
+		{
+			Continue = 0,		///< Visit the children of this widget, then its siblings
+			SkipChildren = 1,	///< Don't visit the children of this widget
+			Stop = 2			///< End the traversal
+		};
+		
+		/**
+		 * Callback for visitWidgets, which receives each widget and the path of its parent. Both are only valid during the call.
+		 */
+		using WidgetVisitor = std::function<VisitResult(WidgetView const & widget, WidgetPath const & parentPath)>;
+		
+		/**
+		 * \brief Traverses the widget tree (depth first pre-order) and calls the visitor for every widget.
+		 * The traversal works on WidgetViews and reuses a single path, so nothing is allocated per widget.
+		 * \param[in]	parentWidget	is the starting node, it is visited first and only its descendants are visited after it
+		 * \param[in]	visitor	to call for each widget
+		 * \return false if the visitor stopped the traversal, otherwise true
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		bool visitWidgets(NonValueWidget const & parentWidget, WidgetVisitor const & visitor);
+		
+		/**
+		 * \brief Traverses the widget tree (depth first pre-order) and calls the visitor for every widget matching the provided type.
+		 * The children of widgets that don't match are still visited.
+		 * \param[in]	parentWidget	is the starting node, it is visited first and only its descendants are visited after it
+		 * \param[in]	filterByWidgetType	will only call the visitor for widgets of this type
+		 * \param[in]	visitor	to call for each matching widget
+		 * \return false if the visitor stopped the traversal, otherwise true
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		bool visitWidgetsOfType(NonValueWidget const & parentWidget, CameraWidgetTypeWrapper const & filterByWidgetType, WidgetVisitor const & visitor);
+		
 		/**
 		 * \brief Traverses the widget tree (depth first pre-order) and returns all widgets
 		 * \param[in]	parentWidget	is the starting node, and this will only traverse children of this node (it will not visit ancestors, if present)
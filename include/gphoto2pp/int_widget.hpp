@@ -36,6 +36,7 @@ namespace gphoto2pp
 	class IntWidget: public ValueWidgetBase<int>
 	{
 	friend class NonValueWidget;
+	friend class WidgetView;
 
 	public:
 		/**
@@ -0,0 +1,183 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gphoto2pp
+{
+	/**
+	 * \struct LatencySnapshot
+	 * The distribution of a histogram's latencies at one point in time. Percentiles are accurate to about 12%.
+	 */
+	struct LatencySnapshot
+	{
+		std::uint64_t Count;					///< Number of latencies recorded
+		std::chrono::microseconds Mean;
+		std::chrono::microseconds P50;
+		std::chrono::microseconds P99;
+		std::chrono::microseconds Max;			///< Exact
+	};
+	
+	/**
+	 * \class LatencyHistogram
+	 * Counts latencies in logarithmic buckets (4 per power of two, exact below 8us), from any number of threads. Recording is a few relaxed atomic operations and never allocates.
+	 */
+	class LatencyHistogram
+	{
+	public:
+		static const std::size_t BucketCount = 8 + 4 * 33;
+		
+		LatencyHistogram();
+		
+		LatencyHistogram(LatencyHistogram const & other) = delete;
+		LatencyHistogram& operator=(LatencyHistogram const & other) = delete;
+		
+		void record(std::chrono::microseconds latency);
+		
+		/**
+		 * \brief Reads the distribution, while latencies may still be recorded
+		 * \return the snapshot, all zero if nothing was recorded
+		 */
+		LatencySnapshot snapshot() const;
+		
+		/**
+		 * \brief Finds the bucket of a latency
+		 * \param[in]	microseconds	latency
+		 * \return index of the bucket, the last one also counts everything longer
+		 */
+		static std::size_t bucketIndex(std::uint64_t microseconds);
+		
+		/**
+		 * \brief The latency reported for a bucket, its middle
+		 * \param[in]	index	of the bucket
+		 * \return the latency in microseconds
+		 */
+		static std::uint64_t bucketValue(std::size_t index);
+		
+	private:
+		std::array<std::atomic<std::uint64_t>, BucketCount> m_buckets;
+		std::atomic<std::uint64_t> m_count;
+		std::atomic<std::uint64_t> m_sum;
+		std::atomic<std::uint64_t> m_max;
+	};
+	
+	/**
+	 * \struct OperationLatencySnapshot
+	 * The latencies of one camera operation, the time waiting for the camera (while another call uses it) separate from the time of the call itself
+	 */
+	struct OperationLatencySnapshot
+	{
+		std::string Operation;					///< The gphoto2 method, eg. "gp_camera_capture"
+		LatencySnapshot LockWait;
+		LatencySnapshot Io;
+	};
+	
+	/**
+	 * \class OperationLatencies
+	 * A pair of latency histograms per operation, each CameraWrapper times its calls with one (see CameraWrapper::getLatencies()).
+	 * 
+	 * The operations are looked up by the address of their name first, the names must outlive this object (string literals do). An operation's histograms are created on its first call without allocating, past MaxOperations operations new ones aren't recorded.
+	 */
+	class OperationLatencies
+	{
+	private:
+		struct Entry
+		{
+			Entry() : Operation{nullptr} {}
+			
+			std::atomic<char const *> Operation;
+			LatencyHistogram LockWait;
+			LatencyHistogram Io;
+		};
+		
+	public:
+		static const std::size_t MaxOperations = 32;
+		
+		/**
+		 * \class Timer
+		 * Times one call, from its creation to locked() is the lock wait, from locked() to its destruction the I/O
+		 */
+		class Timer
+		{
+		public:
+			Timer();
+			explicit Timer(Entry* entry);
+			~Timer();
+			
+			Timer(Timer&& other);
+			Timer& operator=(Timer&& other) = delete;
+			
+			Timer(Timer const & other) = delete;
+			Timer& operator=(Timer const & other) = delete;
+			
+			/**
+			 * \brief Marks the end of the lock wait and the start of the I/O
+			 */
+			void locked();
+			
+		private:
+			Entry* m_entry;
+			std::chrono::steady_clock::time_point m_start;
+			std::chrono::steady_clock::time_point m_locked;
+		};
+		
+		OperationLatencies();
+		
+		OperationLatencies(OperationLatencies const & other) = delete;
+		OperationLatencies& operator=(OperationLatencies const & other) = delete;
+		
+		/**
+		 * \brief Starts timing a call, before waiting for the camera's lock
+		 * \param[in]	operation	name of the call, a string literal
+		 * \return the timer, to destroy once the call returned
+		 */
+		Timer begin(char const * operation);
+		
+		/**
+		 * \brief Reads the latencies of all operations called so far
+		 * \return a snapshot per operation, in the order of their first call
+		 */
+		std::vector<OperationLatencySnapshot> snapshot() const;
+		
+	private:
+		Entry* find(char const * operation);
+		
+		std::array<Entry, MaxOperations> m_entries;
+		std::atomic<std::size_t> m_size;
+		std::mutex m_addMutex;
+	};
+}
+
+#endif // LATENCYHISTOGRAM_HPP
@@ -3,6 +3,7 @@
 
 // from here http://stackoverflow.com/questions/5028302/small-logger-class
 
+#include <atomic>
 #include <sstream>
 #include <string>
 #include <stdio.h>
@@ -11,34 +12,57 @@ inline std::string NowTime();
 
 enum TLogLevel {logEMERGENCY, logALERT, logCRITICAL, logERROR, logWARN, logWARN1, logWARN2, logWARN3, logINFO, logDEBUG};
 
+// The part of the library a message comes from, each can have its own reporting level
+enum TLogSubsystem {logsysGENERAL, logsysCAMERA, logsysDETECT, logsysCONFIG, logsysFILE, logsysPORT, logsysCOUNT};
+
+// Takes over the output of a finished message (see Output2FILE::Sink()), the message has no timestamp or level prefix
+typedef void (*TLogSink)(TLogLevel level, TLogSubsystem subsystem, std::ostringstream& message);
+
 template <typename T>
 class Log
 {
 public:
-    Log();
+    Log(TLogSubsystem subsystem = logsysGENERAL);
     virtual ~Log();
     std::ostringstream& Get(TLogLevel level = logINFO);
 public:
     static TLogLevel& ReportingLevel();
+    static TLogLevel ReportingLevel(TLogSubsystem subsystem);
+    static void SetSubsystemLevel(TLogSubsystem subsystem, TLogLevel level);
+    static void ResetSubsystemLevel(TLogSubsystem subsystem);
     static std::string ToString(TLogLevel level);
+    static const char* ToString(TLogSubsystem subsystem);
     static TLogLevel FromString(const std::string& level);
 protected:
     std::ostringstream os;
 private:
+    static std::atomic<int>& SubsystemLevel(TLogSubsystem subsystem);
     Log(const Log&);
     Log& operator =(const Log&);
+    TLogSubsystem subsystem;
+    TLogLevel level;
+    TLogSink sink;
 };
 
 template <typename T>
-Log<T>::Log()
+Log<T>::Log(TLogSubsystem subsystem)
+    : os(std::ios_base::in | std::ios_base::out), subsystem(subsystem), level(logINFO), sink(nullptr)
 {
 }
 
 template <typename T>
 std::ostringstream& Log<T>::Get(TLogLevel level)
 {
-    os << "- " << NowTime();
-    os << " " << ToString(level) << ": ";
+    this->level = level;
+    sink = T::Sink().load(std::memory_order_acquire);
+    if (!sink)
+    {
+        // A sink stamps the message itself, off this thread
+        os << "- " << NowTime();
+        os << " " << ToString(level) << ": ";
+        if (subsystem != logsysGENERAL)
+            os << "[" << ToString(subsystem) << "] ";
+    }
     os << std::string(level > logWARN && level <= logWARN3 ? level - logWARN : 0, '\t');
     return os;
 }
@@ -46,6 +70,11 @@ std::ostringstream& Log<T>::Get(TLogLevel level)
 template <typename T>
 Log<T>::~Log()
 {
+    if (sink)
+    {
+        sink(level, subsystem, os);
+        return;
+    }
     os << std::endl;
     T::Output(os.str());
 }
@@ -57,6 +86,34 @@ TLogLevel& Log<T>::ReportingLevel()
     return reportingLevel;
 }
 
+template <typename T>
+TLogLevel Log<T>::ReportingLevel(TLogSubsystem subsystem)
+{
+    // 0 means the subsystem follows ReportingLevel(), otherwise it holds its level + 1
+    int const level = SubsystemLevel(subsystem).load(std::memory_order_relaxed);
+    return level == 0 ? ReportingLevel() : static_cast<TLogLevel>(level - 1);
+}
+
+template <typename T>
+void Log<T>::SetSubsystemLevel(TLogSubsystem subsystem, TLogLevel level)
+{
+    SubsystemLevel(subsystem).store(level + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+void Log<T>::ResetSubsystemLevel(TLogSubsystem subsystem)
+{
+    SubsystemLevel(subsystem).store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+std::atomic<int>& Log<T>::SubsystemLevel(TLogSubsystem subsystem)
+{
+    // Zero initialized, so every subsystem starts out following ReportingLevel()
+    static std::atomic<int> subsystemLevels[logsysCOUNT];
+    return subsystemLevels[subsystem];
+}
+
 template <typename T>
 std::string Log<T>::ToString(TLogLevel level)
 {
@@ -64,6 +121,13 @@ std::string Log<T>::ToString(TLogLevel level)
     return buffer[level];
 }
 
+template <typename T>
+const char* Log<T>::ToString(TLogSubsystem subsystem)
+{
+    static const char* const buffer[] = {"GENERAL", "CAMERA", "DETECT", "CONFIG", "FILE", "PORT"};
+    return buffer[subsystem];
+}
+
 template <typename T>
 TLogLevel Log<T>::FromString(const std::string& level)
 {
@@ -95,6 +159,7 @@ class Output2FILE
 {
 public:
     static FILE*& Stream();
+    static std::atomic<TLogSink>& Sink();
     static void Output(const std::string& msg);
 };
 
@@ -104,6 +169,13 @@ inline FILE*& Output2FILE::Stream()
     return pStream;
 }
 
+// When set, finished messages are handed to the sink instead of being written here (see gphoto2pp::AsyncLogWriter)
+inline std::atomic<TLogSink>& Output2FILE::Sink()
+{
+    static std::atomic<TLogSink> sink(nullptr);
+    return sink;
+}
+
 inline void Output2FILE::Output(const std::string& msg)
 {   
     FILE* pStream = Stream();
@@ -125,17 +197,28 @@ inline void Output2FILE::Output(const std::string& msg)
 #   define FILELOG_DECLSPEC
 #endif // _WIN32
 
-class FILELOG_DECLSPEC FILELog : public Log<Output2FILE> {};
+class FILELOG_DECLSPEC FILELog : public Log<Output2FILE>
+{
+public:
+    FILELog(TLogSubsystem subsystem = logsysGENERAL) : Log<Output2FILE>(subsystem) {}
+};
 //typedef Log<Output2FILE> FILELog;
 
 #ifndef FILELOG_MAX_LEVEL
 #define FILELOG_MAX_LEVEL logDEBUG
 #endif
 
-#define FILE_LOG(level) \
+// A source file defines this before its includes to log to its own subsystem
+#ifndef FILELOG_SUBSYSTEM
+#define FILELOG_SUBSYSTEM logsysGENERAL
+#endif
+
+#define FILE_LOG_S(subsystem, level) \
     if (level > FILELOG_MAX_LEVEL) ;\
-    else if (level > FILELog::ReportingLevel() || !Output2FILE::Stream()) ; \
-    else FILELog().Get(level)
+    else if (level > FILELog::ReportingLevel(subsystem) || !Output2FILE::Stream()) ; \
+    else FILELog(subsystem).Get(level)
+
+#define FILE_LOG(level) FILE_LOG_S(FILELOG_SUBSYSTEM, level)
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
 
@@ -35,6 +35,8 @@ namespace gphoto2pp
 	 */
 	class NonValueWidget : public CameraWidgetWrapper
 	{
+	friend class WidgetView;
+	
 	public:
 		/**
 		 * \brief Gets the number of children to this current widget
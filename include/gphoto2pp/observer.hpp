@@ -28,7 +28,11 @@
 
 #include <vector>
 #include <map>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include <algorithm>
 #include <stdexcept>
@@ -43,6 +47,15 @@ namespace gphoto2pp
 		// the same lifetime.
 		using Registration = std::shared_ptr<void>;
 
+		// Event types are kept in a std::map by default. Specialise this for enums
+		// whose values are 0 to Count - 1 (at most 64), their observers are then
+		// kept in a fixed array indexed by the event value instead.
+		template <typename EventType>
+		struct DenseEventTraits
+		{
+			static const std::size_t Count = 0;
+		};
+
 
 		// Nothing to see here, the detail namespace is used for just that:
 		// implementation details 
@@ -66,12 +79,45 @@ namespace gphoto2pp
 				return UniversalPtr((void*) 0xDEADC0DE, deleter);
 			}
 
-			// Slap the baby's bottom. This functions creates a complete no-op shared_ptr
-			// which we use as the 'heartbeat' for the Subject
-			inline UniversalPtr createHeartBeat()
+			// The observers of a subject, published as immutable snapshots. Notifying
+			// only loads the current snapshot and never blocks on (un)registrations,
+			// which copy the list, modify the copy and swap it in. An observer removed
+			// while a notification runs can still be called once by that notification.
+			template <typename List>
+			class CopyOnWriteList
 			{
-				return createEmptyPtr([] (void*) {});
-			}
+			public:
+				CopyOnWriteList(): list_(std::make_shared<List const>()) {}
+
+				std::shared_ptr<List const> load() const
+				{
+					return std::atomic_load(&list_);
+				}
+
+				template <typename Modifier>
+				void modify(Modifier modifier)
+				{
+					modify(modifier, [] (List const &) {});
+				}
+
+				// published is called with the new list before any other writer can change it
+				template <typename Modifier, typename Published>
+				void modify(Modifier modifier, Published published)
+				{
+					// Writers are serialized so none of their changes get lost
+					std::lock_guard<std::mutex> lock(mutex_);
+
+					auto copy = std::make_shared<List>(*list_);
+					modifier(*copy);
+					published(*copy);
+
+					std::atomic_store(&list_, std::shared_ptr<List const>(std::move(copy)));
+				}
+
+			private:
+				std::mutex mutex_;
+				std::shared_ptr<List const> list_;
+			};
 
 			// A base class for handling common code in all Subjects. Normally using
 			// inheritance for code reuse is bad but in this case it is a common idiom
@@ -81,62 +127,229 @@ namespace gphoto2pp
 			class SubjectBase
 			{
 			protected:
-				SubjectBase(): heartBeat_(createHeartBeat()) {}
+				using ObserverList = std::vector<UniversalPtr>;
+
+				SubjectBase(): state_(std::make_shared<CopyOnWriteList<ObserverList>>()) {}
 
 				Registration registerObserver(UniversalPtr fptr)
 				{
-					observers_.push_back(fptr);
-					std::weak_ptr<UniversalPtr::element_type> weakHeartBeat(heartBeat_);
+					if (!state_)
+					{
+						// This subject was moved from, it starts over with an empty list
+						state_ = std::make_shared<CopyOnWriteList<ObserverList>>();
+					}
+
+					state_->modify([&fptr] (ObserverList& observers) { observers.push_back(fptr); });
+					std::weak_ptr<CopyOnWriteList<ObserverList>> weakState(state_);
 
-					// we pass the function pointer and a weak_ptr into this lambda by
-					// value. This is important because it lets the observer know if the
-					// subject is still alive at the moment of unregistering.
+					// we pass the function pointer and a weak_ptr to the observer list into
+					// this lambda by value. This is important because it lets the observer know
+					// if the subject is still alive at the moment of unregistering, and the list
+					// follows the subject when it is moved.
 					// This is basically the Registration, it's a placeholder that removes
 					// the observer from the list when the registration goes out of scope.
-					return createEmptyPtr([fptr, weakHeartBeat, this] (void*) 
+					return createEmptyPtr([fptr, weakState] (void*) 
 					{ 
-						if (auto isBeating = weakHeartBeat.lock())
+						if (auto state = weakState.lock())
 						{
-							observers_.erase(std::remove(begin(observers_), end(observers_), fptr), end(observers_));
+							state->modify([&fptr] (ObserverList& observers)
+							{
+								observers.erase(std::remove(begin(observers), end(observers), fptr), end(observers));
+							});
 						}
 					});
 				}
 
-				std::vector<UniversalPtr> observers_;
+				std::shared_ptr<ObserverList const> observers() const
+				{
+					return state_ ? state_->load() : nullptr;
+				}
+
+			public:
+				// Lets the notifier skip building arguments nobody is going to receive
+				bool hasObservers() const
+				{
+					auto const observers = this->observers();
+					return observers && !observers->empty();
+				}
 
 			private:
-				UniversalPtr heartBeat_;
+				std::shared_ptr<CopyOnWriteList<ObserverList>> state_;
 			};
 			
-			template<typename EventTypeBase>
+			template<typename EventTypeBase, std::size_t DenseCount = DenseEventTraits<EventTypeBase>::Count>
 			class SubjectBaseEvent
 			{
+				static_assert(DenseCount <= 64, "DenseEventTraits supports at most 64 event types");
+
+			public:
+				bool hasObservers(const EventTypeBase& e) const
+				{
+					auto const index = static_cast<std::size_t>(e);
+					return state_ && index < DenseCount && (state_->activeMask.load(std::memory_order_acquire) & (std::uint64_t(1) << index)) != 0;
+				}
+
+			protected:
+				using ObserverArray = std::array<std::vector<UniversalPtr>, DenseCount>;
+
+				// The mask has a bit set for each event type with observers, so an event
+				// nobody subscribed to costs a single atomic load
+				struct State : CopyOnWriteList<ObserverArray>
+				{
+					std::atomic<std::uint64_t> activeMask{0};
+
+					void publishMask(ObserverArray const & observers)
+					{
+						std::uint64_t mask = 0;
+						for (std::size_t i = 0; i < DenseCount; ++i)
+						{
+							if (!observers[i].empty())
+							{
+								mask |= std::uint64_t(1) << i;
+							}
+						}
+						activeMask.store(mask, std::memory_order_release);
+					}
+				};
+
+				SubjectBaseEvent(): state_(std::make_shared<State>()) {}
+
+				Registration registerObserver(const EventTypeBase& e, UniversalPtr fptr)
+				{
+					auto const index = static_cast<std::size_t>(e);
+					if (index >= DenseCount)
+					{
+						throw std::out_of_range("observer event type is outside of its DenseEventTraits count");
+					}
+
+					if (!state_)
+					{
+						// This subject was moved from, it starts over with an empty list
+						state_ = std::make_shared<State>();
+					}
+
+					State* state = state_.get();
+					state_->modify([index, &fptr] (ObserverArray& observers) { observers[index].push_back(fptr); },
+						[state] (ObserverArray const & observers) { state->publishMask(observers); });
+					std::weak_ptr<State> weakState(state_);
+
+					// Same as the std::map version below, the weak_ptr lets the observer know
+					// if the subject is still alive at the moment of unregistering.
+					return createEmptyPtr([index, fptr, weakState] (void*) 
+					{ 
+						if (auto state = weakState.lock())
+						{
+							State* rawState = state.get();
+							state->modify([index, &fptr] (ObserverArray& observers)
+							{
+								observers[index].erase(std::remove(begin(observers[index]), end(observers[index]), fptr), end(observers[index]));
+							},
+							[rawState] (ObserverArray const & observers) { rawState->publishMask(observers); });
+						}
+					});
+				}
+
+				template <typename Visitor>
+				void notify(const EventTypeBase& e, Visitor visit) const
+				{
+					if (!hasObservers(e))
+					{
+						return;
+					}
+
+					auto const observers = state_->load();
+					for (auto const & observer : (*observers)[static_cast<std::size_t>(e)])
+					{
+						visit(observer);
+					}
+				}
+
+			private:
+				std::shared_ptr<State> state_;
+			};
+			
+			// Event types without DenseEventTraits, kept in a std::map
+			template<typename EventTypeBase>
+			class SubjectBaseEvent<EventTypeBase, 0>
+			{
+			public:
+				bool hasObservers(const EventTypeBase& e) const
+				{
+					auto const observers = this->observers();
+					return observers && observers->find(e) != observers->end();
+				}
+
 			protected:
-				SubjectBaseEvent(): heartBeat_(createHeartBeat()) {}
+				using ObserverMap = std::map<EventTypeBase, std::vector<UniversalPtr>>;
+
+				SubjectBaseEvent(): state_(std::make_shared<CopyOnWriteList<ObserverMap>>()) {}
 
 				Registration registerObserver(const EventTypeBase& e, UniversalPtr fptr)
 				{
-					observers_[e].push_back(fptr);
-					std::weak_ptr<UniversalPtr::element_type> weakHeartBeat(heartBeat_);
+					if (!state_)
+					{
+						// This subject was moved from, it starts over with an empty list
+						state_ = std::make_shared<CopyOnWriteList<ObserverMap>>();
+					}
+
+					state_->modify([&e, &fptr] (ObserverMap& observers) { observers[e].push_back(fptr); });
+					std::weak_ptr<CopyOnWriteList<ObserverMap>> weakState(state_);
 
-					// we pass the function pointer and a weak_ptr into this lambda by
-					// value. This is important because it lets the observer know if the
-					// subject is still alive at the moment of unregistering.
+					// we pass the function pointer and a weak_ptr to the observer list into
+					// this lambda by value. This is important because it lets the observer know
+					// if the subject is still alive at the moment of unregistering, and the list
+					// follows the subject when it is moved.
 					// This is basically the Registration, it's a placeholder that removes
 					// the observer from the list when the registration goes out of scope.
-					return createEmptyPtr([e, fptr, weakHeartBeat, this] (void*) 
+					return createEmptyPtr([e, fptr, weakState] (void*) 
 					{ 
-						if (auto isBeating = weakHeartBeat.lock())
+						if (auto state = weakState.lock())
 						{
-							observers_[e].erase(std::remove(begin(observers_[e]), end(observers_[e]), fptr), end(observers_[e]));
+							state->modify([&e, &fptr] (ObserverMap& observers)
+							{
+								auto it = observers.find(e);
+								if (it != observers.end())
+								{
+									it->second.erase(std::remove(begin(it->second), end(it->second), fptr), end(it->second));
+									if (it->second.empty())
+									{
+										observers.erase(it);
+									}
+								}
+							});
 						}
 					});
 				}
 
-				std::map<EventTypeBase, std::vector<UniversalPtr>> observers_;
+				std::shared_ptr<ObserverMap const> observers() const
+				{
+					return state_ ? state_->load() : nullptr;
+				}
+
+				template <typename Visitor>
+				void notify(const EventTypeBase& e, Visitor visit) const
+				{
+					auto const observers = this->observers();
+					if (!observers)
+					{
+						return;
+					}
+
+					auto it = observers->find(e);
+					if (it == observers->end())
+					{
+						// Nobody subscribed to this event type
+						return;
+					}
+
+					for (auto const & observer : it->second)
+					{
+						visit(observer);
+					}
+				}
 
 			private:
-				UniversalPtr heartBeat_;
+				std::shared_ptr<CopyOnWriteList<ObserverMap>> state_;
 			};
 		 
 		} // eons detail
@@ -149,7 +362,8 @@ namespace gphoto2pp
 		// The Subject class is specialised on the type of 'notification' you
 		// want to send to the observers. Like Registration the Subject objects
 		// should be tied to the lifetime of what is the real subject, preferably as
-		// a member variable.
+		// a member variable. Observers can be (un)registered from any thread, also
+		// while notifying.
 		template <typename Return, typename... Params>
 		struct Subject<Return (Params...)> : detail::SubjectBase
 		{
@@ -158,7 +372,13 @@ namespace gphoto2pp
 			
 			void operator()(Params... params)
 			{
-				for (auto const & observer : observers_)
+				auto const observers = this->observers();
+				if (!observers)
+				{
+					return;
+				}
+
+				for (auto const & observer : *observers)
 				{
 					FPtr const fptr = std::static_pointer_cast<F>(observer);
 					(*fptr)(params...);
@@ -185,18 +405,11 @@ namespace gphoto2pp
 
 			void operator()(EventType const & e, Params... params)
 			{
-				try
-				{
-					for (auto const & observer : this->observers_.at(e))
-					{
-						FPtr const fptr = std::static_pointer_cast<F>(observer);
-						(*fptr)(params...);
-					}
-				}
-				catch(std::out_of_range const & e)
+				this->notify(e, [&] (detail::UniversalPtr const & observer)
 				{
-					// Supress this, means our std::map  .at() method doesn't have an event of this type
-				}
+					FPtr const fptr = std::static_pointer_cast<F>(observer);
+					(*fptr)(params...);
+				});
 			}
 			
 			Registration registerObserver(EventType const & e, F f)
@@ -0,0 +1,67 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef PROPERTYCHANGEDEVENT_HPP
+#define PROPERTYCHANGEDEVENT_HPP
+
+#include <string>
+
+namespace gphoto2pp
+{
+	/**
+	 * \struct PropertyChangedEvent
+	 * A camera property which changed, as reported by the PTP driver through an Unknown event (eg. "PTP Property d00e changed").
+	 */
+	struct PropertyChangedEvent
+	{
+		int PropertyCode;					///< The PTP device property code, eg. 0x500f for the iso
+		std::string WidgetName;				///< Name of the widget which holds the property, eg. "iso". Empty when the code isn't one of the standard PTP properties (vendor properties vary per camera)
+	};
+	
+	/**
+	 * \brief Parses the text of an Unknown camera event into a property change.
+	 * \param[in]	eventText	the data of the Unknown event
+	 * \param[out]	event	receives the property code and, when known, the widget name
+	 * \return true if the text was a property change, otherwise false and the event is left untouched
+	 */
+	bool parsePropertyChangedEvent(std::string const & eventText, PropertyChangedEvent& event);
+	
+	/**
+	 * \brief Parses only the property code out of an Unknown event's text, without allocating.
+	 * \param[in]	eventText	the data of the Unknown event
+	 * \param[out]	propertyCode	receives the PTP device property code
+	 * \return true if the text was a property change, otherwise false and the code is left untouched
+	 */
+	bool parsePropertyCode(char const * eventText, int& propertyCode);
+	
+	/**
+	 * \brief Gets the name of the widget gphoto2 uses for a standard PTP device property
+	 * \param[in]	propertyCode	the PTP device property code
+	 * \return the widget name, or an empty string if the property isn't one of the standard ones
+	 */
+	std::string propertyCodeToWidgetName(int propertyCode);
+}
+
+#endif // PROPERTYCHANGEDEVENT_HPP
@@ -36,6 +36,7 @@ namespace gphoto2pp
 	class RadioWidget: public ChoicesWidget
 	{
 	friend class NonValueWidget;
+	friend class WidgetView;
 		
 	protected:
 		RadioWidget(gphoto2::_CameraWidget* cameraWidget);
@@ -35,6 +35,9 @@ namespace gphoto2pp
 	 */
 	class SectionWidget: public NonValueWidget
 	{
+	friend class NonValueWidget;
+	friend class WidgetView;
+	
 	protected:
 		SectionWidget(gphoto2::_CameraWidget* cameraWidget);
 	};
@@ -38,6 +38,7 @@ namespace gphoto2pp
 	class StringWidget : public ValueWidgetBase<std::string>
 	{
 	friend class NonValueWidget;
+	friend class WidgetView;
 
 	public:
 		/**
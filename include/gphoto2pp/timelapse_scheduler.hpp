@@ -0,0 +1,155 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef TIMELAPSESCHEDULER_HPP
+#define TIMELAPSESCHEDULER_HPP
+
+#include <gphoto2pp/capture_pipeline.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gphoto2pp
+{
+	class CameraWrapper;
+	
+	/**
+	 * \struct TimelapseStatistics
+	 * How well a TimelapseScheduler kept to its timeline. Jitter is how late each trigger was compared to its planned time.
+	 */
+	struct TimelapseStatistics
+	{
+		std::size_t Triggered;					///< Slots captured
+		std::size_t Missed;						///< Slots skipped because the camera was still busy past the tolerance
+		std::size_t Failed;						///< Slots whose capture failed
+		std::chrono::microseconds MinJitter;
+		std::chrono::microseconds MaxJitter;
+		std::chrono::microseconds MeanJitter;
+		std::chrono::microseconds P50Jitter;	///< Median
+		std::chrono::microseconds P99Jitter;
+	};
+	
+	/**
+	 * \class TimelapseScheduler
+	 * Captures frames on an absolute timeline, on its own thread.
+	 * 
+	 * Slot n is planned at start + n * interval on the monotonic clock, so the time spent capturing and downloading never accumulates into drift. A slot which can't be triggered within the tolerance (because the previous one is still running) is skipped and reported as missed, the following slots keep their planned times. Each image is downloaded while the camera exposes the next one (see CapturePipeline).
+	 * 
+	 * Every scheduler has its own thread, so several cameras can run their own schedules in one process.
+	 */
+	class TimelapseScheduler
+	{
+	public:
+		/**
+		 * \brief Prepares a schedule, call start() to begin
+		 * \param[in]	cameraWrapper	to capture with, it must not be listening for events
+		 * \param[in]	interval	between two planned triggers
+		 * \param[in]	frames	number of slots, zero to run until stop()
+		 * \param[in]	fileHandler	called with every downloaded image, on the scheduler's thread
+		 */
+		TimelapseScheduler(CameraWrapper& cameraWrapper, std::chrono::milliseconds interval, std::size_t frames, CapturePipeline::FileHandler fileHandler);
+		
+		/**
+		 * \brief Stops the schedule and waits for its thread
+		 */
+		~TimelapseScheduler();
+		
+		TimelapseScheduler(TimelapseScheduler const & other) = delete;
+		TimelapseScheduler& operator=(TimelapseScheduler const & other) = delete;
+		
+		/**
+		 * \brief Sets how late a slot may still be triggered (a quarter of the interval by default), it can be changed while running
+		 * \param[in]	tolerance	the maximum lateness, later slots are skipped
+		 */
+		void setTolerance(std::chrono::milliseconds tolerance);
+		
+		/**
+		 * \brief Starts the schedule, the first slot is planned right away. A schedule which finished can be started again.
+		 * \return true if started, false if it is already running
+		 */
+		bool start();
+		
+		/**
+		 * \brief Stops the schedule and waits for the current slot (and its download) to finish
+		 */
+		void stop();
+		
+		/**
+		 * \brief Waits until every slot passed (or stop() was called)
+		 */
+		void wait();
+		
+		/**
+		 * \brief Checks if the schedule is still running
+		 * \return true until the last slot passed or stop() was called
+		 */
+		bool isRunning() const;
+		
+		/**
+		 * \brief Gets the statistics so far, it can be called while the schedule runs
+		 * \return the statistics
+		 */
+		TimelapseStatistics getStatistics() const;
+		
+		/**
+		 * \brief Gets the slots which were skipped or failed so far
+		 * \return the slot numbers, in order
+		 */
+		std::vector<std::size_t> getMissedSlots() const;
+		
+		/**
+		 * \brief Computes the statistics of a set of trigger delays
+		 * \param[in]	jitters	the delay of every trigger compared to its planned time
+		 * \return the statistics, only the jitter members are filled
+		 */
+		static TimelapseStatistics computeJitterStatistics(std::vector<std::chrono::microseconds> jitters);
+		
+	private:
+		void run();
+		
+		CameraWrapper& m_cameraWrapper;
+		std::chrono::milliseconds m_interval;
+		std::size_t m_frames;
+		CapturePipeline::FileHandler m_fileHandler;
+		std::chrono::milliseconds m_tolerance; // Guarded by m_mutex
+		
+		std::atomic<bool> m_running;
+		bool m_stopRequested;
+		std::thread m_thread;
+		
+		mutable std::mutex m_mutex;
+		std::condition_variable m_stopCondition;
+		
+		std::vector<std::chrono::microseconds> m_jitters;
+		std::vector<std::size_t> m_missedSlots;
+		std::size_t m_failed;
+	};
+}
+
+#endif // TIMELAPSESCHEDULER_HPP
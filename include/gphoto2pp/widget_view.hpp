@@ -0,0 +1,186 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#ifndef WIDGETVIEW_HPP
+#define WIDGETVIEW_HPP
+
+#include <string>
+
+namespace gphoto2
+{
+	// Forward declare the gphoto2 struct
+	struct _CameraWidget;
+}
+
+namespace gphoto2pp
+{
+	enum class CameraWidgetTypeWrapper : int;
+	
+	/**
+	 * \class WidgetView
+	 * A borrowed, non-owning handle to a node of a widget tree.
+	 * 
+	 * Every CameraWidgetWrapper copy, child lookup and destruction walks up to the root of the tree and adds or removes a reference. A WidgetView does neither, it is just the pointer, which makes it the right tool to traverse and read a tree.
+	 * 
+	 * The view does not keep the tree alive. It must not outlive the owning wrapper it came from (usually the WindowWidget returned by CameraWrapper::getConfig()). The strings it returns belong to gphoto2 and have the same lifetime. Use toWidget() to get an owning wrapper for a node that must be kept around.
+	 */
+	class WidgetView
+	{
+	friend class CameraWidgetWrapper;
+	
+	public:
+		/**
+		 * \brief Gets the raw resource
+		 * \return the gphoto2 CameraWidget struct
+		 */
+		gphoto2::_CameraWidget* getPtr() const;
+		
+		/**
+		 * \brief Gets the widget's name
+		 * \return the widget name, owned by gphoto2
+		 * \note Direct wrapper for gp_widget_get_name(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		char const * getName() const;
+		
+		/**
+		 * \brief Gets the widget's type
+		 * \return the widget type
+		 * \note Direct wrapper for gp_widget_get_type(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		CameraWidgetTypeWrapper getType() const;
+		
+		/**
+		 * \brief Gets the widget's label
+		 * \return the widget label, owned by gphoto2
+		 * \note Direct wrapper for gp_widget_get_label(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		char const * getLabel() const;
+		
+		/**
+		 * \brief Gets the widget's info
+		 * \return the widget info, owned by gphoto2
+		 * \note Direct wrapper for gp_widget_get_info(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		char const * getInfo() const;
+		
+		/**
+		 * \brief Gets the widget's unique id
+		 * \return the widget's id
+		 * \note Direct wrapper for gp_widget_get_id(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int getId() const;
+		
+		/**
+		 * \brief Checks if the camera allows the widget to be changed
+		 * \return true if the widget is read only
+		 * \note Direct wrapper for gp_widget_get_readonly(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		bool isReadOnly() const;
+		
+		/**
+		 * \brief Checks if the widget is flagged as changed, and so written by the next CameraWrapper::setConfig(...)
+		 * \return true if the widget is flagged as changed
+		 * \note Direct wrapper for gp_widget_changed(...)
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		bool isChanged() const;
+		
+		/**
+		 * \brief Gets the number of children to this widget, which is 0 for leaf widgets
+		 * \return the number of children
+		 * \note Direct wrapper for <tt>gp_widget_count_children(...)</tt>
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int countChildren() const;
+		
+		/**
+		 * \brief Gets the child widget at the specified index.
+		 * \param[in]	index	of the child widget to get
+		 * \return the child's view
+		 * \note Direct wrapper for <tt>gp_widget_get_child(...)</tt>
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		WidgetView getChild(int index) const;
+		
+		/**
+		 * \brief Gets the child widget that matches the name.
+		 * \param[in]	name	of the child widget to get
+		 * \return the child's view
+		 * \note Direct wrapper for <tt>gp_widget_get_child_by_name(...)</tt>
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		WidgetView getChildByName(std::string const & name) const;
+		
+		/**
+		 * \brief Gets the value of a Text, Radio or Menu widget
+		 * \return the value, owned by gphoto2 (can be nullptr if the widget has no value)
+		 * \note Direct wrapper for <tt>gp_widget_get_value(...)</tt>
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		char const * getStringValue() const;
+		
+		/**
+		 * \brief Gets the value of a Toggle or Date widget
+		 * \return the value
+		 * \note Direct wrapper for <tt>gp_widget_get_value(...)</tt>
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		int getIntValue() const;
+		
+		/**
+		 * \brief Gets the value of a Range widget
+		 * \return the value
+		 * \note Direct wrapper for <tt>gp_widget_get_value(...)</tt>
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		float getFloatValue() const;
+		
+		/**
+		 * \brief Creates an owning wrapper for this widget, which adds a reference to the tree.
+		 * \tparam T type that inherits from CameraWidgetWrapper
+		 * \return the widget
+		 * \throw GPhoto2pp::exceptions::InvalidWidgetType if the widget is not of type T
+		 * \throw GPhoto2pp::exceptions::gphoto2_exception
+		 */
+		template<typename T>
+		T toWidget() const
+		{
+			return T(m_cameraWidget);
+		}
+		
+	private:
+		WidgetView(gphoto2::_CameraWidget* cameraWidget);
+		
+		gphoto2::_CameraWidget* m_cameraWidget;
+	};
+}
+
+#endif // WIDGETVIEW_HPP
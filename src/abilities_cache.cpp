@@ -0,0 +1,319 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#define FILELOG_SUBSYSTEM logsysDETECT
+
+#include <gphoto2pp/abilities_cache.hpp>
+
+#include <gphoto2pp/camera_abilities_list_wrapper.hpp>
+#include <gphoto2pp/helper_gphoto2.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gphoto2
+{
+#include <gphoto2/gphoto2-abilities-list.h>
+#include <gphoto2/gphoto2-version.h>
+}
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		// Layout: magic, format version, sizeof(CameraAbilities), key length, key, count, then count raw CameraAbilities structs
+		char const abilitiesCacheMagic[4] = {'G','P','A','C'};
+		std::uint32_t const abilitiesCacheVersion = 1;
+		
+		void abilitiesCacheWriteUInt(std::ostream& output, std::uint32_t value)
+		{
+			char const bytes[4] = {
+				static_cast<char>(value & 0xFF),
+				static_cast<char>((value >> 8) & 0xFF),
+				static_cast<char>((value >> 16) & 0xFF),
+				static_cast<char>((value >> 24) & 0xFF)};
+			output.write(bytes, 4);
+		}
+		
+		bool abilitiesCacheReadUInt(unsigned char const *& position, unsigned char const * end, std::uint32_t& value)
+		{
+			if(end - position < 4)
+			{
+				return false;
+			}
+			
+			value = static_cast<std::uint32_t>(position[0])
+				| (static_cast<std::uint32_t>(position[1]) << 8)
+				| (static_cast<std::uint32_t>(position[2]) << 16)
+				| (static_cast<std::uint32_t>(position[3]) << 24);
+			position += 4;
+			return true;
+		}
+		
+		// Read only mapping of a whole file, released when going out of scope
+		class MappedCacheFile
+		{
+		public:
+			explicit MappedCacheFile(std::string const & path)
+				: m_data{nullptr}
+				, m_size{0}
+			{
+				int fd = ::open(path.c_str(), O_RDONLY);
+				if(fd < 0)
+				{
+					return;
+				}
+				
+				struct stat fileStat;
+				if(::fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+				{
+					void* data = ::mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+					if(data != MAP_FAILED)
+					{
+						m_data = data;
+						m_size = static_cast<std::size_t>(fileStat.st_size);
+					}
+				}
+				
+				// The mapping stays valid without the descriptor
+				::close(fd);
+			}
+			
+			~MappedCacheFile()
+			{
+				if(m_data != nullptr)
+				{
+					::munmap(m_data, m_size);
+				}
+			}
+			
+			MappedCacheFile(MappedCacheFile const & other) = delete;
+			MappedCacheFile& operator=(MappedCacheFile const & other) = delete;
+			
+			unsigned char const * begin() const { return static_cast<unsigned char const *>(m_data); }
+			unsigned char const * end() const { return begin() + m_size; }
+			bool isMapped() const { return m_data != nullptr; }
+			
+		private:
+			void* m_data;
+			std::size_t m_size;
+		};
+	}
+	
+	AbilitiesCache::AbilitiesCache(std::string cacheFile, std::vector<std::string> driverDirectories)
+		: m_cacheFile{std::move(cacheFile)}
+		, m_driverDirectories{std::move(driverDirectories)}
+	{
+		char const * camlibs = std::getenv("CAMLIBS");
+		if(camlibs != nullptr && camlibs[0] != '\0')
+		{
+			m_driverDirectories.emplace_back(camlibs);
+		}
+		
+		if(m_driverDirectories.empty())
+		{
+			FILE_LOG(logWARN) << "AbilitiesCache without driver directories, only a library upgrade will invalidate '" << m_cacheFile << "'";
+		}
+	}
+	
+	std::string const & AbilitiesCache::getCacheFile() const
+	{
+		return m_cacheFile;
+	}
+	
+	std::vector<std::string> const & AbilitiesCache::getDriverDirectories() const
+	{
+		return m_driverDirectories;
+	}
+	
+	std::string AbilitiesCache::computeKey() const
+	{
+		std::ostringstream key;
+		
+		char const ** version = gphoto2::gp_library_version(gphoto2::GP_VERSION_SHORT);
+		key << "libgphoto2 " << ((version != nullptr && version[0] != nullptr) ? version[0] : "unknown");
+		key << ";abilities " << sizeof(gphoto2::CameraAbilities);
+		
+		for(auto const & directory : m_driverDirectories)
+		{
+			struct stat directoryStat;
+			key << ";" << directory << "=";
+			
+			if(::stat(directory.c_str(), &directoryStat) == 0)
+			{
+				key << static_cast<long long>(directoryStat.st_mtime);
+			}
+			else
+			{
+				key << "missing";
+			}
+		}
+		
+		return key.str();
+	}
+	
+	bool AbilitiesCache::load(CameraAbilitiesListWrapper& abilitiesList) const
+	{
+		detail::MappedCacheFile file(m_cacheFile);
+		if(!file.isMapped())
+		{
+			FILE_LOG(logDEBUG) << "AbilitiesCache load - no cache file '" << m_cacheFile << "'";
+			return false;
+		}
+		
+		auto position = file.begin();
+		auto const end = file.end();
+		
+		std::uint32_t version = 0, structSize = 0, keyLength = 0, count = 0;
+		
+		if(end - position < 4 || std::memcmp(position, detail::abilitiesCacheMagic, 4) != 0)
+		{
+			FILE_LOG(logWARN) << "AbilitiesCache load - '" << m_cacheFile << "' is not an abilities cache";
+			return false;
+		}
+		position += 4;
+		
+		if(!detail::abilitiesCacheReadUInt(position, end, version) || version != detail::abilitiesCacheVersion
+			|| !detail::abilitiesCacheReadUInt(position, end, structSize) || structSize != sizeof(gphoto2::CameraAbilities)
+			|| !detail::abilitiesCacheReadUInt(position, end, keyLength) || static_cast<std::size_t>(end - position) < keyLength)
+		{
+			FILE_LOG(logINFO) << "AbilitiesCache load - '" << m_cacheFile << "' has an incompatible layout";
+			return false;
+		}
+		
+		std::string const key(reinterpret_cast<char const *>(position), keyLength);
+		position += keyLength;
+		
+		if(key != computeKey())
+		{
+			FILE_LOG(logINFO) << "AbilitiesCache load - '" << m_cacheFile << "' is stale";
+			return false;
+		}
+		
+		if(!detail::abilitiesCacheReadUInt(position, end, count) || static_cast<std::size_t>(end - position) != static_cast<std::size_t>(count) * structSize)
+		{
+			FILE_LOG(logWARN) << "AbilitiesCache load - '" << m_cacheFile << "' is truncated";
+			return false;
+		}
+		
+		// A failure leaves the list half filled, it is emptied so the caller loads the drivers instead
+		try
+		{
+			for(std::uint32_t i = 0; i < count; ++i)
+			{
+				// Copied out since the mapping gives no alignment guarantee
+				gphoto2::CameraAbilities abilities;
+				std::memcpy(&abilities, position, structSize);
+				position += structSize;
+				
+				gphoto2pp::checkResponse(gphoto2::gp_abilities_list_append(abilitiesList.getPtr(), abilities),"gp_abilities_list_append");
+			}
+		}
+		catch(std::exception const & e)
+		{
+			FILE_LOG(logWARN) << "AbilitiesCache load - failed filling the list from '" << m_cacheFile << "': " << e.what();
+			gphoto2pp::checkResponseSilent(gphoto2::gp_abilities_list_reset(abilitiesList.getPtr()),"gp_abilities_list_reset");
+			return false;
+		}
+		
+		FILE_LOG(logINFO) << "AbilitiesCache load - " << count << " models from '" << m_cacheFile << "'";
+		
+		return true;
+	}
+	
+	bool AbilitiesCache::save(CameraAbilitiesListWrapper const & abilitiesList) const
+	{
+		// Written next to the real file then renamed over it, so a concurrent reader never maps a partial file
+		std::ostringstream temporaryName;
+		temporaryName << m_cacheFile << ".tmp." << ::getpid();
+		std::string const temporaryFile = temporaryName.str();
+		
+		// The output is closed before the catch runs, so the partial file can be removed
+		try
+		{
+			std::ofstream output(temporaryFile, std::ios::binary | std::ios::trunc);
+			if(!output)
+			{
+				FILE_LOG(logWARN) << "AbilitiesCache save - can't write '" << temporaryFile << "'";
+				return false;
+			}
+			
+			std::string const key = computeKey();
+			int const count = abilitiesList.count();
+			
+			output.write(detail::abilitiesCacheMagic, 4);
+			detail::abilitiesCacheWriteUInt(output, detail::abilitiesCacheVersion);
+			detail::abilitiesCacheWriteUInt(output, sizeof(gphoto2::CameraAbilities));
+			detail::abilitiesCacheWriteUInt(output, static_cast<std::uint32_t>(key.size()));
+			output.write(key.data(), key.size());
+			detail::abilitiesCacheWriteUInt(output, static_cast<std::uint32_t>(count));
+			
+			for(int i = 0; i < count; ++i)
+			{
+				gphoto2::CameraAbilities abilities;
+				gphoto2pp::checkResponse(gphoto2::gp_abilities_list_get_abilities(abilitiesList.getPtr(), i, &abilities),"gp_abilities_list_get_abilities");
+				output.write(reinterpret_cast<char const *>(&abilities), sizeof(abilities));
+			}
+			
+			if(!output.flush())
+			{
+				FILE_LOG(logWARN) << "AbilitiesCache save - failed writing '" << temporaryFile << "'";
+				output.close();
+				std::remove(temporaryFile.c_str());
+				return false;
+			}
+		}
+		catch(std::exception const & e)
+		{
+			FILE_LOG(logWARN) << "AbilitiesCache save - failed writing '" << temporaryFile << "': " << e.what();
+			std::remove(temporaryFile.c_str());
+			return false;
+		}
+		
+		if(std::rename(temporaryFile.c_str(), m_cacheFile.c_str()) != 0)
+		{
+			FILE_LOG(logWARN) << "AbilitiesCache save - can't replace '" << m_cacheFile << "'";
+			std::remove(temporaryFile.c_str());
+			return false;
+		}
+		
+		FILE_LOG(logINFO) << "AbilitiesCache save - wrote '" << m_cacheFile << "'";
+		
+		return true;
+	}
+}
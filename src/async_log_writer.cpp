@@ -0,0 +1,368 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <gphoto2pp/async_log_writer.hpp>
+
+#include <gphoto2pp/exceptions.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		struct AsyncLogRecord
+		{
+			std::chrono::system_clock::time_point Time;
+			TLogLevel Level;
+			TLogSubsystem Subsystem;
+			std::size_t Length;
+			bool Truncated;
+			char Text[AsyncLogWriter::MaxMessageLength];
+		};
+		
+		// Written by one logging thread and read by the writer thread, the indices only grow
+		class AsyncLogRing
+		{
+		public:
+			explicit AsyncLogRing(std::size_t capacity)
+				: m_records(capacity)
+				, m_head{0}
+				, m_tail{0}
+			{
+			}
+			
+			// Logging thread: the record to fill, or null if the ring is full
+			AsyncLogRecord* beginPush()
+			{
+				auto const head = m_head.load(std::memory_order_relaxed);
+				
+				if(head - m_tail.load(std::memory_order_acquire) == m_records.size())
+				{
+					return nullptr;
+				}
+				
+				return &m_records[head % m_records.size()];
+			}
+			
+			void endPush()
+			{
+				m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			}
+			
+			// Writer thread: the records pushed so far stay valid until they are released
+			std::size_t peek(std::vector<AsyncLogRecord const *>& records) const
+			{
+				auto const tail = m_tail.load(std::memory_order_relaxed);
+				auto const head = m_head.load(std::memory_order_acquire);
+				
+				for(auto index = tail; index != head; ++index)
+				{
+					records.push_back(&m_records[index % m_records.size()]);
+				}
+				
+				return head - tail;
+			}
+			
+			void release(std::size_t count)
+			{
+				m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+			}
+			
+		private:
+			std::vector<AsyncLogRecord> m_records;
+			std::atomic<std::size_t> m_head;
+			std::atomic<std::size_t> m_tail;
+		};
+		
+		// The calling thread's ring, created for each writer on the thread's first message
+		struct AsyncLogThreadRing
+		{
+			std::shared_ptr<AsyncLogRing> Ring;
+			std::uint64_t Generation;
+		};
+		
+		thread_local AsyncLogThreadRing asyncLogThreadRing{nullptr, 0};
+		
+		std::atomic<AsyncLogWriter*> asyncLogWriter{nullptr};
+		std::atomic<int> asyncLogProducers{0};
+		std::atomic<std::uint64_t> asyncLogGenerations{0};
+		
+		// Same format as NowTime(), but for the time the message was logged
+		void appendAsyncLogTime(std::string& buffer, std::chrono::system_clock::time_point time)
+		{
+			auto const t = std::chrono::system_clock::to_time_t(time);
+			auto const milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+			
+			tm r = {};
+			char clock[11];
+			std::strftime(clock, sizeof(clock), "%X", localtime_r(&t, &r));
+			
+			char result[32];
+			int const length = std::snprintf(result, sizeof(result), "%s.%03ld", clock, static_cast<long>(milliseconds));
+			buffer.append(result, std::max(0, std::min<int>(length, sizeof(result) - 1)));
+		}
+	}
+	
+	AsyncLogWriter::AsyncLogWriter(std::size_t recordsPerThread, std::chrono::milliseconds flushInterval)
+		: m_recordsPerThread{std::max<std::size_t>(recordsPerThread, 1)}
+		, m_flushInterval{flushInterval}
+		, m_generation{++detail::asyncLogGenerations}
+		, m_ringsMutex{}
+		, m_rings{}
+		, m_written{0}
+		, m_dropped{0}
+		, m_droppedReported{0}
+		, m_buffer{}
+		, m_mutex{}
+		, m_wakeup{}
+		, m_batchWritten{}
+		, m_stop{false}
+		, m_flushRequested{false}
+		, m_batchesStarted{0}
+		, m_batchesWritten{0}
+		, m_thread{}
+	{
+		AsyncLogWriter* expected = nullptr;
+		if(!detail::asyncLogWriter.compare_exchange_strong(expected, this))
+		{
+			throw exceptions::GPhoto2ppException("An AsyncLogWriter is already installed");
+		}
+		
+		m_thread = std::thread(&AsyncLogWriter::run, this);
+		
+		Output2FILE::Sink().store(&AsyncLogWriter::sink, std::memory_order_release);
+	}
+	
+	AsyncLogWriter::~AsyncLogWriter()
+	{
+		// Messages started from now on are written directly again
+		Output2FILE::Sink().store(nullptr, std::memory_order_release);
+		detail::asyncLogWriter.store(nullptr);
+		
+		// A message already handed to the sink may still be pushing into its ring
+		while(detail::asyncLogProducers.load() != 0)
+		{
+			std::this_thread::yield();
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stop = true;
+		}
+		m_wakeup.notify_all();
+		
+		// The thread writes what is left before it returns
+		m_thread.join();
+	}
+	
+	void AsyncLogWriter::flush()
+	{
+		std::unique_lock<std::mutex> lock{m_mutex};
+		
+		// Only a batch starting after this point is sure to see the messages logged before the call
+		auto const batch = m_batchesStarted + 1;
+		m_flushRequested = true;
+		m_wakeup.notify_all();
+		
+		m_batchWritten.wait(lock, [this, batch] { return m_batchesWritten >= batch || m_stop; });
+	}
+	
+	std::uint64_t AsyncLogWriter::getWrittenCount() const
+	{
+		return m_written.load(std::memory_order_relaxed);
+	}
+	
+	std::uint64_t AsyncLogWriter::getDroppedCount() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+	
+	void AsyncLogWriter::sink(TLogLevel level, TLogSubsystem subsystem, std::ostringstream& message)
+	{
+		// The count lets the destructor wait for us, after it has uninstalled the writer
+		++detail::asyncLogProducers;
+		
+		if(auto writer = detail::asyncLogWriter.load())
+		{
+			writer->push(level, subsystem, message);
+		}
+		else
+		{
+			// The writer went away between the message's start and its end, so it has no prefix yet
+			std::ostringstream prefixed;
+			prefixed << "- " << NowTime() << " " << FILELog::ToString(level) << ": " << message.str() << std::endl;
+			Output2FILE::Output(prefixed.str());
+		}
+		
+		--detail::asyncLogProducers;
+	}
+	
+	void AsyncLogWriter::push(TLogLevel level, TLogSubsystem subsystem, std::ostringstream& message)
+	{
+		auto& threadRing = detail::asyncLogThreadRing;
+		
+		if(threadRing.Generation != m_generation)
+		{
+			threadRing.Ring = std::make_shared<detail::AsyncLogRing>(m_recordsPerThread);
+			threadRing.Generation = m_generation;
+			
+			std::lock_guard<std::mutex> lock{m_ringsMutex};
+			m_rings.push_back(threadRing.Ring);
+		}
+		
+		auto record = threadRing.Ring->beginPush();
+		if(record == nullptr)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		
+		record->Time = std::chrono::system_clock::now();
+		record->Level = level;
+		record->Subsystem = subsystem;
+		
+		// Read straight out of the stream's buffer, without making a string of it
+		auto buffer = message.rdbuf();
+		record->Length = static_cast<std::size_t>(std::max<std::streamsize>(0, buffer->sgetn(record->Text, sizeof(record->Text))));
+		record->Truncated = buffer->in_avail() > 0;
+		
+		threadRing.Ring->endPush();
+	}
+	
+	void AsyncLogWriter::run()
+	{
+		std::unique_lock<std::mutex> lock{m_mutex};
+		
+		while(!m_stop)
+		{
+			m_wakeup.wait_for(lock, m_flushInterval, [this] { return m_stop || m_flushRequested; });
+			
+			m_flushRequested = false;
+			++m_batchesStarted;
+			
+			lock.unlock();
+			writeBatch();
+			lock.lock();
+			
+			++m_batchesWritten;
+			m_batchWritten.notify_all();
+		}
+		
+		// No more messages can come in, the last batch takes everything left
+		lock.unlock();
+		writeBatch();
+	}
+	
+	void AsyncLogWriter::writeBatch()
+	{
+		std::vector<std::shared_ptr<detail::AsyncLogRing>> rings;
+		{
+			std::lock_guard<std::mutex> lock{m_ringsMutex};
+			rings = m_rings;
+		}
+		
+		std::vector<detail::AsyncLogRecord const *> records;
+		std::vector<std::size_t> counts;
+		counts.reserve(rings.size());
+		
+		for(auto const & ring : rings)
+		{
+			counts.push_back(ring->peek(records));
+		}
+		
+		// Each ring is in order, the threads are merged by time
+		std::stable_sort(records.begin(), records.end(), [] (detail::AsyncLogRecord const * left, detail::AsyncLogRecord const * right)
+		{
+			return left->Time < right->Time;
+		});
+		
+		m_buffer.clear();
+		
+		for(auto record : records)
+		{
+			m_buffer.append("- ");
+			detail::appendAsyncLogTime(m_buffer, record->Time);
+			m_buffer.append(" ");
+			m_buffer.append(FILELog::ToString(record->Level));
+			m_buffer.append(": ");
+			
+			if(record->Subsystem != logsysGENERAL)
+			{
+				m_buffer.append("[");
+				m_buffer.append(FILELog::ToString(record->Subsystem));
+				m_buffer.append("] ");
+			}
+			
+			m_buffer.append(record->Text, record->Length);
+			
+			if(record->Truncated)
+			{
+				m_buffer.append(" [truncated]");
+			}
+			
+			m_buffer.append("\n");
+		}
+		
+		auto const dropped = m_dropped.load(std::memory_order_relaxed);
+		if(dropped != m_droppedReported)
+		{
+			m_buffer.append("- ");
+			detail::appendAsyncLogTime(m_buffer, std::chrono::system_clock::now());
+			m_buffer.append(" WARN: ");
+			m_buffer.append(std::to_string(dropped - m_droppedReported));
+			m_buffer.append(" log messages were dropped, a logging thread filled its ring\n");
+			m_droppedReported = dropped;
+		}
+		
+		if(!m_buffer.empty())
+		{
+			if(FILE* stream = Output2FILE::Stream())
+			{
+				std::fwrite(m_buffer.data(), 1, m_buffer.size(), stream);
+				std::fflush(stream);
+			}
+		}
+		
+		for(std::size_t i = 0; i < rings.size(); ++i)
+		{
+			rings[i]->release(counts[i]);
+		}
+		
+		m_written.fetch_add(records.size(), std::memory_order_relaxed);
+		
+		rings.clear();
+		
+		// The ring of a thread which has exited is only owned here, it can go once it's empty
+		std::lock_guard<std::mutex> lock{m_ringsMutex};
+		m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [] (std::shared_ptr<detail::AsyncLogRing> const & ring)
+		{
+			std::vector<detail::AsyncLogRecord const *> left;
+			return ring.use_count() == 1 && ring->peek(left) == 0;
+		}), m_rings.end());
+	}
+}
@@ -22,8 +22,11 @@
  * If not, see http://www.gnu.org/licenses
  */
 
+#define FILELOG_SUBSYSTEM logsysDETECT
+
 #include <gphoto2pp/camera_abilities_list_wrapper.hpp>
 
+#include <gphoto2pp/abilities_cache.hpp>
 #include <gphoto2pp/helper_gphoto2.hpp>
 #include <gphoto2pp/helper_context.hpp>
 #include <gphoto2pp/camera_list_wrapper.hpp>
@@ -31,6 +34,9 @@
 
 #include <gphoto2pp/log.h>
 
+#include <memory>
+#include <mutex>
+
 namespace gphoto2
 {
 #include <gphoto2/gphoto2-abilities-list.h>
@@ -38,17 +44,79 @@ namespace gphoto2
 
 namespace gphoto2pp
 {
+	namespace detail
+	{
+		// Configuration of the shared list, only read once when it is created
+		struct SharedAbilitiesState
+		{
+			std::mutex Mutex;
+			std::unique_ptr<AbilitiesCache> Cache;
+			bool Loaded = false;
+		};
+		
+		SharedAbilitiesState& sharedAbilitiesState()
+		{
+			static SharedAbilitiesState state;
+			return state;
+		}
+		
+		CameraAbilitiesListWrapper createSharedAbilitiesList()
+		{
+			auto& state = sharedAbilitiesState();
+			std::lock_guard<std::mutex> lock(state.Mutex);
+			
+			state.Loaded = true;
+			
+			if(state.Cache)
+			{
+				return CameraAbilitiesListWrapper(*state.Cache);
+			}
+			
+			return CameraAbilitiesListWrapper();
+		}
+	}
 
 	CameraAbilitiesListWrapper::CameraAbilitiesListWrapper()
 		: m_cameraAbilitiesList{nullptr}
+		, m_loadStatistics{std::chrono::microseconds::zero(), false}
 	{
 		FILE_LOG(logINFO) << "CameraAbilitiesListWrapper Constructor";
 		
+		auto const start = std::chrono::steady_clock::now();
+		
 		gphoto2pp::checkResponse(gphoto2::gp_abilities_list_new(&m_cameraAbilitiesList),"gp_abilities_list_new");
 		
 		auto spContext = gphoto2pp::getContext();
 		
 		gphoto2pp::checkResponse(gphoto2::gp_abilities_list_load(m_cameraAbilitiesList, spContext.get()),"gp_abilities_list_load");
+		
+		m_loadStatistics.Duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	}
+	
+	CameraAbilitiesListWrapper::CameraAbilitiesListWrapper(AbilitiesCache const & cache)
+		: m_cameraAbilitiesList{nullptr}
+		, m_loadStatistics{std::chrono::microseconds::zero(), false}
+	{
+		FILE_LOG(logINFO) << "CameraAbilitiesListWrapper Constructor - cache '" << cache.getCacheFile() << "'";
+		
+		auto const start = std::chrono::steady_clock::now();
+		
+		gphoto2pp::checkResponse(gphoto2::gp_abilities_list_new(&m_cameraAbilitiesList),"gp_abilities_list_new");
+		
+		m_loadStatistics.FromCache = cache.load(*this);
+		
+		if(!m_loadStatistics.FromCache)
+		{
+			auto spContext = gphoto2pp::getContext();
+			
+			gphoto2pp::checkResponse(gphoto2::gp_abilities_list_load(m_cameraAbilitiesList, spContext.get()),"gp_abilities_list_load");
+			
+			cache.save(*this);
+		}
+		
+		m_loadStatistics.Duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		
+		FILE_LOG(logINFO) << "CameraAbilitiesListWrapper loaded in " << m_loadStatistics.Duration.count() << "us" << (m_loadStatistics.FromCache ? " from cache" : "");
 	}
 
 	CameraAbilitiesListWrapper::~CameraAbilitiesListWrapper()
@@ -64,6 +132,7 @@ namespace gphoto2pp
 	
 	CameraAbilitiesListWrapper::CameraAbilitiesListWrapper(CameraAbilitiesListWrapper&& other)
 		: m_cameraAbilitiesList{other.m_cameraAbilitiesList}
+		, m_loadStatistics(other.m_loadStatistics)
 	{
 		FILE_LOG(logINFO) << "CameraAbilitiesListWrapper move Constructor";
 		
@@ -85,6 +154,7 @@ namespace gphoto2pp
 			
 			// Steal or "move" the other objects resource
 			m_cameraAbilitiesList = other.m_cameraAbilitiesList;
+			m_loadStatistics = other.m_loadStatistics;
 			
 			// Unreference the other objects resource, so it's destructor doesn't unreference it
 			other.m_cameraAbilitiesList = nullptr;
@@ -92,12 +162,40 @@ namespace gphoto2pp
 		return *this;
 	}
 	
+	CameraAbilitiesListWrapper const & CameraAbilitiesListWrapper::getShared()
+	{
+		// C++11 guarantees this is only initialized once, even with concurrent callers
+		static CameraAbilitiesListWrapper const sharedAbilitiesList(detail::createSharedAbilitiesList());
+		
+		return sharedAbilitiesList;
+	}
+	
+	bool CameraAbilitiesListWrapper::setSharedCache(AbilitiesCache cache)
+	{
+		auto& state = detail::sharedAbilitiesState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		
+		if(state.Loaded)
+		{
+			FILE_LOG(logWARN) << "CameraAbilitiesListWrapper setSharedCache - the shared list is already loaded";
+			return false;
+		}
+		
+		state.Cache.reset(new AbilitiesCache(std::move(cache)));
+		return true;
+	}
+	
+	AbilitiesLoadStatistics const & CameraAbilitiesListWrapper::getLoadStatistics() const
+	{
+		return m_loadStatistics;
+	}
+	
 	gphoto2::_CameraAbilitiesList* CameraAbilitiesListWrapper::getPtr() const
 	{
 		return m_cameraAbilitiesList;
 	}
 
-	CameraListWrapper CameraAbilitiesListWrapper::listDetect(GPPortInfoListWrapper const & portInfoList)
+	CameraListWrapper CameraAbilitiesListWrapper::listDetect(GPPortInfoListWrapper const & portInfoList) const
 	{
 		auto spContext = gphoto2pp::getContext();
 		CameraListWrapper cameraList;
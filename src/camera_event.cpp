@@ -0,0 +1,117 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#include <gphoto2pp/camera_event.hpp>
+
+#include <gphoto2pp/property_changed_event.hpp>
+
+namespace gphoto2pp
+{
+	CameraEvent::CameraEvent(CameraEventTypeWrapper type)
+		: m_type{type}
+		, m_payload{Payload::None}
+		, m_propertyCode{0}
+		, m_first{}
+		, m_second{}
+	{
+	}
+	
+	CameraEvent::CameraEvent(CameraEventTypeWrapper type, char const * folder, char const * name)
+		: m_type{type}
+		, m_payload{Payload::FilePath}
+		, m_propertyCode{0}
+		, m_first{}
+		, m_second{}
+	{
+		m_first.assign(folder);
+		m_second.assign(name);
+	}
+	
+	CameraEvent::CameraEvent(char const * text)
+		: m_type{CameraEventTypeWrapper::Unknown}
+		, m_payload{Payload::Text}
+		, m_propertyCode{0}
+		, m_first{}
+		, m_second{}
+	{
+		m_first.assign(text);
+		
+		if(!parsePropertyCode(text, m_propertyCode))
+		{
+			m_propertyCode = 0;
+		}
+	}
+	
+	CameraEventTypeWrapper CameraEvent::getType() const
+	{
+		return m_type;
+	}
+	
+	bool CameraEvent::hasFilePath() const
+	{
+		return m_payload == Payload::FilePath;
+	}
+	
+	char const * CameraEvent::getFolder() const
+	{
+		return m_payload == Payload::FilePath ? m_first.c_str() : "";
+	}
+	
+	char const * CameraEvent::getName() const
+	{
+		return m_payload == Payload::FilePath ? m_second.c_str() : "";
+	}
+	
+	bool CameraEvent::hasText() const
+	{
+		return m_payload == Payload::Text;
+	}
+	
+	char const * CameraEvent::getText() const
+	{
+		return m_payload == Payload::Text ? m_first.c_str() : "";
+	}
+	
+	bool CameraEvent::isPropertyChanged() const
+	{
+		return m_payload == Payload::Text && m_propertyCode != 0;
+	}
+	
+	int CameraEvent::getPropertyCode() const
+	{
+		return m_propertyCode;
+	}
+	
+	CameraFilePathWrapper CameraEvent::toFilePath() const
+	{
+		return CameraFilePathWrapper{getName(), getFolder()};
+	}
+	
+	std::string CameraEvent::toText() const
+	{
+		return getText();
+	}
+}
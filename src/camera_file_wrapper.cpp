@@ -22,6 +22,8 @@
  * If not, see http://www.gnu.org/licenses
  */
 
+#define FILELOG_SUBSYSTEM logsysFILE
+
 #include <gphoto2pp/camera_file_wrapper.hpp>
 
 #include <gphoto2pp/helper_gphoto2.hpp>
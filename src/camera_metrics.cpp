@@ -0,0 +1,353 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/camera_metrics.hpp>
+
+#include <gphoto2pp/helper_gphoto2.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		// Label values may contain anything, the format only needs these escaped
+		std::string escapeMetricLabel(std::string const & value)
+		{
+			std::string escaped;
+			escaped.reserve(value.size());
+			
+			for(auto character : value)
+			{
+				switch(character)
+				{
+					case '\\':
+						escaped += "\\\\";
+						break;
+					case '"':
+						escaped += "\\\"";
+						break;
+					case '\n':
+						escaped += "\\n";
+						break;
+					default:
+						escaped += character;
+						break;
+				}
+			}
+			
+			return escaped;
+		}
+		
+		void appendMetricHeader(std::ostringstream& output, char const * name, char const * type, char const * help)
+		{
+			output << "# HELP " << name << " " << help << "\n";
+			output << "# TYPE " << name << " " << type << "\n";
+		}
+		
+		std::string cameraMetricLabels(CameraMetrics const & camera)
+		{
+			return "model=\"" + escapeMetricLabel(camera.getModel()) + "\",port=\"" + escapeMetricLabel(camera.getPort()) + "\"";
+		}
+	}
+	
+	CameraMetrics::CameraMetrics(std::string model, std::string port)
+		: m_model{std::move(model)}
+		, m_port{std::move(port)}
+		, m_captures{0}
+		, m_previewFrames{0}
+		, m_bytesDownloaded{0}
+		, m_reconnects{0}
+		, m_waitingCalls{0}
+		, m_errors{}
+	{
+		for(auto& errors : m_errors)
+		{
+			errors.store(0, std::memory_order_relaxed);
+		}
+	}
+	
+	std::string const & CameraMetrics::getModel() const
+	{
+		return m_model;
+	}
+	
+	std::string const & CameraMetrics::getPort() const
+	{
+		return m_port;
+	}
+	
+	void CameraMetrics::addCapture()
+	{
+		m_captures.fetch_add(1, std::memory_order_relaxed);
+	}
+	
+	void CameraMetrics::addPreviewFrame()
+	{
+		m_previewFrames.fetch_add(1, std::memory_order_relaxed);
+	}
+	
+	void CameraMetrics::addBytesDownloaded(std::uint64_t bytes)
+	{
+		m_bytesDownloaded.fetch_add(bytes, std::memory_order_relaxed);
+	}
+	
+	void CameraMetrics::addError(int resultCode)
+	{
+		m_errors[errorIndex(resultCode)].fetch_add(1, std::memory_order_relaxed);
+	}
+	
+	void CameraMetrics::addReconnect()
+	{
+		m_reconnects.fetch_add(1, std::memory_order_relaxed);
+	}
+	
+	void CameraMetrics::addWaitingCall()
+	{
+		m_waitingCalls.fetch_add(1, std::memory_order_relaxed);
+	}
+	
+	void CameraMetrics::removeWaitingCall()
+	{
+		m_waitingCalls.fetch_sub(1, std::memory_order_relaxed);
+	}
+	
+	std::uint64_t CameraMetrics::getCaptures() const
+	{
+		return m_captures.load(std::memory_order_relaxed);
+	}
+	
+	std::uint64_t CameraMetrics::getPreviewFrames() const
+	{
+		return m_previewFrames.load(std::memory_order_relaxed);
+	}
+	
+	std::uint64_t CameraMetrics::getBytesDownloaded() const
+	{
+		return m_bytesDownloaded.load(std::memory_order_relaxed);
+	}
+	
+	std::uint64_t CameraMetrics::getReconnects() const
+	{
+		return m_reconnects.load(std::memory_order_relaxed);
+	}
+	
+	std::int64_t CameraMetrics::getWaitingCalls() const
+	{
+		return m_waitingCalls.load(std::memory_order_relaxed);
+	}
+	
+	std::uint64_t CameraMetrics::getErrors(int resultCode) const
+	{
+		return m_errors[errorIndex(resultCode)].load(std::memory_order_relaxed);
+	}
+	
+	std::size_t CameraMetrics::errorIndex(int resultCode)
+	{
+		// Slot 0 holds the codes out of range (and 0 itself, which isn't an error)
+		return resultCode < 0 && resultCode > -static_cast<int>(ErrorCodeCount) ? static_cast<std::size_t>(-resultCode) : 0;
+	}
+	
+	MetricsRegistry& MetricsRegistry::getShared()
+	{
+		static MetricsRegistry registry;
+		return registry;
+	}
+	
+	MetricsRegistry::MetricsRegistry()
+		: m_mutex{}
+		, m_cameras{}
+	{
+	}
+	
+	std::shared_ptr<CameraMetrics> MetricsRegistry::connectCamera(std::string const & model, std::string const & port)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		auto& camera = m_cameras[std::make_pair(model, port)];
+		
+		if(camera)
+		{
+			camera->addReconnect();
+		}
+		else
+		{
+			camera = std::make_shared<CameraMetrics>(model, port);
+		}
+		
+		return camera;
+	}
+	
+	std::vector<std::shared_ptr<CameraMetrics const>> MetricsRegistry::getCameras() const
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		std::vector<std::shared_ptr<CameraMetrics const>> cameras;
+		cameras.reserve(m_cameras.size());
+		
+		for(auto const & camera : m_cameras)
+		{
+			cameras.push_back(camera.second);
+		}
+		
+		return cameras;
+	}
+	
+	std::string MetricsRegistry::renderPrometheus() const
+	{
+		auto const cameras = getCameras();
+		
+		std::vector<std::string> labels;
+		labels.reserve(cameras.size());
+		for(auto const & camera : cameras)
+		{
+			labels.push_back(detail::cameraMetricLabels(*camera));
+		}
+		
+		std::ostringstream output;
+		
+		auto const appendMetric = [&] (char const * name, char const * type, char const * help, std::int64_t (*value)(CameraMetrics const &))
+		{
+			detail::appendMetricHeader(output, name, type, help);
+			
+			for(std::size_t i = 0; i < cameras.size(); ++i)
+			{
+				output << name << "{" << labels[i] << "} " << value(*cameras[i]) << "\n";
+			}
+		};
+		
+		appendMetric("gphoto2pp_captures_total", "counter", "Images captured, with capture or triggerCapture", [] (CameraMetrics const & camera) { return static_cast<std::int64_t>(camera.getCaptures()); });
+		appendMetric("gphoto2pp_preview_frames_total", "counter", "Preview frames captured", [] (CameraMetrics const & camera) { return static_cast<std::int64_t>(camera.getPreviewFrames()); });
+		appendMetric("gphoto2pp_downloaded_bytes_total", "counter", "Bytes of the files downloaded with fileGet", [] (CameraMetrics const & camera) { return static_cast<std::int64_t>(camera.getBytesDownloaded()); });
+		appendMetric("gphoto2pp_reconnects_total", "counter", "Connections to a camera already connected before", [] (CameraMetrics const & camera) { return static_cast<std::int64_t>(camera.getReconnects()); });
+		appendMetric("gphoto2pp_waiting_calls", "gauge", "Calls waiting for the camera while another call uses it", [] (CameraMetrics const & camera) { return camera.getWaitingCalls(); });
+		
+		detail::appendMetricHeader(output, "gphoto2pp_camera_errors_total", "counter", "Failed camera calls, by gphoto2 result code");
+		for(std::size_t i = 0; i < cameras.size(); ++i)
+		{
+			for(std::size_t index = 0; index < CameraMetrics::ErrorCodeCount; ++index)
+			{
+				auto const resultCode = -static_cast<int>(index);
+				auto const errors = cameras[i]->getErrors(resultCode);
+				
+				if(errors != 0)
+				{
+					output << "gphoto2pp_camera_errors_total{" << labels[i] << ",code=\"" << (index == 0 ? std::string("other") : std::to_string(resultCode)) << "\"} " << errors << "\n";
+				}
+			}
+		}
+		
+		detail::appendMetricHeader(output, "gphoto2pp_response_errors_total", "counter", "Failed gphoto2 calls of any kind, by method and result code");
+		for(auto const & count : getResponseErrorCounts())
+		{
+			output << "gphoto2pp_response_errors_total{operation=\"" << detail::escapeMetricLabel(count.Operation) << "\",code=\"" << count.ResultCode << "\"} " << count.Count << "\n";
+		}
+		
+		return output.str();
+	}
+	
+	MetricsFileWriter::MetricsFileWriter(MetricsRegistry const & registry, std::string file, std::chrono::milliseconds interval)
+		: m_registry(registry)
+		, m_file{std::move(file)}
+		, m_interval{interval}
+		, m_writeMutex{}
+		, m_mutex{}
+		, m_stopCondition{}
+		, m_stopRequested{false}
+		, m_thread{}
+	{
+		m_thread = std::thread(&MetricsFileWriter::run, this);
+	}
+	
+	MetricsFileWriter::~MetricsFileWriter()
+	{
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stopRequested = true;
+		}
+		m_stopCondition.notify_all();
+		
+		if(m_thread.joinable())
+		{
+			m_thread.join();
+		}
+		
+		write();
+	}
+	
+	bool MetricsFileWriter::write() const
+	{
+		std::lock_guard<std::mutex> lock{m_writeMutex};
+		
+		// Written next to the real file then renamed over it, so a scraper never reads a partial file
+		std::ostringstream temporaryName;
+		temporaryName << m_file << ".tmp." << ::getpid();
+		std::string const temporaryFile = temporaryName.str();
+		
+		{
+			std::ofstream output(temporaryFile, std::ios::trunc);
+			output << m_registry.renderPrometheus();
+			output.flush();
+			
+			if(!output)
+			{
+				FILE_LOG(logWARN) << "MetricsFileWriter write - can't write '" << temporaryFile << "'";
+				std::remove(temporaryFile.c_str());
+				return false;
+			}
+		}
+		
+		if(std::rename(temporaryFile.c_str(), m_file.c_str()) != 0)
+		{
+			FILE_LOG(logWARN) << "MetricsFileWriter write - can't replace '" << m_file << "'";
+			std::remove(temporaryFile.c_str());
+			return false;
+		}
+		
+		return true;
+	}
+	
+	void MetricsFileWriter::run()
+	{
+		std::unique_lock<std::mutex> lock{m_mutex};
+		
+		do
+		{
+			// Rendering takes the registry's lock, not ours
+			lock.unlock();
+			write();
+			lock.lock();
+		}
+		while(!m_stopCondition.wait_for(lock, m_interval, [this]{ return m_stopRequested; }));
+	}
+}
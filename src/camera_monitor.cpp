@@ -0,0 +1,249 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#define FILELOG_SUBSYSTEM logsysDETECT
+
+#include <gphoto2pp/camera_monitor.hpp>
+
+#include <gphoto2pp/camera_abilities_list_wrapper.hpp>
+#include <gphoto2pp/camera_list_wrapper.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/gp_port_info_list_wrapper.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace gphoto2pp
+{
+	bool DetectedCamera::operator==(DetectedCamera const & other) const
+	{
+		return Model == other.Model && Port == other.Port;
+	}
+	
+	bool DetectedCamera::operator<(DetectedCamera const & other) const
+	{
+		return Model < other.Model || (Model == other.Model && Port < other.Port);
+	}
+	
+	CameraMonitor::CameraMonitor(std::chrono::milliseconds minInterval, std::chrono::milliseconds maxInterval)
+		: m_minInterval{minInterval}
+		, m_maxInterval{std::max(minInterval, maxInterval)}
+		, m_currentInterval{minInterval}
+		, m_running{false}
+		, m_stopRequested{false}
+		, m_thread{}
+		, m_mutex{}
+		, m_stopCondition{}
+		, m_cameras{}
+		, m_events{}
+	{
+	}
+	
+	CameraMonitor::~CameraMonitor()
+	{
+		stop();
+	}
+	
+	observer::Registration CameraMonitor::subscribe(CameraMonitorEvent const & event, std::function<void(DetectedCamera const &)> func)
+	{
+		return m_events.registerObserver(event, std::move(func));
+	}
+	
+	bool CameraMonitor::start()
+	{
+		if(m_thread.joinable())
+		{
+			FILE_LOG(logWARN1) << "CameraMonitor already started";
+			return false;
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stopRequested = false;
+			m_currentInterval = m_minInterval;
+			m_cameras.clear();
+		}
+		
+		m_running = true;
+		m_thread = std::thread(&CameraMonitor::run, this);
+		
+		return true;
+	}
+	
+	void CameraMonitor::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stopRequested = true;
+		}
+		m_stopCondition.notify_all();
+		
+		if(m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+	
+	bool CameraMonitor::isRunning() const
+	{
+		return m_running;
+	}
+	
+	std::vector<DetectedCamera> CameraMonitor::getCameras() const
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		return m_cameras;
+	}
+	
+	std::chrono::milliseconds CameraMonitor::getCurrentInterval() const
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		return m_currentInterval;
+	}
+	
+	std::vector<DetectedCamera> CameraMonitor::scan()
+	{
+		// The ports have to be enumerated every time, but the camera drivers are only loaded once
+		GPPortInfoListWrapper portInfoList;
+		
+		auto cameraList = CameraAbilitiesListWrapper::getShared().listDetect(portInfoList);
+		
+		std::vector<DetectedCamera> cameras;
+		cameras.reserve(cameraList.count());
+		
+		for(int i = 0; i < cameraList.count(); ++i)
+		{
+			auto pair = cameraList.getPair(i);
+			
+			// Same as autoDetectAll, the generic "usb:" entry isn't a camera
+			if(pair.second == "usb:")
+			{
+				continue;
+			}
+			
+			cameras.push_back(DetectedCamera{std::move(pair.first), std::move(pair.second)});
+		}
+		
+		std::sort(std::begin(cameras), std::end(cameras));
+		
+		return cameras;
+	}
+	
+	bool CameraMonitor::diff(std::vector<DetectedCamera> const & previous, std::vector<DetectedCamera> const & current, std::vector<DetectedCamera>& arrived, std::vector<DetectedCamera>& departed)
+	{
+		arrived.clear();
+		departed.clear();
+		
+		std::set_difference(std::begin(current), std::end(current), std::begin(previous), std::end(previous), std::back_inserter(arrived));
+		std::set_difference(std::begin(previous), std::end(previous), std::begin(current), std::end(current), std::back_inserter(departed));
+		
+		return !arrived.empty() || !departed.empty();
+	}
+	
+	void CameraMonitor::notify(CameraMonitorEvent event, DetectedCamera const & camera)
+	{
+		// Thrown on the monitor's thread, nobody could catch it and the process would terminate
+		try
+		{
+			m_events(event, camera);
+		}
+		catch(std::exception const & e)
+		{
+			FILE_LOG(logERROR) << "CameraMonitor subscriber failed for " << camera.Model << " on " << camera.Port << " - " << e.what();
+		}
+		catch(...)
+		{
+			FILE_LOG(logERROR) << "CameraMonitor subscriber failed for " << camera.Model << " on " << camera.Port;
+		}
+	}
+	
+	void CameraMonitor::run()
+	{
+		FILE_LOG(logINFO) << "CameraMonitor started";
+		
+		std::vector<DetectedCamera> arrived, departed;
+		
+		std::unique_lock<std::mutex> lock{m_mutex};
+		
+		while(!m_stopRequested)
+		{
+			auto const previous = m_cameras;
+			
+			lock.unlock();
+			
+			bool changed = false;
+			std::vector<DetectedCamera> current;
+			bool scanned = false;
+			
+			try
+			{
+				current = scan();
+				scanned = true;
+			}
+			catch(std::exception const & e)
+			{
+				// A failed scan says nothing about the cameras, so nothing is reported as departed
+				FILE_LOG(logERROR) << "CameraMonitor scan failed - " << e.what();
+			}
+			
+			if(scanned)
+			{
+				changed = diff(previous, current, arrived, departed);
+				
+				for(auto const & camera : departed)
+				{
+					FILE_LOG(logINFO) << "CameraMonitor departed - " << camera.Model << " on " << camera.Port;
+					notify(CameraMonitorEvent::CameraDeparted, camera);
+				}
+				
+				for(auto const & camera : arrived)
+				{
+					FILE_LOG(logINFO) << "CameraMonitor arrived - " << camera.Model << " on " << camera.Port;
+					notify(CameraMonitorEvent::CameraArrived, camera);
+				}
+			}
+			
+			lock.lock();
+			
+			if(scanned)
+			{
+				m_cameras = std::move(current);
+			}
+			
+			m_currentInterval = changed ? m_minInterval : std::min(m_currentInterval * 2, m_maxInterval);
+			
+			m_stopCondition.wait_for(lock, m_currentInterval, [this]{ return m_stopRequested; });
+		}
+		
+		m_running = false;
+		
+		FILE_LOG(logINFO) << "CameraMonitor stopped";
+	}
+}
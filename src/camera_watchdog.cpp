@@ -0,0 +1,244 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/camera_watchdog.hpp>
+
+#include <gphoto2pp/context_cancellation.hpp>
+
+#include <gphoto2pp/log.h>
+
+namespace gphoto2pp
+{
+	CameraWatchdog::Call::Call()
+		: m_watchdog{nullptr}
+		, m_id{0}
+	{
+	}
+	
+	CameraWatchdog::Call::Call(CameraWatchdog* watchdog, std::uint64_t id)
+		: m_watchdog{watchdog}
+		, m_id{id}
+	{
+	}
+	
+	CameraWatchdog::Call::~Call()
+	{
+		if(m_watchdog != nullptr)
+		{
+			m_watchdog->end(m_id);
+		}
+	}
+	
+	void CameraWatchdog::Call::locked() const
+	{
+		if(m_watchdog != nullptr)
+		{
+			m_watchdog->locked(m_id);
+		}
+	}
+	
+	CameraWatchdog::Call::Call(Call&& other)
+		: m_watchdog{other.m_watchdog}
+		, m_id{other.m_id}
+	{
+		other.m_watchdog = nullptr;
+	}
+	
+	CameraWatchdog::Call& CameraWatchdog::Call::operator=(Call&& other)
+	{
+		if(this != &other)
+		{
+			if(m_watchdog != nullptr)
+			{
+				m_watchdog->end(m_id);
+			}
+			
+			m_watchdog = other.m_watchdog;
+			m_id = other.m_id;
+			other.m_watchdog = nullptr;
+		}
+		return *this;
+	}
+	
+	CameraWatchdog::CameraWatchdog(std::chrono::milliseconds checkInterval)
+		: m_checkInterval{checkInterval}
+		, m_mutex{}
+		, m_stopCondition{}
+		, m_stopRequested{false}
+		, m_calls{}
+		, m_nextId{1}
+		, m_cameraHungEvents{}
+		, m_thread{}
+	{
+		m_thread = std::thread(&CameraWatchdog::run, this);
+	}
+	
+	CameraWatchdog::~CameraWatchdog()
+	{
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stopRequested = true;
+		}
+		m_stopCondition.notify_all();
+		
+		if(m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+	
+	CameraWatchdog::Call CameraWatchdog::begin(std::shared_ptr<std::string const> camera, char const * operation, std::chrono::steady_clock::time_point deadline, ContextCancellation* cancellation)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		auto const id = m_nextId++;
+		m_calls[id] = InFlightCall{std::move(camera), operation, std::chrono::steady_clock::now(), deadline, cancellation, false, false};
+		
+		return Call(this, id);
+	}
+	
+	CameraWatchdog::Call CameraWatchdog::begin(std::string camera, char const * operation, std::chrono::steady_clock::time_point deadline, ContextCancellation* cancellation)
+	{
+		return begin(std::make_shared<std::string const>(std::move(camera)), operation, deadline, cancellation);
+	}
+	
+	void CameraWatchdog::locked(std::uint64_t id)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		auto it = m_calls.find(id);
+		if(it != m_calls.end())
+		{
+			it->second.HoldsCamera = true;
+			
+			if(it->second.Cancellation != nullptr)
+			{
+				it->second.Cancellation->beginCall(id);
+			}
+		}
+	}
+	
+	void CameraWatchdog::end(std::uint64_t id)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		auto it = m_calls.find(id);
+		if(it != m_calls.end())
+		{
+			if(it->second.HoldsCamera && it->second.Cancellation != nullptr)
+			{
+				it->second.Cancellation->endCall(id);
+			}
+			
+			if(it->second.Reported)
+			{
+				FILE_LOG(logWARN) << "CameraWatchdog - " << it->second.Operation << " on " << *it->second.Camera << " returned after being reported hung";
+			}
+			
+			m_calls.erase(it);
+		}
+	}
+	
+	observer::Registration CameraWatchdog::subscribeToCameraHung(std::function<void(const CameraHungEvent&)> func)
+	{
+		return m_cameraHungEvents.registerObserver(std::move(func));
+	}
+	
+	std::size_t CameraWatchdog::getInFlightCount() const
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		return m_calls.size();
+	}
+	
+	void CameraWatchdog::run()
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::milliseconds;
+		
+		std::vector<CameraHungEvent> hungEvents;
+		
+		std::unique_lock<std::mutex> lock{m_mutex};
+		
+		while(!m_stopCondition.wait_for(lock, m_checkInterval, [this]{ return m_stopRequested; }))
+		{
+			auto const now = std::chrono::steady_clock::now();
+			
+			for(auto& entry : m_calls)
+			{
+				auto& call = entry.second;
+				
+				if(now < call.Deadline)
+				{
+					continue;
+				}
+				
+				// Cancelled on every check, since an operation starting its context scope resets an earlier cancel. The call can't end (and its camera can't be destroyed) while we hold the lock.
+				// A call still waiting for the camera's lock isn't cancelled, that would abort whichever call holds the camera. The context only cancels the call it is tagged with, in case the call just released the camera.
+				if(call.HoldsCamera && call.Cancellation != nullptr)
+				{
+					call.Cancellation->cancelCall(entry.first);
+				}
+				
+				if(!call.Reported)
+				{
+					call.Reported = true;
+					hungEvents.push_back(CameraHungEvent{*call.Camera, call.Operation, duration_cast<milliseconds>(now - call.Start), duration_cast<milliseconds>(call.Deadline - call.Start), call.HoldsCamera});
+				}
+			}
+			
+			if(!hungEvents.empty())
+			{
+				// The callbacks may call into the cameras, so they run without the lock
+				lock.unlock();
+				
+				for(auto const & hungEvent : hungEvents)
+				{
+					FILE_LOG(logERROR) << "CameraWatchdog - " << hungEvent.Operation << " on " << hungEvent.Camera << (hungEvent.HoldsCamera ? " is hung for " : " is still waiting for the camera after ") << hungEvent.Elapsed.count() << "ms";
+					
+					// Thrown on the watchdog's thread, nobody could catch it and the process would terminate
+					try
+					{
+						m_cameraHungEvents(hungEvent);
+					}
+					catch(std::exception const & e)
+					{
+						FILE_LOG(logERROR) << "CameraWatchdog - CameraHung subscriber failed: " << e.what();
+					}
+					catch(...)
+					{
+						FILE_LOG(logERROR) << "CameraWatchdog - CameraHung subscriber failed";
+					}
+				}
+				hungEvents.clear();
+				
+				lock.lock();
+			}
+		}
+	}
+}
@@ -170,6 +170,25 @@ namespace gphoto2pp
 		return CameraWidgetWrapper(getParentDefault());
 	}
 	
+	WidgetView CameraWidgetWrapper::getView() const
+	{
+		return WidgetView(m_cameraWidget);
+	}
+	
+	bool CameraWidgetWrapper::isReadOnly() const
+	{
+		int readonly = 0;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_readonly(m_cameraWidget, &readonly),"gp_widget_get_readonly");
+		
+		return readonly != 0;
+	}
+	
+	void CameraWidgetWrapper::setChanged(bool changed)
+	{
+		gphoto2pp::checkResponse(gphoto2::gp_widget_set_changed(m_cameraWidget, changed ? 1 : 0),"gp_widget_set_changed");
+	}
+	
 	gphoto2::_CameraWidget* CameraWidgetWrapper::getRootDefault() const
 	{
 		gphoto2::_CameraWidget* rootWidget = nullptr;
@@ -22,6 +22,8 @@
  * If not, see http://www.gnu.org/licenses
  */
 
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
 #include <gphoto2pp/camera_wrapper.hpp>
 
 #include <gphoto2pp/exceptions.hpp>
@@ -36,7 +38,14 @@
 #include <gphoto2pp/camera_file_wrapper.hpp>
 #include <gphoto2pp/camera_file_path_wrapper.hpp>
 #include <gphoto2pp/camera_event_type_wrapper.hpp>
+#include <gphoto2pp/camera_event.hpp>
 #include <gphoto2pp/camera_capture_type_wrapper.hpp>
+#include <gphoto2pp/property_changed_event.hpp>
+#include <gphoto2pp/config_snapshot.hpp>
+#include <gphoto2pp/config_cache.hpp>
+#include <gphoto2pp/context_progress.hpp>
+#include <gphoto2pp/context_cancellation.hpp>
+#include <gphoto2pp/camera_metrics.hpp>
 
 #include <gphoto2pp/log.h>
 
@@ -47,26 +56,41 @@ namespace gphoto2
 #include <gphoto2/gphoto2-abilities-list.h> // Only needed for the pre 2.5 initialize method (because _autodetect doesn't exist)
 #endif
 #include <gphoto2/gphoto2-file.h>
+#include <gphoto2/gphoto2-result.h>
 }
 
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <utility>
 
 namespace gphoto2pp
 {
-
 	CameraWrapper::CameraWrapper(std::string const & model, std::string const & port)
 		: m_camera{nullptr}
 		, m_context{gphoto2pp::getContext()}
 		, m_model{model}
 		, m_port{port}
 		, m_listenForEvents{false}
+		, m_configCache{new ConfigCache()}
+		, m_contextProgress{new ContextProgress()}
+		, m_contextCancellation{new ContextCancellation()}
+		, m_watchdog{}
+		, m_watchdogLabel{}
+		, m_operationDeadline{std::chrono::seconds(30)}
+		, m_latencies{new OperationLatencies()}
+		, m_metrics{}
 	{
 		FILE_LOG(logINFO) << "CameraWrapper Constructor - model[" << m_model.c_str() << "], port[" << m_port.c_str() << "]";
 		
+		m_contextProgress->attach(m_context);
+		m_contextCancellation->attach(m_context);
+		
 		gphoto2pp::checkResponse(gphoto2::gp_camera_new(&m_camera),"gp_camera_new");
 		
 		initialize(m_model, m_port);
+		
+		m_metrics = MetricsRegistry::getShared().connectCamera(m_model, m_port);
 	}
 
 	CameraWrapper::CameraWrapper()
@@ -75,12 +99,25 @@ namespace gphoto2pp
 		, m_model{}
 		, m_port{}
 		, m_listenForEvents{false}
+		, m_configCache{new ConfigCache()}
+		, m_contextProgress{new ContextProgress()}
+		, m_contextCancellation{new ContextCancellation()}
+		, m_watchdog{}
+		, m_watchdogLabel{}
+		, m_operationDeadline{std::chrono::seconds(30)}
+		, m_latencies{new OperationLatencies()}
+		, m_metrics{}
 	{
 		FILE_LOG(logINFO) << "CameraWrapper Constructor";
 		
+		m_contextProgress->attach(m_context);
+		m_contextCancellation->attach(m_context);
+		
 		gphoto2pp::checkResponse(gphoto2::gp_camera_new(&m_camera),"gp_camera_new");
 		
 		initialize();
+		
+		m_metrics = MetricsRegistry::getShared().connectCamera(m_model, m_port);
 	}
 
 	CameraWrapper::~CameraWrapper()
@@ -103,6 +140,14 @@ namespace gphoto2pp
 		, m_model{std::move(other.m_model)}
 		, m_port{std::move(other.m_port)}
 		, m_listenForEvents{other.m_listenForEvents.load()}
+		, m_configCache{}
+		, m_contextProgress{}
+		, m_contextCancellation{}
+		, m_watchdog{std::move(other.m_watchdog)}
+		, m_watchdogLabel{std::move(other.m_watchdogLabel)}
+		, m_operationDeadline{other.m_operationDeadline}
+		, m_latencies{}
+		, m_metrics{}
 	{
 		FILE_LOG(logINFO) << "CameraWrapper move Constructor";
 		
@@ -111,7 +156,23 @@ namespace gphoto2pp
 		// We cannot transfer the thread atomics over, so we have to stop listening in the previous class and start in the next one.
 		other.stopListeningForEvents();
 		
+		// Only moved once the other listener stopped, since it uses them
+		m_configCache = std::move(other.m_configCache);
+		m_contextProgress = std::move(other.m_contextProgress);
+		m_contextCancellation = std::move(other.m_contextCancellation);
+		m_latencies = std::move(other.m_latencies);
+		m_metrics = std::move(other.m_metrics);
+		
+		// The moved-from wrapper can still be called (its calls then fail on the missing camera), so it gets detached helpers of its own
+		other.m_configCache.reset(new ConfigCache());
+		other.m_contextProgress.reset(new ContextProgress());
+		other.m_contextCancellation.reset(new ContextCancellation());
+		other.m_latencies.reset(new OperationLatencies());
+		other.m_metrics = std::make_shared<CameraMetrics>(std::string(), std::string()); // Not registered, it isn't a camera connecting again
+		
 		m_cameraEvents = std::move(other.m_cameraEvents);
+		m_typedCameraEvents = std::move(other.m_typedCameraEvents);
+		m_propertyChangedEvents = std::move(other.m_propertyChangedEvents);
 		
 		// If the other CameraWrapper was listening to events, then we start listening to events here.
 		if(m_listenForEvents)
@@ -148,7 +209,26 @@ namespace gphoto2pp
 			// We cannot transfer the thread atomics over, so we have to stop listening in the previous class and start in the next one.
 			other.stopListeningForEvents();
 			
+			// Only moved once the other listener stopped, since it uses them
+			m_configCache = std::move(other.m_configCache);
+			m_contextProgress = std::move(other.m_contextProgress);
+			m_contextCancellation = std::move(other.m_contextCancellation);
+			m_watchdog = std::move(other.m_watchdog);
+			m_watchdogLabel = std::move(other.m_watchdogLabel);
+			m_operationDeadline = other.m_operationDeadline;
+			m_latencies = std::move(other.m_latencies);
+			m_metrics = std::move(other.m_metrics);
+			
+			// The moved-from wrapper can still be called (its calls then fail on the missing camera), so it gets detached helpers of its own
+			other.m_configCache.reset(new ConfigCache());
+			other.m_contextProgress.reset(new ContextProgress());
+			other.m_contextCancellation.reset(new ContextCancellation());
+			other.m_latencies.reset(new OperationLatencies());
+			other.m_metrics = std::make_shared<CameraMetrics>(std::string(), std::string()); // Not registered, it isn't a camera connecting again
+			
 			m_cameraEvents = std::move(other.m_cameraEvents);
+			m_typedCameraEvents = std::move(other.m_typedCameraEvents);
+			m_propertyChangedEvents = std::move(other.m_propertyChangedEvents);
 			
 			// If the other CameraWrapper was listening to events, then we start listening to events here.
 			if(m_listenForEvents)
@@ -200,11 +280,28 @@ namespace gphoto2pp
 	{
 		FILE_LOG(logINFO) << "Initializing Camera on Port: " << port << " with Model: " << model;
 		
-		CameraAbilitiesListWrapper cameraAbilitiesList;
+		// The abilities are the same for every camera, so the list is loaded once per process
+		auto const & cameraAbilitiesList = CameraAbilitiesListWrapper::getShared();
 		int model_index = cameraAbilitiesList.lookupModel(model);
 		
-		GPPortInfoListWrapper portInfoList;
-		int port_index = portInfoList.lookupPath(port);
+		// Usb ports are enumerated when the list is loaded, so a camera plugged in since then needs a new list
+		auto const & sharedPortInfoList = GPPortInfoListWrapper::getShared();
+		std::unique_ptr<GPPortInfoListWrapper> freshPortInfoList;
+		int port_index = 0;
+		
+		try
+		{
+			port_index = sharedPortInfoList.lookupPath(port);
+		}
+		catch(exceptions::gphoto2_exception const &)
+		{
+			FILE_LOG(logDEBUG) << "Port '" << port << "' isn't in the shared port list, loading a new one";
+			
+			freshPortInfoList.reset(new GPPortInfoListWrapper());
+			port_index = freshPortInfoList->lookupPath(port);
+		}
+		
+		auto const & portInfoList = freshPortInfoList ? *freshPortInfoList : sharedPortInfoList;
 		
 		// I didn't wrap this because its only used in this one place, and the comments say its public use is "questionable"
 		gphoto2::CameraAbilities cameraAbilities;
@@ -228,36 +325,45 @@ namespace gphoto2pp
 		gphoto2::CameraText text;
 		
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_get_summary(m_camera, &text, m_context.get()),"gp_camera_get_summary");
+			auto const watchedCall = watchCall("gp_camera_get_summary", CancellationToken::none());
+			auto const lock = lockIO("gp_camera_get_summary", watchedCall);
+			checkCameraResponse(gphoto2::gp_camera_get_summary(m_camera, &text, m_context.get()),"gp_camera_get_summary");
 		}
 		
 		return std::string(text.text);
 	}
 
-	CameraFileWrapper CameraWrapper::capturePreview()
+	CameraFileWrapper CameraWrapper::capturePreview(CancellationToken const & cancellationToken)
 	{
 		CameraFileWrapper cameraFile;
 		
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_capture_preview(m_camera, cameraFile.getPtr(), m_context.get()),"gp_camera_capture_preview");
+			auto const watchedCall = watchCall("gp_camera_capture_preview", cancellationToken);
+			auto const lock = lockIO("gp_camera_capture_preview", watchedCall);
+			ContextCancellation::Scope cancellationScope{*m_contextCancellation, cancellationToken};
+			checkCameraResponse(gphoto2::gp_camera_capture_preview(m_camera, cameraFile.getPtr(), m_context.get()),"gp_camera_capture_preview");
 		}
 		
+		m_metrics->addPreviewFrame();
+		
 		return cameraFile;
 	}
 
-	CameraFilePathWrapper CameraWrapper::capture(CameraCaptureTypeWrapper const & captureType)
+	CameraFilePathWrapper CameraWrapper::capture(CameraCaptureTypeWrapper const & captureType, CancellationToken const & cancellationToken)
 	{
 		gphoto2::CameraFilePath cameraFilePath; // No wrapper made for this struct because it doesn't have an api to manipulate (similar to getSummary CameraText)
 		
 		// TODO, canon capture needs to enable the toggle widget "capture" with a value of 1, or 0 for off. I will need too get my hands on a canon and implement this.
 		
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_capture(m_camera, static_cast<gphoto2::CameraCaptureType>(captureType),  &cameraFilePath, m_context.get()),"gp_camera_capture");
+			auto const watchedCall = watchCall("gp_camera_capture", cancellationToken);
+			auto const lock = lockIO("gp_camera_capture", watchedCall);
+			ContextCancellation::Scope cancellationScope{*m_contextCancellation, cancellationToken};
+			checkCameraResponse(gphoto2::gp_camera_capture(m_camera, static_cast<gphoto2::CameraCaptureType>(captureType),  &cameraFilePath, m_context.get()),"gp_camera_capture");
 		}
 		
+		m_metrics->addCapture();
+		
 		FILE_LOG(logINFO) << "Pathname on the camera: '" << cameraFilePath.folder << "/" << cameraFilePath.name << "'";
 		
 		return gphoto2pp::CameraFilePathWrapper{cameraFilePath.name, cameraFilePath.folder};
@@ -268,8 +374,11 @@ namespace gphoto2pp
 #ifdef GPHOTO_LESS_25
 		throw exceptions::InvalidLinkedVersionException("You are using a version of gphoto2 that doesn't support this command. Please link to gphoto 2.5 or greater");
 #else	
-		std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-		gphoto2pp::checkResponse(gphoto2::gp_camera_trigger_capture(m_camera, m_context.get()),"gp_camera_trigger_capture");
+		auto const watchedCall = watchCall("gp_camera_trigger_capture", CancellationToken::none());
+		auto const lock = lockIO("gp_camera_trigger_capture", watchedCall);
+		checkCameraResponse(gphoto2::gp_camera_trigger_capture(m_camera, m_context.get()),"gp_camera_trigger_capture");
+		
+		m_metrics->addCapture();
 #endif
 	}
 
@@ -279,8 +388,9 @@ namespace gphoto2pp
 		gphoto2::CameraWidget* cameraWidget = nullptr;
 		
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_get_config(m_camera, &cameraWidget, m_context.get()),"gp_camera_get_config");
+			auto const watchedCall = watchCall("gp_camera_get_config", CancellationToken::none());
+			auto const lock = lockIO("gp_camera_get_config", watchedCall);
+			checkCameraResponse(gphoto2::gp_camera_get_config(m_camera, &cameraWidget, m_context.get()),"gp_camera_get_config");
 		}
 		
 		auto rootWidget = WindowWidget{cameraWidget};
@@ -289,14 +399,99 @@ namespace gphoto2pp
 	}
 
 	void CameraWrapper::setConfig(CameraWidgetWrapper const & cameraWidget)
+	{
+		writeConfig(cameraWidget);
+		
+		// Invalidated after the write, so a cache refresh running concurrently can't keep the old values
+		m_configCache->invalidate();
+	}
+	
+	void CameraWrapper::setConfig(CameraWidgetWrapper const & cameraWidget, std::vector<std::string> const & changedWidgetNames)
+	{
+		writeConfig(cameraWidget);
+		
+		// The driver may change other widgets as a side effect of the write (eg. the exposure mode changing the shutter speed), only the camera's events report those
+		if(!m_listenForEvents)
+		{
+			m_configCache->invalidate();
+			return;
+		}
+		
+		for(auto const & widgetName : changedWidgetNames)
+		{
+			m_configCache->invalidate(widgetName);
+		}
+	}
+	
+	void CameraWrapper::writeConfig(CameraWidgetWrapper const & cameraWidget)
 	{
 		auto rootWidget = cameraWidget.getRoot();
 		
+		try
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_set_config(m_camera, rootWidget.getPtr(), m_context.get()),"gp_camera_set_config"); // we can use cameraWidget->m_cameraWidget because this is a friend class of the camera_widget_wrapper
+			auto const watchedCall = watchCall("gp_camera_set_config", CancellationToken::none());
+			auto const lock = lockIO("gp_camera_set_config", watchedCall);
+			checkCameraResponse(gphoto2::gp_camera_set_config(m_camera, rootWidget.getPtr(), m_context.get()),"gp_camera_set_config"); // we can use cameraWidget->m_cameraWidget because this is a friend class of the camera_widget_wrapper
+		}
+		catch(...)
+		{
+			// We can't know what the camera accepted before failing
+			m_configCache->invalidate();
+			throw;
 		}
 	}
+	
+	std::shared_ptr<ConfigSnapshot const> CameraWrapper::getCachedConfig() const
+	{
+		auto snapshot = m_configCache->getSnapshot();
+		
+		if(snapshot == nullptr)
+		{
+			snapshot = refreshConfigCache();
+		}
+		
+		return snapshot;
+	}
+	
+	ConfigSnapshotEntry CameraWrapper::getCachedValue(std::string const & name) const
+	{
+		auto snapshot = m_configCache->getSnapshot(name);
+		
+		if(snapshot == nullptr)
+		{
+			snapshot = refreshConfigCache();
+		}
+		
+		auto entry = snapshot->find(name);
+		
+		if(entry == nullptr)
+		{
+			throw exceptions::CameraWrapperException("The camera doesn't have a value widget named '" + name + "'");
+		}
+		
+		return *entry;
+	}
+	
+	void CameraWrapper::setConfigCacheMaxAge(std::chrono::milliseconds maxAge)
+	{
+		m_configCache->setMaxAge(maxAge);
+	}
+	
+	void CameraWrapper::invalidateConfigCache()
+	{
+		m_configCache->invalidate();
+	}
+	
+	std::shared_ptr<ConfigSnapshot const> CameraWrapper::refreshConfigCache() const
+	{
+		auto refreshToken = m_configCache->beginRefresh();
+		
+		auto snapshot = std::make_shared<ConfigSnapshot const>(ConfigSnapshot::capture(getConfig()));
+		
+		m_configCache->publish(snapshot, refreshToken);
+		
+		return snapshot;
+	}
 
 	bool CameraWrapper::startListeningForEvents()
 	{
@@ -309,6 +504,9 @@ namespace gphoto2pp
 		
 		// Set to true so our thread loop will repeat until set back
 		m_listenForEvents = true;
+		
+		// A new token, the previous one was cancelled when the listener stopped
+		m_listenForEventsCancellation = CancellationToken();
 					
 		std::packaged_task<bool()> event_task([this](){
 			FILE_LOG(logINFO) << "Starting to listen for camera events";
@@ -316,12 +514,26 @@ namespace gphoto2pp
 			while(m_listenForEvents == true)
 			{
 				gphoto2::CameraEventType eventType;
-				void* eventData;
+				void* eventData = nullptr;
 				
 				try
 				{
-					std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-					gphoto2pp::checkResponse(gphoto2::gp_camera_wait_for_event(m_camera, 400, &eventType, &eventData, m_context.get()),"gp_camera_wait_for_event");
+					auto const watchedCall = watchCall("gp_camera_wait_for_event", m_listenForEventsCancellation);
+					auto const lock = lockIO("gp_camera_wait_for_event", watchedCall);
+					ContextCancellation::Scope cancellationScope{*m_contextCancellation, m_listenForEventsCancellation};
+					checkCameraResponse(gphoto2::gp_camera_wait_for_event(m_camera, 400, &eventType, &eventData, m_context.get()),"gp_camera_wait_for_event");
+				}
+				catch (exceptions::gphoto2_exception const & e)
+				{
+					if(e.getResultCode() == GP_ERROR_CANCEL && m_listenForEvents == false)
+					{
+						// stopListeningForEvents() cancelled the wait
+						return true;
+					}
+					
+					FILE_LOG(logCRITICAL) << "An Exception was thrown when waiting for camera events. The Camera possibly lost connection with the computer";
+					
+					return false;
 				}
 				catch (...)
 				{
@@ -332,6 +544,8 @@ namespace gphoto2pp
 				
 				FILE_LOG(logINFO) << "EventType Received: '" << static_cast<int>(eventType) << "'";
 				
+				auto const type = static_cast<CameraEventTypeWrapper>(eventType);
+				
 				switch(eventType)
 				{
 					case gphoto2::GP_EVENT_UNKNOWN:
@@ -339,7 +553,34 @@ namespace gphoto2pp
 						if(eventData)
 						{
 							// Unknown event, but it has data
-							m_cameraEvents(static_cast<CameraEventTypeWrapper>(eventType), CameraFilePathWrapper{"",""}, std::string((char*)eventData));
+							CameraEvent const event{static_cast<char const*>(eventData)};
+							
+							m_typedCameraEvents(type, event);
+							
+							if(m_cameraEvents.hasObservers(type))
+							{
+								m_cameraEvents(type, CameraFilePathWrapper{"",""}, event.toText());
+							}
+							
+							// PTP cameras report their property changes this way
+							if(event.isPropertyChanged())
+							{
+								PropertyChangedEvent propertyChangedEvent;
+								propertyChangedEvent.PropertyCode = event.getPropertyCode();
+								propertyChangedEvent.WidgetName = propertyCodeToWidgetName(event.getPropertyCode());
+								
+								// Vendor properties can't be mapped to a widget, so we don't know what is stale
+								if(propertyChangedEvent.WidgetName.empty())
+								{
+									m_configCache->invalidate();
+								}
+								else
+								{
+									m_configCache->invalidate(propertyChangedEvent.WidgetName);
+								}
+								
+								m_propertyChangedEvents(propertyChangedEvent);
+							}
 							break; // Break out of case
 						}
 						// Unknown event without data, so we let it trickle through
@@ -347,14 +588,27 @@ namespace gphoto2pp
 					case gphoto2::GP_EVENT_TIMEOUT:
 					case gphoto2::GP_EVENT_CAPTURE_COMPLETE:
 					{
-						m_cameraEvents(static_cast<CameraEventTypeWrapper>(eventType), CameraFilePathWrapper{"",""}, std::string("No Event Data Returned"));
+						m_typedCameraEvents(type, CameraEvent{type});
+						
+						// The legacy callbacks take owning arguments, so only build them for someone
+						if(m_cameraEvents.hasObservers(type))
+						{
+							m_cameraEvents(type, CameraFilePathWrapper{"",""}, std::string("No Event Data Returned"));
+						}
 						break;
 					}
 					case gphoto2::GP_EVENT_FILE_ADDED:
 					case gphoto2::GP_EVENT_FOLDER_ADDED:
 					{
-						gphoto2::CameraFilePath* cameraFilePath = (gphoto2::CameraFilePath*)eventData;
-						m_cameraEvents(static_cast<CameraEventTypeWrapper>(eventType), CameraFilePathWrapper{cameraFilePath->name, cameraFilePath->folder}, std::string(""));
+						auto cameraFilePath = static_cast<gphoto2::CameraFilePath*>(eventData);
+						CameraEvent const event{type, cameraFilePath->folder, cameraFilePath->name};
+						
+						m_typedCameraEvents(type, event);
+						
+						if(m_cameraEvents.hasObservers(type))
+						{
+							m_cameraEvents(type, event.toFilePath(), std::string(""));
+						}
 						break;
 					}
 					default:
@@ -363,6 +617,9 @@ namespace gphoto2pp
 						break;
 					}
 				}
+				
+				// The event data is allocated by gphoto2 for the caller
+				std::free(eventData);
 			}
 			return true;
 		});
@@ -374,22 +631,92 @@ namespace gphoto2pp
 		return true;
 	}
 	
+	CameraEventTypeWrapper CameraWrapper::waitForEvent(int timeout, CameraFilePathWrapper& cameraFilePath, std::string& eventText, CancellationToken const & cancellationToken)
+	{
+		if(m_listenForEventSignalFuture.valid())
+		{
+			throw exceptions::CameraWrapperException("Can't wait for events while the event listener is running");
+		}
+		
+		// Drivers don't always poll the context while waiting, so the deadline also bounds the timeout
+		auto const deadline = cancellationToken.getDeadline();
+		if(deadline != std::chrono::steady_clock::time_point::max())
+		{
+			auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			timeout = static_cast<int>(std::max<decltype(remaining)>(0, std::min<decltype(remaining)>(timeout, remaining)));
+		}
+		
+		gphoto2::CameraEventType eventType;
+		void* eventData = nullptr;
+		
+		{
+			auto const watchedCall = watchCall("gp_camera_wait_for_event", cancellationToken);
+			auto const lock = lockIO("gp_camera_wait_for_event", watchedCall);
+			ContextCancellation::Scope cancellationScope{*m_contextCancellation, cancellationToken};
+			checkCameraResponse(gphoto2::gp_camera_wait_for_event(m_camera, timeout, &eventType, &eventData, m_context.get()),"gp_camera_wait_for_event");
+		}
+		
+		switch(eventType)
+		{
+			case gphoto2::GP_EVENT_UNKNOWN:
+				eventText = eventData ? std::string(static_cast<char*>(eventData)) : std::string();
+				break;
+			case gphoto2::GP_EVENT_FILE_ADDED:
+			case gphoto2::GP_EVENT_FOLDER_ADDED:
+			{
+				auto eventFilePath = static_cast<gphoto2::CameraFilePath*>(eventData);
+				cameraFilePath = CameraFilePathWrapper{eventFilePath->name, eventFilePath->folder};
+				break;
+			}
+			default:
+				break;
+		}
+		
+		// The event data is allocated by gphoto2 for the caller
+		std::free(eventData);
+		
+		return static_cast<CameraEventTypeWrapper>(eventType);
+	}
+	
 	observer::Registration CameraWrapper::subscribeToCameraEvent(CameraEventTypeWrapper const & event, std::function<void(const CameraFilePathWrapper&, const std::string&)> func)
 	{
 		return m_cameraEvents.registerObserver(event, std::move(func));
 	}
 	
+	observer::Registration CameraWrapper::subscribeToTypedCameraEvent(CameraEventTypeWrapper const & event, std::function<void(const CameraEvent&)> func)
+	{
+		return m_typedCameraEvents.registerObserver(event, std::move(func));
+	}
+	
+	observer::Registration CameraWrapper::subscribeToPropertyChanged(std::function<void(const PropertyChangedEvent&)> func)
+	{
+		return m_propertyChangedEvents.registerObserver(std::move(func));
+	}
+	
+	observer::Registration CameraWrapper::subscribeToProgress(ProgressEventType const & event, std::function<void(const ProgressEvent&)> func)
+	{
+		return m_contextProgress->subscribe(event, std::move(func));
+	}
+	
 	void CameraWrapper::stopListeningForEvents()
 	{
 		if(m_listenForEventSignalFuture.valid())
 		{
 			FILE_LOG(logDEBUG) << "listener is running, we will signal it to stop";
 			
-			// We are already listening to events, and so we signal them to stop
+			// We are already listening to events, and so we signal them to stop, and cancel the wait in progress so a stuck camera can't freeze us
 			m_listenForEvents = false;
+			m_listenForEventsCancellation.cancel();
 			
-			// TODO probably make this a wait_for with a timeout, so we cannot freeze anything...
-			m_listenForEventSignalFuture.wait();
+			if(m_listenForEventSignalFuture.wait_for(std::chrono::seconds(2)) == std::future_status::timeout)
+			{
+				// The driver doesn't poll the context while waiting, nothing more we can do than wait for its own timeout
+				FILE_LOG(logWARN) << "listener didn't stop within 2 seconds, still waiting for it";
+				m_listenForEventSignalFuture.wait();
+			}
+			
+			// Releases the future, so the listener can be started again
+			m_listenForEventSignalFuture.get();
 			
 			FILE_LOG(logDEBUG) << "listener just stopped";
 		}
@@ -399,25 +726,88 @@ namespace gphoto2pp
 		}
 	}
 	
-	CameraListWrapper CameraWrapper::folderListFiles(std::string const & folder) const
+	void CameraWrapper::cancelCurrentOperation()
+	{
+		m_contextCancellation->cancelCurrent();
+	}
+	
+	void CameraWrapper::setWatchdog(std::shared_ptr<CameraWatchdog> watchdog, std::chrono::milliseconds operationDeadline)
+	{
+		m_watchdog = std::move(watchdog);
+		m_watchdogLabel = m_watchdog ? std::make_shared<std::string const>(m_model + " on " + m_port) : nullptr;
+		m_operationDeadline = operationDeadline;
+	}
+	
+	OperationLatencies const & CameraWrapper::getLatencies() const
+	{
+		return *m_latencies;
+	}
+	
+	std::shared_ptr<CameraMetrics const> CameraWrapper::getMetrics() const
+	{
+		return m_metrics;
+	}
+	
+	CameraWatchdog::Call CameraWrapper::watchCall(char const * operation, CancellationToken const & cancellationToken) const
+	{
+		if(!m_watchdog)
+		{
+			return CameraWatchdog::Call();
+		}
+		
+		auto const deadline = std::min(std::chrono::steady_clock::now() + m_operationDeadline, cancellationToken.getDeadline());
+		
+		return m_watchdog->begin(m_watchdogLabel, operation, deadline, m_contextCancellation.get());
+	}
+	
+	CameraWrapper::TimedIOLock CameraWrapper::lockIO(char const * operation, CameraWatchdog::Call const & watchedCall) const
+	{
+		auto timer = m_latencies->begin(operation);
+		
+		m_metrics->addWaitingCall();
+		std::unique_lock<std::mutex> lock{m_cameraIOMutex};
+		m_metrics->removeWaitingCall();
+		
+		timer.locked();
+		watchedCall.locked();
+		
+		return TimedIOLock{std::move(timer), std::move(lock)};
+	}
+	
+	int CameraWrapper::checkCameraResponse(int result, char const * methodName) const
+	{
+		// A cancellation was asked for (stopListeningForEvents(), a token or the watchdog), the camera didn't fail
+		if(result < 0 && result != GP_ERROR_CANCEL)
+		{
+			m_metrics->addError(result);
+		}
+		
+		return gphoto2pp::checkResponse(result, methodName);
+	}
+	
+	CameraListWrapper CameraWrapper::folderListFiles(std::string const & folder, CancellationToken const & cancellationToken) const
 	{
 		CameraListWrapper cameraList;
 		
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_folder_list_files(m_camera, folder.c_str(), cameraList.getPtr(), m_context.get()),"gp_camera_folder_list_files");
+			auto const watchedCall = watchCall("gp_camera_folder_list_files", cancellationToken);
+			auto const lock = lockIO("gp_camera_folder_list_files", watchedCall);
+			ContextCancellation::Scope cancellationScope{*m_contextCancellation, cancellationToken};
+			checkCameraResponse(gphoto2::gp_camera_folder_list_files(m_camera, folder.c_str(), cameraList.getPtr(), m_context.get()),"gp_camera_folder_list_files");
 		}
 		
 		return cameraList;
 	}
 	
-	CameraListWrapper CameraWrapper::folderListFolders(std::string const & folder) const
+	CameraListWrapper CameraWrapper::folderListFolders(std::string const & folder, CancellationToken const & cancellationToken) const
 	{
 		CameraListWrapper cameraList;
 		
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_folder_list_folders(m_camera, folder.c_str(), cameraList.getPtr(), m_context.get()),"gp_camera_folder_list_folders");
+			auto const watchedCall = watchCall("gp_camera_folder_list_folders", cancellationToken);
+			auto const lock = lockIO("gp_camera_folder_list_folders", watchedCall);
+			ContextCancellation::Scope cancellationScope{*m_contextCancellation, cancellationToken};
+			checkCameraResponse(gphoto2::gp_camera_folder_list_folders(m_camera, folder.c_str(), cameraList.getPtr(), m_context.get()),"gp_camera_folder_list_folders");
 		}
 		
 		return cameraList;
@@ -427,39 +817,54 @@ namespace gphoto2pp
 	
 	void CameraWrapper::folderDeleteAll(std::string const & folder)
 	{
-		std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-		gphoto2pp::checkResponse(gphoto2::gp_camera_folder_delete_all(m_camera, folder.c_str(), m_context.get()),"gp_camera_folder_delete_all");
+		auto const watchedCall = watchCall("gp_camera_folder_delete_all", CancellationToken::none());
+		auto const lock = lockIO("gp_camera_folder_delete_all", watchedCall);
+		checkCameraResponse(gphoto2::gp_camera_folder_delete_all(m_camera, folder.c_str(), m_context.get()),"gp_camera_folder_delete_all");
 	}
 	
-	void CameraWrapper::folderPutFile(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType, CameraFileWrapper cameraFile)
+	void CameraWrapper::folderPutFile(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType, CameraFileWrapper cameraFile, CancellationToken const & cancellationToken)
 	{
-		std::lock_guard<std::mutex> lock{m_cameraIOMutex};
+		auto const watchedCall = watchCall("gp_camera_folder_put_file", cancellationToken);
+		auto const lock = lockIO("gp_camera_folder_put_file", watchedCall);
+		ContextCancellation::Scope cancellationScope{*m_contextCancellation, cancellationToken};
 #ifdef GPHOTO_LESS_25
-		gphoto2pp::checkResponse(gphoto2::gp_camera_folder_put_file(m_camera, folder.c_str(), cameraFile.getPtr(), m_context.get()),"gp_camera_folder_put_file");
+		checkCameraResponse(gphoto2::gp_camera_folder_put_file(m_camera, folder.c_str(), cameraFile.getPtr(), m_context.get()),"gp_camera_folder_put_file");
 #else
-		gphoto2pp::checkResponse(gphoto2::gp_camera_folder_put_file(m_camera, folder.c_str(), fileName.c_str(), static_cast<gphoto2::CameraFileType>(fileType), cameraFile.getPtr(), m_context.get()),"gp_camera_folder_put_file");
+		checkCameraResponse(gphoto2::gp_camera_folder_put_file(m_camera, folder.c_str(), fileName.c_str(), static_cast<gphoto2::CameraFileType>(fileType), cameraFile.getPtr(), m_context.get()),"gp_camera_folder_put_file");
 #endif
 	}
 	
 	void CameraWrapper::folderMakeDir(std::string const & folder, std::string const & name)
 	{
-		std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-		gphoto2pp::checkResponse(gphoto2::gp_camera_folder_make_dir(m_camera, folder.c_str(), name.c_str(), m_context.get()),"gp_camera_folder_make_dir");
+		auto const watchedCall = watchCall("gp_camera_folder_make_dir", CancellationToken::none());
+		auto const lock = lockIO("gp_camera_folder_make_dir", watchedCall);
+		checkCameraResponse(gphoto2::gp_camera_folder_make_dir(m_camera, folder.c_str(), name.c_str(), m_context.get()),"gp_camera_folder_make_dir");
 	}
 	
 	void CameraWrapper::folderRemoveDir(std::string const & folder, std::string const & name)
 	{
-		std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-		gphoto2pp::checkResponse(gphoto2::gp_camera_folder_remove_dir(m_camera, folder.c_str(), name.c_str(), m_context.get()),"gp_camera_folder_remove_dir");
+		auto const watchedCall = watchCall("gp_camera_folder_remove_dir", CancellationToken::none());
+		auto const lock = lockIO("gp_camera_folder_remove_dir", watchedCall);
+		checkCameraResponse(gphoto2::gp_camera_folder_remove_dir(m_camera, folder.c_str(), name.c_str(), m_context.get()),"gp_camera_folder_remove_dir");
 	}
 	
-	CameraFileWrapper CameraWrapper::fileGet(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType) const
+	CameraFileWrapper CameraWrapper::fileGet(std::string const & folder, std::string const & fileName, CameraFileTypeWrapper const & fileType, CancellationToken const & cancellationToken) const
 	{
 		CameraFileWrapper cameraFileWrapper;
 		
 		{
-			std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-			gphoto2pp::checkResponse(gphoto2::gp_camera_file_get(m_camera, folder.c_str(), fileName.c_str(), static_cast<gphoto2::CameraFileType>(fileType), cameraFileWrapper.getPtr(), m_context.get()),"gp_camera_file_get");
+			auto const watchedCall = watchCall("gp_camera_file_get", cancellationToken);
+			auto const lock = lockIO("gp_camera_file_get", watchedCall);
+			ContextCancellation::Scope cancellationScope{*m_contextCancellation, cancellationToken};
+			checkCameraResponse(gphoto2::gp_camera_file_get(m_camera, folder.c_str(), fileName.c_str(), static_cast<gphoto2::CameraFileType>(fileType), cameraFileWrapper.getPtr(), m_context.get()),"gp_camera_file_get");
+		}
+		
+		// Only the size is needed, so the data isn't copied out like getDataAndSize() would
+		char const * data = nullptr;
+		unsigned long size = 0;
+		if(gphoto2::gp_file_get_data_and_size(cameraFileWrapper.getPtr(), &data, &size) >= 0)
+		{
+			m_metrics->addBytesDownloaded(size);
 		}
 		
 		return cameraFileWrapper;
@@ -467,8 +872,9 @@ namespace gphoto2pp
 	
 	void CameraWrapper::fileDelete(std::string const & folder, std::string const & fileName) const
 	{
-		std::lock_guard<std::mutex> lock{m_cameraIOMutex};
-		gphoto2pp::checkResponse(gphoto2::gp_camera_file_delete(m_camera, folder.c_str(), fileName.c_str(), m_context.get()),"gp_camera_file_delete");
+		auto const watchedCall = watchCall("gp_camera_file_delete", CancellationToken::none());
+		auto const lock = lockIO("gp_camera_file_delete", watchedCall);
+		checkCameraResponse(gphoto2::gp_camera_file_delete(m_camera, folder.c_str(), fileName.c_str(), m_context.get()),"gp_camera_file_delete");
 	}
 }
 
@@ -0,0 +1,103 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/cancellation_token.hpp>
+
+#include <gphoto2pp/log.h>
+
+namespace gphoto2pp
+{
+	CancellationToken::CancellationToken()
+		: m_state{std::make_shared<State>()}
+	{
+		m_state->Cancelled = false;
+		m_state->Deadline = std::chrono::steady_clock::time_point::max().time_since_epoch().count();
+	}
+	
+	CancellationToken::CancellationToken(std::shared_ptr<State> state)
+		: m_state{std::move(state)}
+	{
+	}
+	
+	CancellationToken CancellationToken::withTimeout(std::chrono::milliseconds timeout)
+	{
+		CancellationToken token;
+		token.setDeadline(std::chrono::steady_clock::now() + timeout);
+		
+		return token;
+	}
+	
+	CancellationToken const & CancellationToken::none()
+	{
+		static CancellationToken const noneToken{std::shared_ptr<State>()};
+		
+		return noneToken;
+	}
+	
+	void CancellationToken::cancel()
+	{
+		if(!m_state)
+		{
+			FILE_LOG(logWARN1) << "CancellationToken cancel - the none token can't be cancelled";
+			return;
+		}
+		
+		m_state->Cancelled = true;
+	}
+	
+	void CancellationToken::setDeadline(std::chrono::steady_clock::time_point deadline)
+	{
+		if(!m_state)
+		{
+			FILE_LOG(logWARN1) << "CancellationToken setDeadline - the none token can't have a deadline";
+			return;
+		}
+		
+		m_state->Deadline = deadline.time_since_epoch().count();
+	}
+	
+	std::chrono::steady_clock::time_point CancellationToken::getDeadline() const
+	{
+		if(!m_state)
+		{
+			return std::chrono::steady_clock::time_point::max();
+		}
+		
+		return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(m_state->Deadline.load()));
+	}
+	
+	bool CancellationToken::isCancelled() const
+	{
+		if(!m_state)
+		{
+			return false;
+		}
+		
+		return m_state->Cancelled || std::chrono::steady_clock::now().time_since_epoch().count() >= m_state->Deadline;
+	}
+}
@@ -0,0 +1,128 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/capture_pipeline.hpp>
+
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/camera_file_wrapper.hpp>
+#include <gphoto2pp/camera_event_type_wrapper.hpp>
+#include <gphoto2pp/camera_capture_type_wrapper.hpp>
+#include <gphoto2pp/camera_file_type_wrapper.hpp>
+#include <gphoto2pp/exceptions.hpp>
+
+#include <gphoto2pp/log.h>
+
+namespace gphoto2pp
+{
+	CapturePipeline::CapturePipeline(CameraWrapper& cameraWrapper, FileHandler fileHandler, bool deleteFromCamera /* = true */, std::chrono::milliseconds captureTimeout /* = 30000 */)
+		: m_cameraWrapper(cameraWrapper)
+		, m_fileHandler{std::move(fileHandler)}
+		, m_deleteFromCamera{deleteFromCamera}
+		, m_captureTimeout{captureTimeout}
+		, m_hasPending{false}
+		, m_pending{}
+	{
+	}
+	
+	CapturePipeline::~CapturePipeline()
+	{
+		try
+		{
+			flush();
+		}
+		catch(std::exception const & e)
+		{
+			FILE_LOG(logERROR) << "CapturePipeline failed to download the last image '" << m_pending.Folder << "/" << m_pending.Name << "': " << e.what();
+		}
+	}
+	
+	CameraFilePathWrapper CapturePipeline::capture()
+	{
+#ifdef GPHOTO_LESS_25
+		// Without trigger capture the exposure is over when capture returns, so we can only download afterwards
+		auto cameraFilePath = m_cameraWrapper.capture(CameraCaptureTypeWrapper::Image);
+		flush();
+#else
+		m_cameraWrapper.triggerCapture();
+		
+		// The camera is busy exposing, which is time we can use to fetch the previous image
+		flush();
+		
+		auto cameraFilePath = waitForFileAdded();
+#endif
+		
+		m_pending = cameraFilePath;
+		m_hasPending = true;
+		
+		return cameraFilePath;
+	}
+	
+	void CapturePipeline::flush()
+	{
+		if(m_hasPending)
+		{
+			m_hasPending = false;
+			download(m_pending);
+		}
+	}
+	
+	CameraFilePathWrapper CapturePipeline::waitForFileAdded()
+	{
+		auto deadline = std::chrono::steady_clock::now() + m_captureTimeout;
+		
+		CameraFilePathWrapper cameraFilePath;
+		std::string eventText;
+		
+		for(auto now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now())
+		{
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+			
+			if(m_cameraWrapper.waitForEvent(static_cast<int>(remaining.count()), cameraFilePath, eventText) == CameraEventTypeWrapper::FileAdded)
+			{
+				FILE_LOG(logDEBUG) << "CapturePipeline file added '" << cameraFilePath.Folder << "/" << cameraFilePath.Name << "'";
+				return cameraFilePath;
+			}
+		}
+		
+		throw exceptions::CameraWrapperException("The camera didn't save an image within the capture timeout");
+	}
+	
+	void CapturePipeline::download(CameraFilePathWrapper const & cameraFilePath)
+	{
+		auto cameraFile = m_cameraWrapper.fileGet(cameraFilePath.Folder, cameraFilePath.Name, CameraFileTypeWrapper::Normal);
+		
+		if(m_deleteFromCamera)
+		{
+			m_cameraWrapper.fileDelete(cameraFilePath.Folder, cameraFilePath.Name);
+		}
+		
+		if(m_fileHandler)
+		{
+			m_fileHandler(cameraFilePath, cameraFile);
+		}
+	}
+}
@@ -28,8 +28,10 @@
 #include <gphoto2pp/camera_widget_type_wrapper.hpp>
 #include <gphoto2pp/exceptions.hpp>
 
-#include <algorithm>
 #include <sstream>
+#include <unordered_map>
+#include <cstring>
+#include <memory>
 
 namespace gphoto2
 {
@@ -38,6 +40,37 @@ namespace gphoto2
 
 namespace gphoto2pp
 {
+	namespace detail
+	{
+		// Hashes the characters of a c string (FNV-1a), so the table can be searched with the char* gphoto2 gives us without building a std::string
+		struct CStringHash
+		{
+			std::size_t operator()(char const * value) const
+			{
+				std::size_t hash = 2166136261u;
+				for(; *value != '\0'; ++value)
+				{
+					hash = (hash ^ static_cast<unsigned char>(*value)) * 16777619u;
+				}
+				return hash;
+			}
+		};
+		
+		struct CStringEqual
+		{
+			bool operator()(char const * left, char const * right) const
+			{
+				return std::strcmp(left, right) == 0;
+			}
+		};
+		
+		// The strings are owned by the gphoto2 widget, which stays alive as long as any wrapper references its tree
+		struct ChoiceTable
+		{
+			std::vector<char const *> Choices;
+			std::unordered_map<char const *, int, CStringHash, CStringEqual> Indices;
+		};
+	}
 
 	ChoicesWidget::ChoicesWidget(gphoto2::_CameraWidget* cameraWidget)
 		: StringWidget{cameraWidget}
@@ -55,61 +88,71 @@ namespace gphoto2pp
 	
 	int ChoicesWidget::countChoices() const
 	{
-		return gphoto2pp::checkResponse(gphoto2::gp_widget_count_choices(m_cameraWidget),"gp_widget_count_choices");
+		return static_cast<int>(getChoiceTable().Choices.size());
 	}
 
 	std::vector<std::string> ChoicesWidget::getChoices() const
 	{
-		int choiceCount = countChoices();
-		
-		std::vector<std::string> choices(choiceCount);
-		for(int i = 0; i < choiceCount; ++i)
-		{
-			choices[i] = choiceToString(i);
-		}
+		auto const & choiceTable = getChoiceTable();
 		
-		return choices;
+		return std::vector<std::string>(std::begin(choiceTable.Choices), std::end(choiceTable.Choices));
 	}
 	
 	int ChoicesWidget::getChoice() const
 	{
-		// Gets all the choices in the structure
-		auto choices = getChoices();
+		char* temp = nullptr;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_value(m_cameraWidget, &temp),"gp_widget_get_value");
+		
+		auto const & choiceTable = getChoiceTable();
 		
-		// Finds the iterator over the choice that matches the currently set one
-		auto const item = std::find(std::begin(choices), std::end(choices), this->getValue());
+		auto const item = (temp == nullptr) ? std::end(choiceTable.Indices) : choiceTable.Indices.find(temp);
 		
 		// If the index is at the end
-		if(item == std::end(choices))
+		if(item == std::end(choiceTable.Indices))
 		{
 			throw exceptions::ValueOutOfLimits("For some strange reason, the current value set on the camera didn't match to a value from the choices");
 		}
 		
-		return std::distance(std::begin(choices), item);
+		return item->second;
 	}
 	
 	void ChoicesWidget::setChoice(int index)
 	{
-		if (index >= countChoices())
+		auto const & choiceTable = getChoiceTable();
+		
+		if (index < 0 || index >= static_cast<int>(choiceTable.Choices.size()))
 		{
 			throw exceptions::IndexOutOfRange("You are trying to set a choice index which is greater than the maximum choice index.");
 		}
 		
-		this->setValue(choiceToString(index));
+		gphoto2pp::checkResponse(gphoto2::gp_widget_set_value(m_cameraWidget, choiceTable.Choices[index]),"gp_widget_set_value");
 	}
 	
 	std::string ChoicesWidget::choiceToString(int index) const
 	{
-		if (index >= countChoices())
+		auto const & choiceTable = getChoiceTable();
+		
+		if (index < 0 || index >= static_cast<int>(choiceTable.Choices.size()))
 		{
 			throw exceptions::IndexOutOfRange("You are trying to get a choice index which is greater than the maximum choice index.");
 		}
 		
-		char const * temp = nullptr;
+		return std::string(choiceTable.Choices[index]);
+	}
+	
+	int ChoicesWidget::stringToChoice(std::string const & choice) const
+	{
+		auto const & choiceTable = getChoiceTable();
+		
+		auto const item = choiceTable.Indices.find(choice.c_str());
 		
-		gphoto2pp::checkResponse(gphoto2::gp_widget_get_choice(m_cameraWidget, index, &temp),"gp_widget_get_choice");
+		if(item == std::end(choiceTable.Indices))
+		{
+			throw exceptions::ValueOutOfLimits("The value '" + choice + "' is not one of the choices");
+		}
 		
-		return std::string(temp);
+		return item->second;
 	}
 	
 	std::string ChoicesWidget::choicesToString(std::string&& separator /* = " " */) const
@@ -119,14 +162,50 @@ namespace gphoto2pp
 		{
 			throw exceptions::ArgumentException("You are not allowed to have an empty separator");
 		}
+		
 		std::stringstream temp;
-		for(auto choice : getChoices())
+		
+		for(auto choice : getChoiceTable().Choices)
 		{
 			temp << "\"" << choice << "\"" << separator;
 		}
 		
 		return temp.str().substr(0, temp.str().length() - separator.length()); // erases the last separator
 	}
-
+	
+	detail::ChoiceTable const & ChoicesWidget::getChoiceTable() const
+	{
+		auto table = std::atomic_load(&m_choiceTable);
+		
+		if(!table)
+		{
+			auto choiceTable = std::make_shared<detail::ChoiceTable>();
+			
+			int choiceCount = gphoto2pp::checkResponse(gphoto2::gp_widget_count_choices(m_cameraWidget),"gp_widget_count_choices");
+			
+			choiceTable->Choices.reserve(choiceCount);
+			choiceTable->Indices.reserve(choiceCount);
+			
+			for(int i = 0; i < choiceCount; ++i)
+			{
+				char const * temp = nullptr;
+				
+				gphoto2pp::checkResponse(gphoto2::gp_widget_get_choice(m_cameraWidget, i, &temp),"gp_widget_get_choice");
+				
+				choiceTable->Choices.push_back(temp);
+				
+				// emplace keeps the first index if a camera ever reports the same choice twice
+				choiceTable->Indices.emplace(temp, i);
+			}
+			
+			// Another thread may have built it meanwhile, the first table published is kept so references already handed out stay valid
+			std::shared_ptr<detail::ChoiceTable const> built{std::move(choiceTable)};
+			if(std::atomic_compare_exchange_strong(&m_choiceTable, &table, built))
+			{
+				table = std::move(built);
+			}
+		}
+		
+		return *table;
+	}
 }
-
@@ -0,0 +1,177 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCONFIG
+
+#include <gphoto2pp/config_cache.hpp>
+
+#include <gphoto2pp/config_snapshot.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <unordered_map>
+
+namespace gphoto2pp
+{
+	struct ConfigCache::State
+	{
+		std::shared_ptr<ConfigSnapshot const> Snapshot;
+		std::chrono::steady_clock::time_point CapturedAt;
+		
+		// Generation of the last invalidation, zero if never invalidated
+		std::uint64_t AllStaleGeneration;
+		bool AllStale;
+		
+		// Name of each stale widget and the generation it was invalidated at
+		std::unordered_map<std::string, std::uint64_t> StaleWidgets;
+	};
+	
+	ConfigCache::ConfigCache()
+		: m_state{std::make_shared<State const>(State{nullptr, std::chrono::steady_clock::time_point{}, 0, false, {}})}
+		, m_generation{0}
+		, m_maxAge{0}
+	{
+	}
+	
+	std::shared_ptr<ConfigSnapshot const> ConfigCache::getSnapshot() const
+	{
+		auto state = getFreshState();
+		
+		if(state == nullptr || !state->StaleWidgets.empty())
+		{
+			return nullptr;
+		}
+		
+		return state->Snapshot;
+	}
+	
+	std::shared_ptr<ConfigSnapshot const> ConfigCache::getSnapshot(std::string const & widgetName) const
+	{
+		auto state = getFreshState();
+		
+		if(state == nullptr || state->StaleWidgets.count(widgetName) > 0)
+		{
+			return nullptr;
+		}
+		
+		return state->Snapshot;
+	}
+	
+	std::uint64_t ConfigCache::beginRefresh() const
+	{
+		return m_generation.load();
+	}
+	
+	void ConfigCache::publish(std::shared_ptr<ConfigSnapshot const> snapshot, std::uint64_t refreshToken)
+	{
+		auto capturedAt = std::chrono::steady_clock::now();
+		
+		modifyState([&snapshot, capturedAt, refreshToken](State& state)
+		{
+			state.Snapshot = snapshot;
+			state.CapturedAt = capturedAt;
+			state.AllStale = state.AllStaleGeneration > refreshToken;
+			
+			for(auto item = std::begin(state.StaleWidgets); item != std::end(state.StaleWidgets);)
+			{
+				if(item->second <= refreshToken)
+				{
+					item = state.StaleWidgets.erase(item);
+				}
+				else
+				{
+					++item;
+				}
+			}
+		});
+		
+		FILE_LOG(logDEBUG) << "ConfigCache published a new snapshot";
+	}
+	
+	void ConfigCache::invalidate()
+	{
+		auto generation = ++m_generation;
+		
+		modifyState([generation](State& state)
+		{
+			state.AllStaleGeneration = generation;
+			state.AllStale = true;
+		});
+	}
+	
+	void ConfigCache::invalidate(std::string const & widgetName)
+	{
+		auto generation = ++m_generation;
+		
+		modifyState([&widgetName, generation](State& state)
+		{
+			state.StaleWidgets[widgetName] = generation;
+		});
+	}
+	
+	void ConfigCache::setMaxAge(std::chrono::milliseconds maxAge)
+	{
+		m_maxAge = maxAge.count();
+	}
+	
+	std::chrono::milliseconds ConfigCache::getMaxAge() const
+	{
+		return std::chrono::milliseconds(m_maxAge.load());
+	}
+	
+	std::shared_ptr<ConfigCache::State const> ConfigCache::getFreshState() const
+	{
+		auto state = std::atomic_load(&m_state);
+		
+		if(state->Snapshot == nullptr || state->AllStale)
+		{
+			return nullptr;
+		}
+		
+		auto maxAge = getMaxAge();
+		
+		if(maxAge.count() > 0 && std::chrono::steady_clock::now() - state->CapturedAt > maxAge)
+		{
+			return nullptr;
+		}
+		
+		return state;
+	}
+	
+	template<typename Modifier>
+	void ConfigCache::modifyState(Modifier modifier)
+	{
+		auto current = std::atomic_load(&m_state);
+		std::shared_ptr<State const> next;
+		
+		// Copy on write, retried if another thread swapped the state in the meantime
+		do
+		{
+			auto state = std::make_shared<State>(*current);
+			modifier(*state);
+			next = std::move(state);
+		} while(!std::atomic_compare_exchange_weak(&m_state, &current, next));
+	}
+}
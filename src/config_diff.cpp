@@ -0,0 +1,153 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCONFIG
+
+#include <gphoto2pp/config_diff.hpp>
+
+#include <gphoto2pp/camera_wrapper.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		bool sameValue(ConfigSnapshotEntry const & left, ConfigSnapshotEntry const & right)
+		{
+			switch(left.Type)
+			{
+				case CameraWidgetTypeWrapper::Text:
+				case CameraWidgetTypeWrapper::Radio:
+				case CameraWidgetTypeWrapper::Menu:
+					return left.StringValue == right.StringValue;
+				case CameraWidgetTypeWrapper::Range:
+					return left.FloatValue == right.FloatValue;
+				default:
+					return left.IntValue == right.IntValue;
+			}
+		}
+		
+		void compareEntries(ConfigSnapshotEntry const & from, ConfigSnapshotEntry const & to, bool includeReadOnly, std::vector<ConfigChange>& changes)
+		{
+			if(!includeReadOnly && (from.ReadOnly || to.ReadOnly))
+			{
+				return;
+			}
+			
+			if(from.Type != to.Type)
+			{
+				changes.push_back(ConfigChange{ConfigChangeKind::TypeChanged, from.Path, from, to});
+			}
+			else if(!sameValue(from, to))
+			{
+				changes.push_back(ConfigChange{ConfigChangeKind::Modified, from.Path, from, to});
+			}
+		}
+	}
+	
+	std::vector<ConfigChange> diffConfig(ConfigSnapshot const & from, ConfigSnapshot const & to, bool includeReadOnly /* = false */)
+	{
+		auto const & fromEntries = from.getEntries();
+		auto const & toEntries = to.getEntries();
+		
+		std::vector<ConfigChange> changes;
+		
+		// Only built once the two snapshots stop lining up. Some drivers use the same label in two sections, so a path can have several entries
+		std::unordered_map<std::string, std::vector<std::size_t>> toIndices;
+		std::vector<bool> matched(toEntries.size(), false);
+		
+		std::size_t next = 0; // the entry of to which lines up with the current entry of from
+		
+		for(auto const & fromEntry : fromEntries)
+		{
+			std::size_t found = toEntries.size();
+			
+			if(next < toEntries.size() && !matched[next] && toEntries[next].Path == fromEntry.Path)
+			{
+				found = next;
+			}
+			else
+			{
+				if(toIndices.empty())
+				{
+					toIndices.reserve(toEntries.size());
+					for(std::size_t i = 0; i < toEntries.size(); ++i)
+					{
+						toIndices[toEntries[i].Path].push_back(i);
+					}
+				}
+				
+				// The occurrences of a path are matched in order
+				auto item = toIndices.find(fromEntry.Path);
+				if(item != std::end(toIndices))
+				{
+					for(auto index : item->second)
+					{
+						if(!matched[index])
+						{
+							found = index;
+							break;
+						}
+					}
+				}
+			}
+			
+			if(found == toEntries.size())
+			{
+				if(includeReadOnly || !fromEntry.ReadOnly)
+				{
+					changes.push_back(ConfigChange{ConfigChangeKind::Removed, fromEntry.Path, fromEntry, ConfigSnapshotEntry{}});
+				}
+				continue;
+			}
+			
+			matched[found] = true;
+			next = found + 1;
+			
+			detail::compareEntries(fromEntry, toEntries[found], includeReadOnly, changes);
+		}
+		
+		for(std::size_t i = 0; i < toEntries.size(); ++i)
+		{
+			if(!matched[i] && (includeReadOnly || !toEntries[i].ReadOnly))
+			{
+				changes.push_back(ConfigChange{ConfigChangeKind::Added, toEntries[i].Path, ConfigSnapshotEntry{}, toEntries[i]});
+			}
+		}
+		
+		FILE_LOG(logDEBUG) << "diffConfig compared [" << fromEntries.size() << "] to [" << toEntries.size() << "] widgets, changes[" << changes.size() << "]";
+		
+		return changes;
+	}
+	
+	std::vector<ConfigChange> diffConfig(ConfigSnapshot const & from, CameraWrapper& cameraWrapper, bool includeReadOnly /* = false */)
+	{
+		return diffConfig(from, ConfigSnapshot::capture(cameraWrapper), includeReadOnly);
+	}
+}
@@ -0,0 +1,991 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCONFIG
+
+#include <gphoto2pp/config_snapshot.hpp>
+
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/config_transaction.hpp>
+#include <gphoto2pp/helper_widgets.hpp>
+#include <gphoto2pp/exceptions.hpp>
+
+#include <gphoto2pp/text_widget.hpp>
+#include <gphoto2pp/range_widget.hpp>
+#include <gphoto2pp/toggle_widget.hpp>
+#include <gphoto2pp/radio_widget.hpp>
+#include <gphoto2pp/menu_widget.hpp>
+#include <gphoto2pp/date_widget.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <unordered_map>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		// Binary format: "GPCS", a version byte and the number of entries, followed by the entries
+		char const SnapshotMagic[4] = {'G', 'P', 'C', 'S'};
+		std::uint8_t const SnapshotVersion = 1;
+		
+		bool isValueWidget(CameraWidgetTypeWrapper type)
+		{
+			switch(type)
+			{
+				case CameraWidgetTypeWrapper::Text:
+				case CameraWidgetTypeWrapper::Range:
+				case CameraWidgetTypeWrapper::Toggle:
+				case CameraWidgetTypeWrapper::Radio:
+				case CameraWidgetTypeWrapper::Menu:
+				case CameraWidgetTypeWrapper::Date:
+					return true;
+				default:
+					return false;
+			}
+		}
+		
+		char const * widgetTypeToString(CameraWidgetTypeWrapper type)
+		{
+			switch(type)
+			{
+				case CameraWidgetTypeWrapper::Text:		return "text";
+				case CameraWidgetTypeWrapper::Range:	return "range";
+				case CameraWidgetTypeWrapper::Toggle:	return "toggle";
+				case CameraWidgetTypeWrapper::Radio:	return "radio";
+				case CameraWidgetTypeWrapper::Menu:		return "menu";
+				case CameraWidgetTypeWrapper::Date:		return "date";
+				default:								return "";
+			}
+		}
+		
+		CameraWidgetTypeWrapper stringToWidgetType(std::string const & type)
+		{
+			for(auto candidate : {CameraWidgetTypeWrapper::Text, CameraWidgetTypeWrapper::Range, CameraWidgetTypeWrapper::Toggle, CameraWidgetTypeWrapper::Radio, CameraWidgetTypeWrapper::Menu, CameraWidgetTypeWrapper::Date})
+			{
+				if(type == widgetTypeToString(candidate))
+				{
+					return candidate;
+				}
+			}
+			
+			throw exceptions::ArgumentException("Invalid config snapshot, unknown widget type '" + type + "'");
+		}
+		
+		std::string nameFromPath(std::string const & path)
+		{
+			auto separator = path.rfind('/');
+			
+			return (separator == std::string::npos) ? path : path.substr(separator + 1);
+		}
+		
+		bool isStringType(CameraWidgetTypeWrapper type)
+		{
+			return type == CameraWidgetTypeWrapper::Text || type == CameraWidgetTypeWrapper::Radio || type == CameraWidgetTypeWrapper::Menu;
+		}
+		
+		bool isChoicesType(CameraWidgetTypeWrapper type)
+		{
+			return type == CameraWidgetTypeWrapper::Radio || type == CameraWidgetTypeWrapper::Menu;
+		}
+		
+		int findChoiceIndex(ChoicesWidget const & widget, std::string const & value)
+		{
+			try
+			{
+				return widget.stringToChoice(value);
+			}
+			catch(exceptions::ValueOutOfLimits const &)
+			{
+				return -1;
+			}
+		}
+		
+		// Compares the live widget to the saved value, without creating any wrapper
+		bool valueMatches(WidgetView const & widget, ConfigSnapshotEntry const & entry)
+		{
+			switch(entry.Type)
+			{
+				case CameraWidgetTypeWrapper::Text:
+				case CameraWidgetTypeWrapper::Radio:
+				case CameraWidgetTypeWrapper::Menu:
+				{
+					auto value = widget.getStringValue();
+					return entry.StringValue == (value == nullptr ? "" : value);
+				}
+				case CameraWidgetTypeWrapper::Range:
+					return widget.getFloatValue() == entry.FloatValue;
+				case CameraWidgetTypeWrapper::Toggle:
+				case CameraWidgetTypeWrapper::Date:
+					return widget.getIntValue() == entry.IntValue;
+				default:
+					return true;
+			}
+		}
+		
+		void stageEntry(ConfigTransaction& transaction, WidgetView const & widget, ConfigSnapshotEntry const & entry)
+		{
+			switch(entry.Type)
+			{
+				case CameraWidgetTypeWrapper::Text:
+					transaction.stage(widget.toWidget<TextWidget>(), entry.StringValue);
+					break;
+				case CameraWidgetTypeWrapper::Range:
+					transaction.stage(widget.toWidget<RangeWidget>(), entry.FloatValue);
+					break;
+				case CameraWidgetTypeWrapper::Toggle:
+					transaction.stage(widget.toWidget<ToggleWidget>(), entry.IntValue);
+					break;
+				case CameraWidgetTypeWrapper::Radio:
+				{
+					auto radioWidget = widget.toWidget<RadioWidget>();
+					radioWidget.stringToChoice(entry.StringValue); // Throws if the camera doesn't offer this value
+					transaction.stage(radioWidget, entry.StringValue);
+					break;
+				}
+				case CameraWidgetTypeWrapper::Menu:
+				{
+					auto menuWidget = widget.toWidget<MenuWidget>();
+					menuWidget.stringToChoice(entry.StringValue); // Throws if the camera doesn't offer this value
+					transaction.stage(menuWidget, entry.StringValue);
+					break;
+				}
+				case CameraWidgetTypeWrapper::Date:
+					transaction.stage(widget.toWidget<DateWidget>(), static_cast<std::time_t>(entry.IntValue));
+					break;
+				default:
+					break;
+			}
+		}
+		
+		void writeUInt(std::string& out, std::uint32_t value, int bytes)
+		{
+			for(int i = 0; i < bytes; ++i)
+			{
+				out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+			}
+		}
+		
+		void writeString(std::string& out, std::string const & value)
+		{
+			writeUInt(out, static_cast<std::uint32_t>(value.size()), 4);
+			out.append(value);
+		}
+		
+		class BinaryReader
+		{
+		public:
+			BinaryReader(std::string const & data) : m_data(data), m_position{0} { }
+			
+			std::uint32_t readUInt(int bytes)
+			{
+				require(bytes);
+				
+				std::uint32_t value = 0;
+				for(int i = 0; i < bytes; ++i)
+				{
+					value |= static_cast<std::uint32_t>(static_cast<unsigned char>(m_data[m_position++])) << (8 * i);
+				}
+				return value;
+			}
+			
+			std::string readString()
+			{
+				auto length = readUInt(4);
+				require(length);
+				
+				std::string value = m_data.substr(m_position, length);
+				m_position += length;
+				return value;
+			}
+			
+			bool atEnd() const
+			{
+				return m_position == m_data.size();
+			}
+			
+		private:
+			void require(std::size_t bytes) const
+			{
+				if(m_data.size() - m_position < bytes)
+				{
+					throw exceptions::ArgumentException("Invalid config snapshot, the data is truncated");
+				}
+			}
+			
+			std::string const & m_data;
+			std::size_t m_position;
+		};
+		
+		void writeJsonString(std::ostream& out, std::string const & value)
+		{
+			out << '"';
+			for(auto c : value)
+			{
+				switch(c)
+				{
+					case '"':	out << "\\\""; break;
+					case '\\':	out << "\\\\"; break;
+					case '\n':	out << "\\n"; break;
+					case '\r':	out << "\\r"; break;
+					case '\t':	out << "\\t"; break;
+					default:
+						if(static_cast<unsigned char>(c) < 0x20)
+						{
+							char escaped[8];
+							std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+							out << escaped;
+						}
+						else
+						{
+							out << c;
+						}
+						break;
+				}
+			}
+			out << '"';
+		}
+		
+		// JSON has no literal for these, so they are written as the strings JavaScript uses
+		void writeJsonFloat(std::ostream& out, float value)
+		{
+			if(std::isnan(value))
+			{
+				out << "\"NaN\"";
+			}
+			else if(std::isinf(value))
+			{
+				out << (value < 0 ? "\"-Infinity\"" : "\"Infinity\"");
+			}
+			else
+			{
+				out << value;
+			}
+		}
+		
+		// Just enough of a JSON reader for the documents written by ConfigSnapshot::toJson(), unknown members are skipped
+		class JsonReader
+		{
+		public:
+			JsonReader(std::string const & json) : m_json(json), m_position{0} { }
+			
+			char peek()
+			{
+				skipWhitespace();
+				
+				if(m_position >= m_json.size())
+				{
+					fail("unexpected end of document");
+				}
+				
+				return m_json[m_position];
+			}
+			
+			void expect(char c)
+			{
+				if(peek() != c)
+				{
+					fail(std::string("expected '") + c + "'");
+				}
+				++m_position;
+			}
+			
+			// Consumes the character if it is the next one
+			bool consume(char c)
+			{
+				if(peek() == c)
+				{
+					++m_position;
+					return true;
+				}
+				return false;
+			}
+			
+			std::string readString()
+			{
+				expect('"');
+				
+				std::string value;
+				while(m_position < m_json.size() && m_json[m_position] != '"')
+				{
+					char c = m_json[m_position++];
+					
+					if(c != '\\')
+					{
+						value.push_back(c);
+						continue;
+					}
+					
+					if(m_position >= m_json.size())
+					{
+						break;
+					}
+					
+					c = m_json[m_position++];
+					switch(c)
+					{
+						case 'b':	value.push_back('\b'); break;
+						case 'f':	value.push_back('\f'); break;
+						case 'n':	value.push_back('\n'); break;
+						case 'r':	value.push_back('\r'); break;
+						case 't':	value.push_back('\t'); break;
+						case 'u':	appendCodePoint(value); break;
+						default:	value.push_back(c); break;
+					}
+				}
+				
+				expect('"');
+				
+				return value;
+			}
+			
+			double readNumber()
+			{
+				skipWhitespace();
+				
+				auto start = m_position;
+				while(m_position < m_json.size() && m_json[m_position] != '\0' && std::strchr("0123456789+-.eE", m_json[m_position]) != nullptr)
+				{
+					++m_position;
+				}
+				
+				// A stream with the classic locale, so the decimal point doesn't depend on the user's locale
+				std::istringstream in(m_json.substr(start, m_position - start));
+				in.imbue(std::locale::classic());
+				
+				double value = 0;
+				in >> value;
+				
+				if(start == m_position || in.fail() || !in.eof())
+				{
+					fail("expected a number");
+				}
+				
+				return value;
+			}
+			
+			bool readBool()
+			{
+				if(readLiteral("true"))
+				{
+					return true;
+				}
+				else if(readLiteral("false"))
+				{
+					return false;
+				}
+				
+				fail("expected true or false");
+				return false;
+			}
+			
+			void skipValue()
+			{
+				switch(peek())
+				{
+					case '"':
+						readString();
+						break;
+					case '{':
+						++m_position;
+						if(!consume('}'))
+						{
+							do
+							{
+								readString();
+								expect(':');
+								skipValue();
+							} while(consume(','));
+							expect('}');
+						}
+						break;
+					case '[':
+						++m_position;
+						if(!consume(']'))
+						{
+							do
+							{
+								skipValue();
+							} while(consume(','));
+							expect(']');
+						}
+						break;
+					case 't':
+					case 'f':
+						readBool();
+						break;
+					case 'n':
+						if(!readLiteral("null"))
+						{
+							fail("unexpected value");
+						}
+						break;
+					default:
+						readNumber();
+						break;
+				}
+			}
+			
+			bool atEnd()
+			{
+				skipWhitespace();
+				return m_position == m_json.size();
+			}
+			
+			void fail(std::string const & reason)
+			{
+				throw exceptions::ArgumentException("Invalid config snapshot JSON at offset " + std::to_string(m_position) + ", " + reason);
+			}
+			
+		private:
+			void skipWhitespace()
+			{
+				while(m_position < m_json.size() && std::isspace(static_cast<unsigned char>(m_json[m_position])))
+				{
+					++m_position;
+				}
+			}
+			
+			bool readLiteral(char const * literal)
+			{
+				skipWhitespace();
+				
+				auto length = std::strlen(literal);
+				if(m_json.compare(m_position, length, literal) == 0)
+				{
+					m_position += length;
+					return true;
+				}
+				return false;
+			}
+			
+			void appendCodePoint(std::string& value)
+			{
+				if(m_position + 4 > m_json.size())
+				{
+					fail("truncated \\u escape");
+				}
+				
+				unsigned int codePoint = 0;
+				for(auto end = m_position + 4; m_position < end; ++m_position)
+				{
+					auto const c = m_json[m_position];
+					
+					codePoint <<= 4;
+					if(c >= '0' && c <= '9')
+					{
+						codePoint |= static_cast<unsigned int>(c - '0');
+					}
+					else if(c >= 'a' && c <= 'f')
+					{
+						codePoint |= static_cast<unsigned int>(c - 'a' + 10);
+					}
+					else if(c >= 'A' && c <= 'F')
+					{
+						codePoint |= static_cast<unsigned int>(c - 'A' + 10);
+					}
+					else
+					{
+						fail("invalid \\u escape");
+					}
+				}
+				
+				// Encode as UTF-8 (surrogate pairs are not produced by toJson(), so they aren't combined)
+				if(codePoint < 0x80)
+				{
+					value.push_back(static_cast<char>(codePoint));
+				}
+				else if(codePoint < 0x800)
+				{
+					value.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+					value.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+				}
+				else
+				{
+					value.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+					value.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+					value.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+				}
+			}
+			
+			std::string const & m_json;
+			std::size_t m_position;
+		};
+		
+		// The reverse of writeJsonFloat(...) for the values written as strings
+		float jsonStringToFloat(std::string const & value, JsonReader& reader)
+		{
+			if(value == "NaN")
+			{
+				return std::numeric_limits<float>::quiet_NaN();
+			}
+			else if(value == "Infinity")
+			{
+				return std::numeric_limits<float>::infinity();
+			}
+			else if(value == "-Infinity")
+			{
+				return -std::numeric_limits<float>::infinity();
+			}
+			
+			reader.fail("expected a number");
+			return 0;
+		}
+	}
+	
+	ConfigSnapshot::ConfigSnapshot()
+		: m_entries{}
+	{
+	}
+	
+	ConfigSnapshot ConfigSnapshot::capture(NonValueWidget const & rootWidget)
+	{
+		ConfigSnapshot snapshot;
+		
+		helper::visitWidgets(rootWidget, [&snapshot](WidgetView const & widget, helper::WidgetPath const & parentPath)
+		{
+			auto type = widget.getType();
+			
+			if(!detail::isValueWidget(type))
+			{
+				return helper::VisitResult::Continue;
+			}
+			
+			ConfigSnapshotEntry entry{};
+			entry.Name = widget.getName();
+			entry.Path = parentPath.toString() + "/" + entry.Name;
+			entry.Type = type;
+			entry.ReadOnly = widget.isReadOnly();
+			entry.ChoiceIndex = -1;
+			
+			switch(type)
+			{
+				case CameraWidgetTypeWrapper::Text:
+				case CameraWidgetTypeWrapper::Radio:
+				case CameraWidgetTypeWrapper::Menu:
+				{
+					auto value = widget.getStringValue();
+					entry.StringValue = (value == nullptr) ? "" : value;
+					
+					if(type == CameraWidgetTypeWrapper::Radio)
+					{
+						entry.ChoiceIndex = detail::findChoiceIndex(widget.toWidget<RadioWidget>(), entry.StringValue);
+					}
+					else if(type == CameraWidgetTypeWrapper::Menu)
+					{
+						entry.ChoiceIndex = detail::findChoiceIndex(widget.toWidget<MenuWidget>(), entry.StringValue);
+					}
+					break;
+				}
+				case CameraWidgetTypeWrapper::Range:
+					entry.FloatValue = widget.getFloatValue();
+					break;
+				default:
+					entry.IntValue = widget.getIntValue();
+					break;
+			}
+			
+			snapshot.m_entries.push_back(std::move(entry));
+			
+			return helper::VisitResult::Continue;
+		});
+		
+		FILE_LOG(logDEBUG) << "ConfigSnapshot captured [" << snapshot.m_entries.size() << "] widgets";
+		
+		return snapshot;
+	}
+	
+	ConfigSnapshot ConfigSnapshot::capture(CameraWrapper& cameraWrapper)
+	{
+		return capture(cameraWrapper.getConfig());
+	}
+	
+	std::vector<ConfigSnapshotEntry> const & ConfigSnapshot::getEntries() const
+	{
+		return m_entries;
+	}
+	
+	ConfigSnapshotEntry const * ConfigSnapshot::find(std::string const & name) const
+	{
+		bool isFullName = !name.empty() && name[0] == '/';
+		
+		for(auto const & entry : m_entries)
+		{
+			if((isFullName ? entry.Path : entry.Name) == name)
+			{
+				return &entry;
+			}
+		}
+		
+		return nullptr;
+	}
+	
+	std::string ConfigSnapshot::toBinary() const
+	{
+		std::string out;
+		out.reserve(16 + m_entries.size() * 48);
+		
+		out.append(detail::SnapshotMagic, sizeof(detail::SnapshotMagic));
+		detail::writeUInt(out, detail::SnapshotVersion, 1);
+		detail::writeUInt(out, static_cast<std::uint32_t>(m_entries.size()), 4);
+		
+		for(auto const & entry : m_entries)
+		{
+			detail::writeUInt(out, static_cast<std::uint32_t>(entry.Type), 1);
+			detail::writeUInt(out, entry.ReadOnly ? 1 : 0, 1);
+			detail::writeString(out, entry.Path);
+			
+			switch(entry.Type)
+			{
+				case CameraWidgetTypeWrapper::Radio:
+				case CameraWidgetTypeWrapper::Menu:
+					detail::writeUInt(out, static_cast<std::uint32_t>(entry.ChoiceIndex), 4);
+					detail::writeString(out, entry.StringValue);
+					break;
+				case CameraWidgetTypeWrapper::Text:
+					detail::writeString(out, entry.StringValue);
+					break;
+				case CameraWidgetTypeWrapper::Range:
+				{
+					std::uint32_t bits = 0;
+					std::memcpy(&bits, &entry.FloatValue, sizeof(bits));
+					detail::writeUInt(out, bits, 4);
+					break;
+				}
+				default:
+					detail::writeUInt(out, static_cast<std::uint32_t>(entry.IntValue), 4);
+					break;
+			}
+		}
+		
+		return out;
+	}
+	
+	ConfigSnapshot ConfigSnapshot::fromBinary(std::string const & data)
+	{
+		if(data.size() < sizeof(detail::SnapshotMagic) || data.compare(0, sizeof(detail::SnapshotMagic), detail::SnapshotMagic, sizeof(detail::SnapshotMagic)) != 0)
+		{
+			throw exceptions::ArgumentException("Invalid config snapshot, the data doesn't start with the snapshot signature");
+		}
+		
+		detail::BinaryReader reader(data);
+		reader.readUInt(sizeof(detail::SnapshotMagic));
+		
+		auto version = reader.readUInt(1);
+		if(version != detail::SnapshotVersion)
+		{
+			throw exceptions::ArgumentException("Invalid config snapshot, unsupported version " + std::to_string(version));
+		}
+		
+		auto count = reader.readUInt(4);
+		
+		ConfigSnapshot snapshot;
+		
+		for(std::uint32_t i = 0; i < count; ++i)
+		{
+			ConfigSnapshotEntry entry{};
+			entry.Type = static_cast<CameraWidgetTypeWrapper>(reader.readUInt(1));
+			entry.ReadOnly = reader.readUInt(1) != 0;
+			entry.Path = reader.readString();
+			entry.Name = detail::nameFromPath(entry.Path);
+			entry.ChoiceIndex = -1;
+			
+			if(!detail::isValueWidget(entry.Type))
+			{
+				throw exceptions::ArgumentException("Invalid config snapshot, '" + entry.Path + "' has an unknown widget type");
+			}
+			
+			switch(entry.Type)
+			{
+				case CameraWidgetTypeWrapper::Radio:
+				case CameraWidgetTypeWrapper::Menu:
+					entry.ChoiceIndex = static_cast<int>(reader.readUInt(4));
+					entry.StringValue = reader.readString();
+					break;
+				case CameraWidgetTypeWrapper::Text:
+					entry.StringValue = reader.readString();
+					break;
+				case CameraWidgetTypeWrapper::Range:
+				{
+					auto bits = reader.readUInt(4);
+					std::memcpy(&entry.FloatValue, &bits, sizeof(bits));
+					break;
+				}
+				default:
+					entry.IntValue = static_cast<int>(reader.readUInt(4));
+					break;
+			}
+			
+			snapshot.m_entries.push_back(std::move(entry));
+		}
+		
+		if(!reader.atEnd())
+		{
+			throw exceptions::ArgumentException("Invalid config snapshot, unexpected data after the last entry");
+		}
+		
+		return snapshot;
+	}
+	
+	std::string ConfigSnapshot::toJson() const
+	{
+		std::ostringstream out;
+		out.imbue(std::locale::classic());
+		out.precision(9); // Enough digits for a float to survive the round trip
+		
+		out << "{\n\t\"version\": " << static_cast<int>(detail::SnapshotVersion) << ",\n\t\"widgets\": [";
+		
+		bool first = true;
+		for(auto const & entry : m_entries)
+		{
+			out << (first ? "\n" : ",\n") << "\t\t{\"path\": ";
+			detail::writeJsonString(out, entry.Path);
+			out << ", \"type\": \"" << detail::widgetTypeToString(entry.Type) << "\", \"readonly\": " << (entry.ReadOnly ? "true" : "false") << ", \"value\": ";
+			
+			switch(entry.Type)
+			{
+				case CameraWidgetTypeWrapper::Text:
+				case CameraWidgetTypeWrapper::Radio:
+				case CameraWidgetTypeWrapper::Menu:
+					detail::writeJsonString(out, entry.StringValue);
+					break;
+				case CameraWidgetTypeWrapper::Range:
+					detail::writeJsonFloat(out, entry.FloatValue);
+					break;
+				default:
+					out << entry.IntValue;
+					break;
+			}
+			
+			if(detail::isChoicesType(entry.Type))
+			{
+				out << ", \"choice\": " << entry.ChoiceIndex;
+			}
+			
+			out << "}";
+			first = false;
+		}
+		
+		out << "\n\t]\n}\n";
+		
+		return out.str();
+	}
+	
+	ConfigSnapshot ConfigSnapshot::fromJson(std::string const & json)
+	{
+		detail::JsonReader reader(json);
+		ConfigSnapshot snapshot;
+		
+		reader.expect('{');
+		if(!reader.consume('}'))
+		{
+			do
+			{
+				auto key = reader.readString();
+				reader.expect(':');
+				
+				if(key == "version")
+				{
+					if(static_cast<int>(reader.readNumber()) != detail::SnapshotVersion)
+					{
+						reader.fail("unsupported version");
+					}
+				}
+				else if(key == "widgets")
+				{
+					reader.expect('[');
+					if(reader.consume(']'))
+					{
+						continue;
+					}
+					
+					do
+					{
+						ConfigSnapshotEntry entry{};
+						entry.ChoiceIndex = -1;
+						
+						bool hasType = false;
+						bool hasStringValue = false;
+						std::string stringValue;
+						double numberValue = 0;
+						
+						reader.expect('{');
+						if(!reader.consume('}'))
+						{
+							do
+							{
+								auto member = reader.readString();
+								reader.expect(':');
+								
+								if(member == "path")
+								{
+									entry.Path = reader.readString();
+								}
+								else if(member == "type")
+								{
+									entry.Type = detail::stringToWidgetType(reader.readString());
+									hasType = true;
+								}
+								else if(member == "readonly")
+								{
+									entry.ReadOnly = reader.readBool();
+								}
+								else if(member == "value")
+								{
+									// The type member may come later, so keep the value in whichever form it has
+									if(reader.peek() == '"')
+									{
+										stringValue = reader.readString();
+										hasStringValue = true;
+									}
+									else
+									{
+										numberValue = reader.readNumber();
+									}
+								}
+								else if(member == "choice")
+								{
+									entry.ChoiceIndex = static_cast<int>(reader.readNumber());
+								}
+								else
+								{
+									reader.skipValue();
+								}
+							} while(reader.consume(','));
+							reader.expect('}');
+						}
+						
+						if(!hasType || entry.Path.empty())
+						{
+							reader.fail("a widget is missing its path or type");
+						}
+						
+						entry.Name = detail::nameFromPath(entry.Path);
+						
+						if(detail::isStringType(entry.Type))
+						{
+							entry.StringValue = std::move(stringValue);
+						}
+						else if(entry.Type == CameraWidgetTypeWrapper::Range)
+						{
+							entry.FloatValue = hasStringValue ? detail::jsonStringToFloat(stringValue, reader) : static_cast<float>(numberValue);
+						}
+						else
+						{
+							entry.IntValue = static_cast<int>(numberValue);
+						}
+						
+						snapshot.m_entries.push_back(std::move(entry));
+					} while(reader.consume(','));
+					reader.expect(']');
+				}
+				else
+				{
+					reader.skipValue();
+				}
+			} while(reader.consume(','));
+		}
+		reader.expect('}');
+		
+		if(!reader.atEnd())
+		{
+			reader.fail("unexpected data after the document");
+		}
+		
+		return snapshot;
+	}
+	
+	int ConfigSnapshot::restoreTo(CameraWrapper& cameraWrapper) const
+	{
+		// Some drivers repeat a path, the occurrences are matched to the widgets in order (read only ones too, so they keep their place)
+		struct Occurrences
+		{
+			std::vector<ConfigSnapshotEntry const *> Entries;
+			std::size_t Next = 0;
+		};
+		
+		std::unordered_map<std::string, Occurrences> entriesByPath;
+		entriesByPath.reserve(m_entries.size());
+		
+		for(auto const & entry : m_entries)
+		{
+			entriesByPath[entry.Path].Entries.push_back(&entry);
+		}
+		
+		ConfigTransaction transaction(cameraWrapper);
+		
+		helper::visitWidgets(transaction.getRootWidget(), [&entriesByPath, &transaction](WidgetView const & widget, helper::WidgetPath const & parentPath)
+		{
+			auto type = widget.getType();
+			
+			if(!detail::isValueWidget(type))
+			{
+				return helper::VisitResult::Continue;
+			}
+			
+			auto item = entriesByPath.find(parentPath.toString() + "/" + widget.getName());
+			
+			if(item == std::end(entriesByPath) || item->second.Next == item->second.Entries.size())
+			{
+				return helper::VisitResult::Continue;
+			}
+			
+			auto const & entry = *item->second.Entries[item->second.Next++];
+			
+			if(entry.ReadOnly)
+			{
+				return helper::VisitResult::Continue;
+			}
+			
+			if(entry.Type != type || widget.isReadOnly())
+			{
+				FILE_LOG(logWARN) << "ConfigSnapshot skipping '" << entry.Path << "', the widget changed type or became read only";
+			}
+			else if(!detail::valueMatches(widget, entry))
+			{
+				try
+				{
+					detail::stageEntry(transaction, widget, entry);
+				}
+				catch(exceptions::ValueOutOfLimits const & e)
+				{
+					FILE_LOG(logWARN) << "ConfigSnapshot skipping '" << entry.Path << "', " << e.what();
+				}
+			}
+			
+			return helper::VisitResult::Continue;
+		});
+		
+		return transaction.commit();
+	}
+}
@@ -0,0 +1,126 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCONFIG
+
+#include <gphoto2pp/config_transaction.hpp>
+
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/helper_widgets.hpp>
+#include <gphoto2pp/widget_view.hpp>
+
+#include <gphoto2pp/log.h>
+
+namespace gphoto2pp
+{
+	ConfigTransaction::ConfigTransaction(CameraWrapper& cameraWrapper)
+		: m_cameraWrapper(cameraWrapper)
+		, m_rootWidget{cameraWrapper.getConfig()}
+		, m_pending{}
+	{
+	}
+	
+	WindowWidget const & ConfigTransaction::getRootWidget() const
+	{
+		return m_rootWidget;
+	}
+	
+	int ConfigTransaction::countChanged() const
+	{
+		int changed = 0;
+		
+		for(auto const & pending : m_pending)
+		{
+			if(pending.IsChanged())
+			{
+				++changed;
+			}
+		}
+		
+		return changed;
+	}
+	
+	int ConfigTransaction::commit()
+	{
+		for(auto& pending : m_pending)
+		{
+			if(!pending.IsChanged())
+			{
+				// Same value as the snapshot, so the driver doesn't need to send it
+				pending.Widget.setChanged(false);
+			}
+		}
+		
+		// Every widget still flagged is written, including the ones changed directly through getRootWidget()
+		std::vector<std::string> changedWidgetNames;
+		
+		helper::visitWidgets(m_rootWidget, [&changedWidgetNames](WidgetView const & widget, helper::WidgetPath const &)
+		{
+			if(widget.isChanged())
+			{
+				changedWidgetNames.emplace_back(widget.getName());
+			}
+			
+			return helper::VisitResult::Continue;
+		});
+		
+		int written = static_cast<int>(changedWidgetNames.size());
+		
+		FILE_LOG(logDEBUG) << "ConfigTransaction commit - staged[" << m_pending.size() << "], written[" << written << "]";
+		
+		if(written > 0)
+		{
+			m_cameraWrapper.setConfig(m_rootWidget, changedWidgetNames);
+		}
+		
+		m_pending.clear();
+		
+		return written;
+	}
+	
+	void ConfigTransaction::rollback()
+	{
+		for(auto& pending : m_pending)
+		{
+			pending.Restore();
+			pending.Widget.setChanged(false);
+		}
+		
+		m_pending.clear();
+	}
+	
+	bool ConfigTransaction::isStaged(CameraWidgetWrapper const & widget) const
+	{
+		for(auto const & pending : m_pending)
+		{
+			if(pending.Widget.getPtr() == widget.getPtr())
+			{
+				return true;
+			}
+		}
+		
+		return false;
+	}
+}
@@ -0,0 +1,149 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/context_cancellation.hpp>
+
+#include <gphoto2pp/helper_gphoto2.hpp>
+
+#include <gphoto2pp/log.h>
+
+namespace gphoto2
+{
+#include <gphoto2/gphoto2-context.h>
+#include <gphoto2/gphoto2-result.h>
+}
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		// The C callback given to the context, data is the ContextCancellation
+		gphoto2::GPContextFeedback contextCancel(gphoto2::GPContext* context, void* data)
+		{
+			return static_cast<ContextCancellation*>(data)->isCancelled() ? gphoto2::GP_CONTEXT_FEEDBACK_CANCEL : gphoto2::GP_CONTEXT_FEEDBACK_OK;
+		}
+	}
+	
+	ContextCancellation::Scope::Scope(ContextCancellation& cancellation, CancellationToken const & token)
+		: m_cancellation(cancellation)
+		, m_previous{CancellationToken::none()}
+	{
+		if(token.isCancelled())
+		{
+			gphoto2pp::checkResponse(GP_ERROR_CANCEL, "ContextCancellation::Scope - cancelled before starting");
+		}
+		
+		std::lock_guard<std::mutex> lock{m_cancellation.m_mutex};
+		m_previous = m_cancellation.m_current;
+		m_cancellation.m_current = token;
+		m_cancellation.m_cancelCurrent = false;
+	}
+	
+	ContextCancellation::Scope::~Scope()
+	{
+		std::lock_guard<std::mutex> lock{m_cancellation.m_mutex};
+		m_cancellation.m_current = m_previous;
+		m_cancellation.m_cancelCurrent = false;
+	}
+	
+	ContextCancellation::ContextCancellation()
+		: m_context{}
+		, m_mutex{}
+		, m_current{CancellationToken::none()}
+		, m_currentCall{0}
+		, m_cancelCurrent{false}
+	{
+	}
+	
+	ContextCancellation::~ContextCancellation()
+	{
+		if(auto context = m_context.lock())
+		{
+			gphoto2::gp_context_set_cancel_func(context.get(), nullptr, nullptr);
+		}
+	}
+	
+	void ContextCancellation::attach(std::shared_ptr<gphoto2::_GPContext> const & context)
+	{
+		m_context = context;
+		
+		gphoto2::gp_context_set_cancel_func(context.get(), &detail::contextCancel, this);
+	}
+	
+	void ContextCancellation::cancelCurrent()
+	{
+		FILE_LOG(logINFO) << "ContextCancellation cancelling the current operation";
+		
+		m_cancelCurrent = true;
+	}
+	
+	void ContextCancellation::beginCall(std::uint64_t callId)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_currentCall = callId;
+		
+		// A cancel meant for the previous call must not reach this one
+		m_cancelCurrent = false;
+	}
+	
+	void ContextCancellation::endCall(std::uint64_t callId)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		if(m_currentCall == callId)
+		{
+			m_currentCall = 0;
+		}
+	}
+	
+	bool ContextCancellation::cancelCall(std::uint64_t callId)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		if(callId == 0 || m_currentCall != callId)
+		{
+			return false;
+		}
+		
+		FILE_LOG(logINFO) << "ContextCancellation cancelling call [" << callId << "]";
+		
+		m_cancelCurrent = true;
+		return true;
+	}
+	
+	bool ContextCancellation::isCancelled() const
+	{
+		if(m_cancelCurrent)
+		{
+			return true;
+		}
+		
+		std::lock_guard<std::mutex> lock{m_mutex};
+		return m_current.isCancelled();
+	}
+}
@@ -0,0 +1,187 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/context_progress.hpp>
+
+#include <gphoto2pp/log.h>
+
+#ifdef GPHOTO_LESS_25
+#include <cstdarg>
+#include <cstdio>
+#endif
+
+namespace gphoto2
+{
+#include <gphoto2/gphoto2-context.h>
+}
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		// The C callbacks given to the context, data is the ContextProgress
+#ifdef GPHOTO_LESS_25
+		unsigned int contextProgressStart(gphoto2::GPContext* context, float target, const char* format, va_list args, void* data)
+		{
+			char text[256];
+			std::vsnprintf(text, sizeof(text), format, args);
+			
+			return static_cast<ContextProgress*>(data)->start(target, text);
+		}
+#else
+		unsigned int contextProgressStart(gphoto2::GPContext* context, float target, const char* text, void* data)
+		{
+			return static_cast<ContextProgress*>(data)->start(target, text != nullptr ? text : "");
+		}
+#endif
+		
+		void contextProgressUpdate(gphoto2::GPContext* context, unsigned int id, float current, void* data)
+		{
+			static_cast<ContextProgress*>(data)->update(id, current);
+		}
+		
+		void contextProgressStop(gphoto2::GPContext* context, unsigned int id, void* data)
+		{
+			static_cast<ContextProgress*>(data)->stop(id);
+		}
+		
+		double unitsPerSecond(float units, std::chrono::steady_clock::duration duration)
+		{
+			auto const seconds = std::chrono::duration<double>(duration).count();
+			
+			return seconds > 0 ? units / seconds : 0;
+		}
+	}
+	
+	ContextProgress::ContextProgress()
+		: m_context{}
+		, m_mutex{}
+		, m_operations{}
+		, m_nextId{1}
+		, m_events{}
+	{
+	}
+	
+	ContextProgress::~ContextProgress()
+	{
+		if(auto context = m_context.lock())
+		{
+			gphoto2::gp_context_set_progress_funcs(context.get(), nullptr, nullptr, nullptr, nullptr);
+		}
+	}
+	
+	void ContextProgress::attach(std::shared_ptr<gphoto2::_GPContext> const & context)
+	{
+		m_context = context;
+		
+		gphoto2::gp_context_set_progress_funcs(context.get(), &detail::contextProgressStart, &detail::contextProgressUpdate, &detail::contextProgressStop, this);
+	}
+	
+	observer::Registration ContextProgress::subscribe(ProgressEventType const & event, std::function<void(const ProgressEvent&)> func)
+	{
+		return m_events.registerObserver(event, std::move(func));
+	}
+	
+	unsigned int ContextProgress::start(float target, std::string text)
+	{
+		auto const now = std::chrono::steady_clock::now();
+		ProgressEvent event;
+		
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			
+			event = ProgressEvent{m_nextId++, std::move(text), target, 0, 0, 0, std::chrono::microseconds::zero()};
+			m_operations[event.Id] = Operation{event, now, now};
+		}
+		
+		FILE_LOG(logDEBUG) << "ContextProgress start - " << event.Id << " '" << event.Text << "' target " << event.Target;
+		
+		m_events(ProgressEventType::Started, event);
+		
+		return event.Id;
+	}
+	
+	void ContextProgress::update(unsigned int id, float current)
+	{
+		auto const now = std::chrono::steady_clock::now();
+		ProgressEvent event;
+		
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			
+			auto it = m_operations.find(id);
+			if(it == m_operations.end())
+			{
+				return;
+			}
+			
+			auto& operation = it->second;
+			
+			// Updates can come faster than the clock resolution, the previous rate is kept then
+			if(now > operation.LastTime)
+			{
+				operation.Event.InstantRate = detail::unitsPerSecond(current - operation.Event.Current, now - operation.LastTime);
+				operation.LastTime = now;
+			}
+			
+			operation.Event.Current = current;
+			operation.Event.AverageRate = detail::unitsPerSecond(current, now - operation.StartTime);
+			operation.Event.Elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - operation.StartTime);
+			
+			event = operation.Event;
+		}
+		
+		m_events(ProgressEventType::Updated, event);
+	}
+	
+	void ContextProgress::stop(unsigned int id)
+	{
+		auto const now = std::chrono::steady_clock::now();
+		ProgressEvent event;
+		
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			
+			auto it = m_operations.find(id);
+			if(it == m_operations.end())
+			{
+				return;
+			}
+			
+			event = std::move(it->second.Event);
+			event.AverageRate = detail::unitsPerSecond(event.Current, now - it->second.StartTime);
+			event.Elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - it->second.StartTime);
+			
+			m_operations.erase(it);
+		}
+		
+		FILE_LOG(logDEBUG) << "ContextProgress stop - " << event.Id << " " << event.Current << " units in " << event.Elapsed.count() << "us";
+		
+		m_events(ProgressEventType::Stopped, event);
+	}
+}
@@ -0,0 +1,159 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/exposure_bracketing.hpp>
+
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/exceptions.hpp>
+
+#include <gphoto2pp/log.h>
+
+namespace gphoto2pp
+{
+	ExposureBracketing::ExposureBracketing(CameraWrapper& cameraWrapper, std::string const & widgetName /* = "shutterspeed" */)
+		: m_cameraWrapper(cameraWrapper)
+		, m_rootWidget{cameraWrapper.getConfig()}
+		, m_setting{m_rootWidget.getChildByName<ChoicesWidget>(widgetName)}
+		, m_originalChoice{m_setting.getChoice()}
+		, m_choices{}
+	{
+	}
+	
+	void ExposureBracketing::setValues(std::vector<std::string> const & values)
+	{
+		std::vector<int> choices;
+		choices.reserve(values.size());
+		
+		for(auto const & value : values)
+		{
+			choices.push_back(m_setting.stringToChoice(value));
+		}
+		
+		m_choices = std::move(choices);
+	}
+	
+	void ExposureBracketing::setSteps(int frames, int step)
+	{
+		if(step < 1)
+		{
+			throw exceptions::ArgumentException("The step must be at least one choice");
+		}
+		
+		// Computed wide, so a huge step can't overflow into the valid range
+		long long first = m_originalChoice - static_cast<long long>(frames / 2) * step;
+		long long last = first + static_cast<long long>(frames - 1) * step;
+		
+		if(frames < 1 || first < 0 || last >= m_setting.countChoices())
+		{
+			throw exceptions::IndexOutOfRange("The bracket goes past the setting's first or last choice");
+		}
+		
+		std::vector<int> choices;
+		choices.reserve(frames);
+		
+		for(int i = 0; i < frames; ++i)
+		{
+			choices.push_back(static_cast<int>(first + static_cast<long long>(i) * step));
+		}
+		
+		m_choices = std::move(choices);
+	}
+	
+	std::vector<std::string> ExposureBracketing::getValues() const
+	{
+		std::vector<std::string> values;
+		values.reserve(m_choices.size());
+		
+		for(auto choice : m_choices)
+		{
+			values.push_back(m_setting.choiceToString(choice));
+		}
+		
+		return values;
+	}
+	
+	BracketResult ExposureBracketing::run(CapturePipeline::FileHandler fileHandler, bool deleteFromCamera /* = true */)
+	{
+		BracketResult result{getValues(), {}, {}, std::chrono::milliseconds(0)};
+		result.Files.reserve(m_choices.size());
+		result.FrameIntervals.reserve(m_choices.size());
+		
+		auto start = std::chrono::steady_clock::now();
+		auto previousTrigger = start;
+		
+		try
+		{
+			CapturePipeline pipeline(m_cameraWrapper, std::move(fileHandler), deleteFromCamera);
+			
+			for(auto choice : m_choices)
+			{
+				m_setting.setChoice(choice);
+				m_cameraWrapper.setConfig(m_setting, {m_setting.getName()});
+				
+				auto trigger = std::chrono::steady_clock::now();
+				result.FrameIntervals.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(trigger - previousTrigger));
+				previousTrigger = trigger;
+				
+				result.Files.push_back(pipeline.capture());
+			}
+			
+			pipeline.flush();
+		}
+		catch(...)
+		{
+			FILE_LOG(logERROR) << "ExposureBracketing failed at frame [" << result.Files.size() << "], restoring the original value";
+			
+			try
+			{
+				m_setting.setChoice(m_originalChoice);
+				m_cameraWrapper.setConfig(m_setting, {m_setting.getName()});
+			}
+			catch(std::exception const & e)
+			{
+				FILE_LOG(logERROR) << "ExposureBracketing couldn't restore the original value: " << e.what();
+			}
+			throw;
+		}
+		
+		result.Total = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		
+		if(!result.FrameIntervals.empty())
+		{
+			result.FrameIntervals.front() = std::chrono::milliseconds(0);
+		}
+		
+		m_setting.setChoice(m_originalChoice);
+		m_cameraWrapper.setConfig(m_setting, {m_setting.getName()});
+		
+		for(std::size_t i = 0; i < result.Files.size(); ++i)
+		{
+			FILE_LOG(logDEBUG) << "ExposureBracketing frame [" << i << "] value[" << result.Values[i] << "] interval[" << result.FrameIntervals[i].count() << "ms]";
+		}
+		
+		return result;
+	}
+}
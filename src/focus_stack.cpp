@@ -0,0 +1,269 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/focus_stack.hpp>
+
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/camera_file_wrapper.hpp>
+#include <gphoto2pp/camera_widget_type_wrapper.hpp>
+#include <gphoto2pp/range_widget.hpp>
+#include <gphoto2pp/range_widget_range.hpp>
+#include <gphoto2pp/radio_widget.hpp>
+#include <gphoto2pp/exceptions.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <future>
+#include <thread>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		ToggleWidget getViewfinder(WindowWidget const & rootWidget)
+		{
+			try
+			{
+				return rootWidget.getChildByName<ToggleWidget>("viewfinder");
+			}
+			catch(exceptions::GPhoto2ppException const &)
+			{
+				// Canon EOS cameras name it differently
+				return rootWidget.getChildByName<ToggleWidget>("eosviewfinder");
+			}
+		}
+		
+		std::chrono::milliseconds millisecondsSince(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		}
+	}
+	
+	FocusStack::FocusStack(CameraWrapper& cameraWrapper)
+		: m_cameraWrapper(cameraWrapper)
+		, m_rootWidget{cameraWrapper.getConfig()}
+		, m_viewfinder{detail::getViewfinder(m_rootWidget)}
+		, m_rangeDrive{}
+		, m_radioDrive{}
+		, m_focusDriveNames{}
+		, m_steps{10}
+		, m_rangeStep{512}
+		, m_choiceStep{"Far 2"}
+		, m_settleTime{100}
+		, m_usePreview{true}
+	{
+		auto focusDrive = m_rootWidget.getView().getChildByName("manualfocusdrive");
+		
+		switch(focusDrive.getType())
+		{
+			case CameraWidgetTypeWrapper::Range:
+				m_rangeDrive.reset(new RangeWidget(focusDrive.toWidget<RangeWidget>()));
+				break;
+			case CameraWidgetTypeWrapper::Radio:
+				m_radioDrive.reset(new RadioWidget(focusDrive.toWidget<RadioWidget>()));
+				break;
+			default:
+				throw exceptions::InvalidWidgetType("The manualfocusdrive widget should be a Range or Radio widget");
+		}
+		
+		m_focusDriveNames.emplace_back(focusDrive.getName());
+	}
+	
+	void FocusStack::setSteps(int steps)
+	{
+		if(steps < 1)
+		{
+			throw exceptions::ArgumentException("The stack needs at least one step");
+		}
+		
+		m_steps = steps;
+	}
+	
+	void FocusStack::setRangeStep(float step)
+	{
+		if(step == 0)
+		{
+			throw exceptions::ArgumentException("A focus step of zero doesn't move the focus");
+		}
+		
+		if(m_rangeDrive)
+		{
+			auto range = m_rangeDrive->getRange();
+			
+			if(step < range.Min || step > range.Max)
+			{
+				throw exceptions::ValueOutOfLimits("The focus step " + std::to_string(step) + " is outside of the focus drive's range");
+			}
+		}
+		
+		m_rangeStep = step;
+	}
+	
+	void FocusStack::setChoiceStep(std::string const & choice)
+	{
+		if(m_radioDrive)
+		{
+			// Throws if the drive has no such choice
+			m_radioDrive->stringToChoice(choice);
+		}
+		
+		m_choiceStep = choice;
+	}
+	
+	void FocusStack::setSettleTime(std::chrono::milliseconds settleTime)
+	{
+		m_settleTime = settleTime;
+	}
+	
+	void FocusStack::setUsePreview(bool usePreview)
+	{
+		m_usePreview = usePreview;
+	}
+	
+	FocusStackResult FocusStack::run(CapturePipeline::FileHandler fileHandler)
+	{
+		FocusStackResult result{{}, std::chrono::milliseconds(0)};
+		result.Steps.reserve(m_steps);
+		
+		setViewfinder(1);
+		
+		auto start = std::chrono::steady_clock::now();
+		
+		try
+		{
+			if(m_usePreview)
+			{
+				// The previous preview is handled while the focus moves, waiting on it keeps the order and at most one image in memory
+				std::future<void> handled;
+				
+				for(int i = 0; i < m_steps; ++i)
+				{
+					auto timing = driveFocus();
+					
+					auto captureStart = std::chrono::steady_clock::now();
+					auto cameraFile = m_cameraWrapper.capturePreview();
+					timing.Capture = detail::millisecondsSince(captureStart);
+					
+					if(handled.valid())
+					{
+						handled.get();
+					}
+					
+					if(fileHandler)
+					{
+						CameraFilePathWrapper cameraFilePath{"preview_" + std::to_string(i) + ".jpg", ""};
+						handled = std::async(std::launch::async, [&fileHandler, cameraFilePath](CameraFileWrapper file) { fileHandler(cameraFilePath, file); }, std::move(cameraFile));
+					}
+					
+					result.Steps.push_back(timing);
+				}
+				
+				if(handled.valid())
+				{
+					handled.get();
+				}
+			}
+			else
+			{
+				CapturePipeline pipeline(m_cameraWrapper, std::move(fileHandler));
+				
+				for(int i = 0; i < m_steps; ++i)
+				{
+					auto timing = driveFocus();
+					
+					auto captureStart = std::chrono::steady_clock::now();
+					pipeline.capture();
+					timing.Capture = detail::millisecondsSince(captureStart);
+					
+					result.Steps.push_back(timing);
+				}
+				
+				pipeline.flush();
+			}
+		}
+		catch(...)
+		{
+			FILE_LOG(logERROR) << "FocusStack failed at step [" << result.Steps.size() << "]";
+			
+			try
+			{
+				setViewfinder(0);
+			}
+			catch(std::exception const & e)
+			{
+				FILE_LOG(logERROR) << "FocusStack couldn't turn the viewfinder off: " << e.what();
+			}
+			throw;
+		}
+		
+		result.Total = detail::millisecondsSince(start);
+		
+		setViewfinder(0);
+		
+		return result;
+	}
+	
+	FocusStepTiming FocusStack::driveFocus()
+	{
+		auto driveStart = std::chrono::steady_clock::now();
+		
+		CameraWidgetWrapper* focusDrive = nullptr;
+		
+		if(m_rangeDrive)
+		{
+			m_rangeDrive->setValue(m_rangeStep);
+			focusDrive = m_rangeDrive.get();
+		}
+		else
+		{
+			m_radioDrive->setValue(m_choiceStep);
+			focusDrive = m_radioDrive.get();
+		}
+		
+		// The drive is relative, but gphoto2 doesn't flag a widget set to the value it already has, so we flag it ourselves
+		focusDrive->setChanged(true);
+		m_cameraWrapper.setConfig(*focusDrive, m_focusDriveNames);
+		
+		auto driveEnd = std::chrono::steady_clock::now();
+		
+		// Only what is left of the settle time once the command returned
+		std::this_thread::sleep_until(driveStart + m_settleTime);
+		
+		FocusStepTiming timing{std::chrono::duration_cast<std::chrono::milliseconds>(driveEnd - driveStart), detail::millisecondsSince(driveEnd), std::chrono::milliseconds(0)};
+		
+		FILE_LOG(logDEBUG) << "FocusStack drive[" << timing.Drive.count() << "ms] settle[" << timing.Settle.count() << "ms]";
+		
+		return timing;
+	}
+	
+	void FocusStack::setViewfinder(int value)
+	{
+		m_viewfinder.setValue(value);
+		m_viewfinder.setChanged(true);
+		m_cameraWrapper.setConfig(m_viewfinder, {m_viewfinder.getName()});
+	}
+}
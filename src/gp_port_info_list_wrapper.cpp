@@ -35,6 +35,7 @@ namespace gphoto2pp
 {
 
 	GPPortInfoListWrapper::GPPortInfoListWrapper()
+		: m_portInfoList{nullptr}
 	{
 		gphoto2pp::checkResponse(gphoto2::gp_port_info_list_new(&m_portInfoList),"gp_port_info_list_new");
 		
@@ -43,8 +44,45 @@ namespace gphoto2pp
 
 	GPPortInfoListWrapper::~GPPortInfoListWrapper()
 	{
-		// Destructors should never throw exceptions. Hence the silent response
-		gphoto2pp::checkResponseSilent(gphoto2::gp_port_info_list_free(m_portInfoList),"gp_port_info_list_free");
+		if(m_portInfoList != nullptr)
+		{
+			// Destructors should never throw exceptions. Hence the silent response
+			gphoto2pp::checkResponseSilent(gphoto2::gp_port_info_list_free(m_portInfoList),"gp_port_info_list_free");
+			m_portInfoList = nullptr;
+		}
+	}
+	
+	GPPortInfoListWrapper::GPPortInfoListWrapper(GPPortInfoListWrapper&& other)
+		: m_portInfoList{other.m_portInfoList}
+	{
+		other.m_portInfoList = nullptr;
+	}
+	
+	GPPortInfoListWrapper& GPPortInfoListWrapper::operator=(GPPortInfoListWrapper&& other)
+	{
+		if(this != &other)
+		{
+			// Release current objects resource
+			if(m_portInfoList != nullptr)
+			{
+				gphoto2pp::checkResponse(gphoto2::gp_port_info_list_free(m_portInfoList),"gp_port_info_list_free");
+			}
+			
+			// Steal or "move" the other objects resource
+			m_portInfoList = other.m_portInfoList;
+			
+			// Unreference the other objects resource, so it's destructor doesn't unreference it
+			other.m_portInfoList = nullptr;
+		}
+		return *this;
+	}
+	
+	GPPortInfoListWrapper const & GPPortInfoListWrapper::getShared()
+	{
+		// C++11 guarantees this is only initialized once, even with concurrent callers
+		static GPPortInfoListWrapper const sharedPortInfoList;
+		
+		return sharedPortInfoList;
 	}
 	
 	gphoto2::_GPPortInfoList* GPPortInfoListWrapper::getPtr() const
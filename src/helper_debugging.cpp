@@ -22,15 +22,28 @@
  * If not, see http://www.gnu.org/licenses
  */
 
+#define FILELOG_SUBSYSTEM logsysPORT
+
 #include <gphoto2pp/helper_debugging.hpp>
 
 #include <gphoto2pp/helper_gphoto2.hpp>
+#include <gphoto2pp/exceptions.hpp>
+
+#include <gphoto2pp/log.h>
 
 namespace gphoto2
 {
 #include <gphoto2/gphoto2.h>
 }
 
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+
 namespace gphoto2pp
 {
 	namespace helper
@@ -41,70 +54,230 @@ namespace gphoto2pp
 			{
 				static PortLoggingEventsManager PortLogEventHandler;
 				
-				// From Here http://stackoverflow.com/questions/2342162/stdstring-formatting-like-sprintf
-				inline std::string strformat(char const * fmt, va_list vl){
-					int size = 512;
-					char* buffer = 0;
-					buffer = new char[size];
-					//va_list vl;
-					//va_start(vl, fmt);
-					int nsize = vsnprintf(buffer, size, fmt, vl);
-					if(size<=nsize){ //fail delete buffer and try again
-						delete[] buffer;
-						buffer = 0;
-						buffer = new char[nsize+1]; //+1 for /0
-						nsize = vsnprintf(buffer, size, fmt, vl);
-					}
-					std::string ret(buffer);
-					va_end(vl);
-					delete[] buffer;
-					return ret;
-				}
+				struct PortLogRingRecord
+				{
+					std::chrono::system_clock::time_point Time;
+					LogLevelWrapper Level;
+					char Domain[32];
+					char Text[224];
+				};
 				
-				inline std::string strformat(char const * fmt, ...){
-					va_list vl;
-					va_start(vl, fmt);
-					return strformat(fmt, vl);
+				// Copies as much of the text as fits, without reading past the part which fits
+				template <std::size_t N>
+				void copyPortLogText(char (&destination)[N], char const * source)
+				{
+					auto const length = source ? strnlen(source, N - 1) : 0;
+					std::memcpy(destination, source, length);
+					destination[length] = '\0';
 				}
 				
+				class PortLogRing
+				{
+				public:
+					~PortLogRing()
+					{
+						stop();
+					}
+					
+					void start(LogLevelWrapper const & level, std::size_t capacity, std::string dumpFile);
+					void stop();
+					
+					// Called by libgphoto2, on the thread logging
+					PortLogRingRecord* beginRecord(std::unique_lock<std::mutex>& lock, LogLevelWrapper level, char const * domain)
+					{
+						lock = std::unique_lock<std::mutex>{m_mutex};
+						
+						if(m_records.empty())
+						{
+							return nullptr;
+						}
+						
+						auto& record = m_records[m_next];
+						m_next = (m_next + 1) % m_records.size();
+						m_count = std::min(m_count + 1, m_records.size());
+						
+						record.Time = std::chrono::system_clock::now();
+						record.Level = level;
+						copyPortLogText(record.Domain, domain);
+						
+						return &record;
+					}
+					
+					std::vector<PortLogRecord> records() const
+					{
+						std::lock_guard<std::mutex> lock{m_mutex};
+						
+						std::vector<PortLogRecord> records;
+						records.reserve(m_count);
+						
+						for(std::size_t i = 0; i < m_count; ++i)
+						{
+							auto const & record = m_records[(m_next + m_records.size() - m_count + i) % m_records.size()];
+							records.push_back(PortLogRecord{record.Time, record.Level, record.Domain, record.Text});
+						}
+						
+						return records;
+					}
+					
+					std::string dumpFile() const
+					{
+						std::lock_guard<std::mutex> lock{m_mutex};
+						return m_dumpFile;
+					}
+					
+				private:
+					mutable std::mutex m_mutex;
+					std::vector<PortLogRingRecord> m_records;
+					std::size_t m_next = 0;
+					std::size_t m_count = 0;
+					std::string m_dumpFile;
+					int m_id = 0;
+				};
+				
+				static PortLogRing PortLogRingHandler;
+				
 #ifdef GPHOTO_LESS_25
 				static void errordumper(gphoto2::GPLogLevel level, const char *domain, const char *format, va_list args, void *data)
-				{
-					std::string str = strformat(format, args);
 #else
 				static void errordumper(gphoto2::GPLogLevel level, const char *domain, const char *str, void *data)
+#endif
 				{
+					auto const messageLevel = static_cast<LogLevelWrapper>(level);
+					auto const mostVerbose = static_cast<int>(LogLevelWrapper::Data);
+					
+					// A subscriber to a level also receives the more severe levels, so the message goes to its own level and the more verbose ones
+					bool subscribed = false;
+					for(int subscribedLevel = level; subscribedLevel <= mostVerbose && !subscribed; ++subscribedLevel)
+					{
+						subscribed = PortLogEventHandler.hasObservers(static_cast<LogLevelWrapper>(subscribedLevel));
+					}
+					
+					if(!subscribed)
+					{
+						return;
+					}
+					
+#ifdef GPHOTO_LESS_25
+					// The arguments may be passed on to the other log functions, so we only use a copy
+					char buffer[1024];
+					va_list copy;
+					va_copy(copy, args);
+					int const length = std::vsnprintf(buffer, sizeof(buffer), format, copy);
+					va_end(copy);
+					
+					std::string str;
+					if(length >= static_cast<int>(sizeof(buffer)))
+					{
+						str.resize(length + 1);
+						va_copy(copy, args);
+						std::vsnprintf(&str[0], str.size(), format, copy);
+						va_end(copy);
+						str.resize(length);
+					}
+					else if(length > 0)
+					{
+						str.assign(buffer, length);
+					}
 #endif
+					
+					std::string const domainText(domain);
+					std::string const text(str);
+					
+					for(int subscribedLevel = level; subscribedLevel <= mostVerbose; ++subscribedLevel)
+					{
+						PortLogEventHandler(static_cast<LogLevelWrapper>(subscribedLevel), messageLevel, domainText, text, data);
+					}
+				}
 				
-					switch(level)
+#ifdef GPHOTO_LESS_25
+				static void portLogRingDumper(gphoto2::GPLogLevel level, const char *domain, const char *format, va_list args, void *data)
+				{
+					std::unique_lock<std::mutex> lock;
+					if(auto record = PortLogRingHandler.beginRecord(lock, static_cast<LogLevelWrapper>(level), domain))
 					{
-						case gphoto2::GP_LOG_ERROR:
-						{
-							PortLogEventHandler(LogLevelWrapper::Error, static_cast<LogLevelWrapper>(level), std::string(domain), std::string(str), data);
-						}
-						case gphoto2::GP_LOG_VERBOSE:
-						{
-							PortLogEventHandler(LogLevelWrapper::Verbose, static_cast<LogLevelWrapper>(level), std::string(domain), std::string(str), data);
-						}
-						case gphoto2::GP_LOG_DEBUG:
-						{
-							PortLogEventHandler(LogLevelWrapper::Debug, static_cast<LogLevelWrapper>(level), std::string(domain), std::string(str), data);
-						}
-						case gphoto2::GP_LOG_DATA:
-						{
-							PortLogEventHandler(LogLevelWrapper::Data, static_cast<LogLevelWrapper>(level), std::string(domain), std::string(str), data);
-						}
-						default:
-						{
-							break;
-						}
+						// Formatted straight into the record
+						va_list copy;
+						va_copy(copy, args);
+						std::vsnprintf(record->Text, sizeof(record->Text), format, copy);
+						va_end(copy);
+					}
+				}
+#else
+				static void portLogRingDumper(gphoto2::GPLogLevel level, const char *domain, const char *str, void *data)
+				{
+					std::unique_lock<std::mutex> lock;
+					if(auto record = PortLogRingHandler.beginRecord(lock, static_cast<LogLevelWrapper>(level), domain))
+					{
+						copyPortLogText(record->Text, str);
+					}
+				}
+#endif
+				
+				void PortLogRing::start(LogLevelWrapper const & level, std::size_t capacity, std::string dumpFile)
+				{
+					stop();
+					
+					{
+						std::lock_guard<std::mutex> lock{m_mutex};
+						m_records.assign(std::max<std::size_t>(capacity, 1), PortLogRingRecord{});
+						m_next = 0;
+						m_count = 0;
+						m_dumpFile = std::move(dumpFile);
 					}
 					
-					//~ // Not sure if this is necessary, as they can log their own messages...
-					//~ auto now = std::chrono::high_resolution_clock::now();
-					//~ auto us = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
-					//~ auto s = std::chrono::duration_cast<std::chrono::seconds>(us);
-					//~ FILE_LOG(logERROR) << (s.count() % 60) << "." << (us.count() % 1000000) << ": " << str;
+					// Not under the lock, a failure dumps the ring
+					auto const id = checkResponse(gphoto2::gp_log_add_func(static_cast<gphoto2::GPLogLevel>(level), portLogRingDumper, nullptr), "gp_log_add_func");
+					
+					std::lock_guard<std::mutex> lock{m_mutex};
+					m_id = id;
+				}
+				
+				void PortLogRing::stop()
+				{
+					int id = 0;
+					{
+						std::lock_guard<std::mutex> lock{m_mutex};
+						std::swap(id, m_id);
+					}
+					
+					if(id != 0)
+					{
+						checkResponse(gphoto2::gp_log_remove_func(id), "gp_log_remove_func");
+					}
+				}
+				
+				std::string formatPortLogTime(std::chrono::system_clock::time_point time)
+				{
+					auto const t = std::chrono::system_clock::to_time_t(time);
+					auto const milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+					
+					tm r = {};
+					char clock[11];
+					std::strftime(clock, sizeof(clock), "%X", localtime_r(&t, &r));
+					
+					char result[32];
+					std::snprintf(result, sizeof(result), "%s.%03ld", clock, static_cast<long>(milliseconds));
+					return result;
+				}
+				
+				void dumpPortLogRingOnError(std::string const & error)
+				{
+					auto const file = PortLogRingHandler.dumpFile();
+					
+					if(file.empty())
+					{
+						return;
+					}
+					
+					// We're about to throw the real error, this one can only be logged
+					try
+					{
+						dumpPortLogRing(file, error);
+					}
+					catch(std::exception const & e)
+					{
+						FILE_LOG(logERROR) << "Couldn't dump the port log ring - '" << e.what() << "'";
+					}
 				}
 				
 				PortLoggingEventsManager::~PortLoggingEventsManager()
@@ -144,6 +317,50 @@ namespace gphoto2pp
 			{
 				return detail::PortLogEventHandler.registerObserver(event, std::move(func));
 			}
+			
+			void startPortLogRing(LogLevelWrapper const & level, std::size_t capacity, std::string dumpFile)
+			{
+				detail::PortLogRingHandler.start(level, capacity, std::move(dumpFile));
+			}
+			
+			void stopPortLogRing()
+			{
+				detail::PortLogRingHandler.stop();
+			}
+			
+			std::vector<PortLogRecord> getPortLogRecords()
+			{
+				return detail::PortLogRingHandler.records();
+			}
+			
+			void dumpPortLogRing(std::string const & file, std::string const & reason)
+			{
+				static char const * const levelNames[] = {"ERROR", "VERBOSE", "DEBUG", "DATA"};
+				
+				auto const records = getPortLogRecords();
+				
+				std::ofstream out{file, std::ios::trunc};
+				
+				if(!reason.empty())
+				{
+					out << "# " << reason << "\n";
+				}
+				
+				for(auto const & record : records)
+				{
+					auto const level = static_cast<std::size_t>(record.Level);
+					out << detail::formatPortLogTime(record.Time) << " " << (level < 4 ? levelNames[level] : "?") << " " << record.Domain << ": " << record.Text << "\n";
+				}
+				
+				out.flush();
+				
+				if(!out)
+				{
+					throw exceptions::HelperException("Couldn't write the port log ring to '" + file + "'");
+				}
+				
+				FILE_LOG(logINFO) << "Port log ring dumped to '" << file << "' (" << records.size() << " messages)";
+			}
 		}
 	}
 }
@@ -27,6 +27,7 @@
 #include <gphoto2pp/log.h>
 
 #include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/helper_debugging.hpp>
 #include <gphoto2pp/camera_list_wrapper.hpp>
 
 #ifdef GPHOTO_LESS_25
@@ -47,7 +48,10 @@ namespace gphoto2
 #include <gphoto2/gphoto2-version.h>
 }
 
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <utility>
 
 namespace gphoto2pp
 {
@@ -64,11 +68,11 @@ namespace gphoto2pp
 #ifdef GPHOTO_LESS_25
 		//All this logic was added to the gp_camera_autodetect method in 2.5 or greater.
 		
-		// Constructor for this class will load all port drivers
+		// Constructor for this class will load all port drivers, and enumerates the ports, so it has to be a new list to find newly connected cameras
 		GPPortInfoListWrapper portInfoListWrapper;
 		
-		// Loads all the camera drivers we have
-		CameraAbilitiesListWrapper cameraAbilitiesListWrapper;
+		// The camera drivers are only loaded once per process
+		auto const & cameraAbilitiesListWrapper = CameraAbilitiesListWrapper::getShared();
 		
 		auto tempListWrapper = cameraAbilitiesListWrapper.listDetect(portInfoListWrapper);
 		
@@ -99,23 +103,55 @@ namespace gphoto2pp
 		return std::move(cameraListWrapper);
 	}
 	
-	int checkResponse(int result, std::string&& methodName)
+	namespace detail
 	{
-		if(result < 0)
+		struct ResponseErrorCounters
+		{
+			std::mutex Mutex;
+			std::map<std::pair<std::string, int>, std::uint64_t> Counts;
+		};
+		
+		ResponseErrorCounters& responseErrorCounters()
+		{
+			// Errors can be checked while other statics are constructed or destroyed
+			static ResponseErrorCounters counters;
+			return counters;
+		}
+		
+		void throwResponseError(int result, char const * methodName)
 		{
 			std::stringstream errorMessage;
 			errorMessage << methodName << ": failed with return code '" << result << "' and the reason is: '" << gphoto2::gp_result_as_string(result) << "'";
+			
+			// A cancellation was asked for (stopListeningForEvents(), a token or the watchdog), it must not replace the dump of a real failure
+			if(result == GP_ERROR_CANCEL)
+			{
+				FILE_LOG(logDEBUG) << "Cancelled - '"<< errorMessage.str().c_str() << "'";
+				throw exceptions::gphoto2_exception(result, errorMessage.str());
+			}
+			
+			{
+				auto& counters = responseErrorCounters();
+				std::lock_guard<std::mutex> lock{counters.Mutex};
+				++counters.Counts[std::make_pair(std::string(methodName), result)];
+			}
+			
 			FILE_LOG(logERROR) << "Exception Message - '"<< errorMessage.str().c_str() << "'";
+			helper::debugging::detail::dumpPortLogRingOnError(errorMessage.str());
 			throw exceptions::gphoto2_exception(result, errorMessage.str());
 		}
-		return result;
+	}
+	
+	int checkResponse(int result, std::string&& methodName)
+	{
+		return gphoto2pp::checkResponse(result, methodName.c_str());
 	}
 
-	int checkResponseSilent(int result, std::string&& methodName)
+	int checkResponseSilent(int result, char const * methodName)
 	{
 		try
 		{
-			gphoto2pp::checkResponse(result, std::move(methodName));
+			gphoto2pp::checkResponse(result, methodName);
 		}
 		catch(const exceptions::gphoto2_exception& e)
 		{
@@ -132,6 +168,27 @@ namespace gphoto2pp
 		return result;
 	}
 
+	int checkResponseSilent(int result, std::string&& methodName)
+	{
+		return gphoto2pp::checkResponseSilent(result, methodName.c_str());
+	}
+	
+	std::vector<ResponseErrorCount> getResponseErrorCounts()
+	{
+		auto& counters = detail::responseErrorCounters();
+		std::lock_guard<std::mutex> lock{counters.Mutex};
+		
+		std::vector<ResponseErrorCount> counts;
+		counts.reserve(counters.Counts.size());
+		
+		for(auto const & count : counters.Counts)
+		{
+			counts.push_back(ResponseErrorCount{count.first.first, count.first.second, count.second});
+		}
+		
+		return counts;
+	}
+
 	std::string LibraryVersion(bool verbose)
 	{
 		gphoto2::GPVersionVerbosity verbosity = gphoto2::GP_VERSION_SHORT;
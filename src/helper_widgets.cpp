@@ -33,52 +33,132 @@ namespace gphoto2pp
 {
 	namespace helper
 	{
-		void getWidgetSummary(NonValueWidget const & currentWidget, std::string const & parentWidgetPath, std::vector<std::string>& allWidgetNames, bool showFullName, bool onlySpecificWidgetType, CameraWidgetTypeWrapper const & filterByWidgetType)
+		WidgetPath::WidgetPath()
+			: m_segments{}
 		{
-			std::string currentWidgetName{currentWidget.getName()};
+			// Camera trees are only a few levels deep, so this is the only allocation of a traversal
+			m_segments.reserve(8);
+		}
+		
+		std::size_t WidgetPath::size() const
+		{
+			return m_segments.size();
+		}
+		
+		char const * WidgetPath::operator[](std::size_t index) const
+		{
+			return m_segments[index];
+		}
+		
+		std::string WidgetPath::toString() const
+		{
+			std::string path;
 			
-			if(showFullName)
+			for(auto segment : m_segments)
 			{
-				currentWidgetName = parentWidgetPath + "/" + currentWidgetName;
+				path += "/";
+				path += segment;
 			}
 			
-			// This means we are logging all widget types, and so we can ignore the filterByWidgetType argument
-			if(onlySpecificWidgetType == false)
-			{
-				allWidgetNames.push_back(currentWidgetName);
-			}
-			else if(filterByWidgetType == currentWidget.getType())
+			return path;
+		}
+		
+		void WidgetPath::push(char const * segment)
+		{
+			m_segments.push_back(segment);
+		}
+		
+		void WidgetPath::pop()
+		{
+			m_segments.pop_back();
+		}
+		
+		namespace detail
+		{
+			// Returns false once the visitor asked to stop
+			bool visitWidget(WidgetView const & currentWidget, WidgetPath& parentPath, bool onlySpecificWidgetType, CameraWidgetTypeWrapper const & filterByWidgetType, WidgetVisitor const & visitor)
 			{
-				allWidgetNames.push_back(currentWidgetName);
+				VisitResult result = VisitResult::Continue;
+				
+				if(onlySpecificWidgetType == false || filterByWidgetType == currentWidget.getType())
+				{
+					result = visitor(currentWidget, parentPath);
+				}
+				
+				if(result == VisitResult::Stop)
+				{
+					return false;
+				}
+				else if(result == VisitResult::SkipChildren)
+				{
+					return true;
+				}
+				
+				int numOfChildren = currentWidget.countChildren();
+				
+				if(numOfChildren > 0)
+				{
+					parentPath.push(currentWidget.getName());
+					
+					for(int i = 0; i < numOfChildren; ++i)
+					{
+						if(!visitWidget(currentWidget.getChild(i), parentPath, onlySpecificWidgetType, filterByWidgetType, visitor))
+						{
+							return false;
+						}
+					}
+					
+					parentPath.pop();
+				}
+				
+				return true;
 			}
 			
-			int numOfChildren = currentWidget.countChildren();
-								
-			for(int i = 0; i < numOfChildren; ++i)
+			std::vector<std::string> getWidgetsNames(NonValueWidget const & parentWidget, bool showFullName, bool onlySpecificWidgetType, CameraWidgetTypeWrapper const & filterByWidgetType)
 			{
-				auto childWidget = currentWidget.getChild<NonValueWidget>(i);
-				getWidgetSummary(childWidget, currentWidgetName, allWidgetNames, showFullName, onlySpecificWidgetType, filterByWidgetType);
+				std::vector<std::string> allWidgetNames{};
+				WidgetPath parentPath;
+				
+				visitWidget(parentWidget.getView(), parentPath, onlySpecificWidgetType, filterByWidgetType, [&allWidgetNames, showFullName](WidgetView const & widget, WidgetPath const & path)
+				{
+					if(showFullName)
+					{
+						allWidgetNames.push_back(path.toString() + "/" + widget.getName());
+					}
+					else
+					{
+						allWidgetNames.push_back(widget.getName());
+					}
+					
+					return VisitResult::Continue;
+				});
+				
+				return allWidgetNames;
 			}
 		}
 		
-		std::vector<std::string> getAllWidgetsNames(NonValueWidget const & parentWidget, bool showFullName /* = false */)
+		bool visitWidgets(NonValueWidget const & parentWidget, WidgetVisitor const & visitor)
 		{
-			std::vector<std::string> allWidgetNames{};
-			
-			getWidgetSummary(parentWidget, std::string{""}, allWidgetNames, showFullName, false, CameraWidgetTypeWrapper::Window); // we could have passed in anything for the widget type because it will be ignored, we just chose Window
+			WidgetPath parentPath;
 			
-			return std::move(allWidgetNames);
+			return detail::visitWidget(parentWidget.getView(), parentPath, false, CameraWidgetTypeWrapper::Window, visitor); // the widget type is ignored when not filtering, we just chose Window
+		}
+		
+		bool visitWidgetsOfType(NonValueWidget const & parentWidget, CameraWidgetTypeWrapper const & filterByWidgetType, WidgetVisitor const & visitor)
+		{
+			WidgetPath parentPath;
 			
-			//~ return getAllWidgetsNamesOfType(parentWidget, CameraWidgetTypeWrapper::Unassigned, showFullName);
+			return detail::visitWidget(parentWidget.getView(), parentPath, true, filterByWidgetType, visitor);
+		}
+		
+		std::vector<std::string> getAllWidgetsNames(NonValueWidget const & parentWidget, bool showFullName /* = false */)
+		{
+			return detail::getWidgetsNames(parentWidget, showFullName, false, CameraWidgetTypeWrapper::Window); // we could have passed in anything for the widget type because it will be ignored, we just chose Window
 		}
 		
 		std::vector<std::string> getAllWidgetsNamesOfType(NonValueWidget const & parentWidget, CameraWidgetTypeWrapper const & filterByWidgetType, bool showFullName /* = false */)
 		{
-			std::vector<std::string> allWidgetNames{};
-			
-			getWidgetSummary(parentWidget, std::string{""}, allWidgetNames, showFullName, true, filterByWidgetType);
-			
-			return std::move(allWidgetNames);
+			return detail::getWidgetsNames(parentWidget, showFullName, true, filterByWidgetType);
 		}
 	}
 }
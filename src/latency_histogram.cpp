@@ -0,0 +1,255 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <gphoto2pp/latency_histogram.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		std::uint64_t toLatencyMicroseconds(std::chrono::steady_clock::duration duration)
+		{
+			auto const microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+			return microseconds > 0 ? static_cast<std::uint64_t>(microseconds) : 0;
+		}
+	}
+	
+	LatencyHistogram::LatencyHistogram()
+		: m_buckets{}
+		, m_count{0}
+		, m_sum{0}
+		, m_max{0}
+	{
+		for(auto& bucket : m_buckets)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+	
+	void LatencyHistogram::record(std::chrono::microseconds latency)
+	{
+		auto const microseconds = static_cast<std::uint64_t>(std::max<std::chrono::microseconds::rep>(latency.count(), 0));
+		
+		m_buckets[bucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+		m_count.fetch_add(1, std::memory_order_relaxed);
+		m_sum.fetch_add(microseconds, std::memory_order_relaxed);
+		
+		auto max = m_max.load(std::memory_order_relaxed);
+		while(microseconds > max && !m_max.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+		{
+		}
+	}
+	
+	LatencySnapshot LatencyHistogram::snapshot() const
+	{
+		// The buckets are read one by one, so they are counted again rather than trusting m_count
+		std::array<std::uint64_t, BucketCount> buckets;
+		std::uint64_t count = 0;
+		
+		for(std::size_t i = 0; i < BucketCount; ++i)
+		{
+			buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+			count += buckets[i];
+		}
+		
+		LatencySnapshot snapshot{count, std::chrono::microseconds{0}, std::chrono::microseconds{0}, std::chrono::microseconds{0}, std::chrono::microseconds{m_max.load(std::memory_order_relaxed)}};
+		
+		if(count == 0)
+		{
+			return snapshot;
+		}
+		
+		snapshot.Mean = std::chrono::microseconds{m_sum.load(std::memory_order_relaxed) / std::max<std::uint64_t>(m_count.load(std::memory_order_relaxed), 1)};
+		
+		// The smallest bucket which reaches the rank, ceil(percentile * count)
+		auto const percentile = [&buckets, count] (std::uint64_t perHundred)
+		{
+			auto const rank = std::max<std::uint64_t>((count * perHundred + 99) / 100, 1);
+			std::uint64_t seen = 0;
+			
+			for(std::size_t i = 0; i < BucketCount; ++i)
+			{
+				seen += buckets[i];
+				if(seen >= rank)
+				{
+					return bucketValue(i);
+				}
+			}
+			
+			return bucketValue(BucketCount - 1);
+		};
+		
+		// A bucket's middle can be past the largest latency in it
+		auto const max = static_cast<std::uint64_t>(snapshot.Max.count());
+		snapshot.P50 = std::chrono::microseconds{std::min(percentile(50), max)};
+		snapshot.P99 = std::chrono::microseconds{std::min(percentile(99), max)};
+		
+		return snapshot;
+	}
+	
+	std::size_t LatencyHistogram::bucketIndex(std::uint64_t microseconds)
+	{
+		if(microseconds < 8)
+		{
+			return static_cast<std::size_t>(microseconds);
+		}
+		
+		// The power of two, then which quarter of it
+		std::size_t exponent = 0;
+		while(exponent < 63 && (microseconds >> (exponent + 1)) != 0)
+		{
+			++exponent;
+		}
+		
+		auto const quarter = static_cast<std::size_t>((microseconds >> (exponent - 2)) & 3);
+		
+		return std::min<std::size_t>(8 + (exponent - 3) * 4 + quarter, BucketCount - 1);
+	}
+	
+	std::uint64_t LatencyHistogram::bucketValue(std::size_t index)
+	{
+		if(index < 8)
+		{
+			return index;
+		}
+		
+		auto const exponent = 3 + (index - 8) / 4;
+		auto const quarter = (index - 8) % 4;
+		auto const width = std::uint64_t{1} << (exponent - 2);
+		
+		return (4 + quarter) * width + width / 2;
+	}
+	
+	OperationLatencies::Timer::Timer()
+		: m_entry{nullptr}
+		, m_start{}
+		, m_locked{}
+	{
+	}
+	
+	OperationLatencies::Timer::Timer(Entry* entry)
+		: m_entry{entry}
+		, m_start{std::chrono::steady_clock::now()}
+		, m_locked{}
+	{
+	}
+	
+	OperationLatencies::Timer::~Timer()
+	{
+		// A call which never got the lock didn't do any I/O
+		if(m_entry != nullptr && m_locked != std::chrono::steady_clock::time_point{})
+		{
+			m_entry->LockWait.record(std::chrono::microseconds{detail::toLatencyMicroseconds(m_locked - m_start)});
+			m_entry->Io.record(std::chrono::microseconds{detail::toLatencyMicroseconds(std::chrono::steady_clock::now() - m_locked)});
+		}
+	}
+	
+	OperationLatencies::Timer::Timer(Timer&& other)
+		: m_entry{other.m_entry}
+		, m_start{other.m_start}
+		, m_locked{other.m_locked}
+	{
+		other.m_entry = nullptr;
+	}
+	
+	void OperationLatencies::Timer::locked()
+	{
+		if(m_entry != nullptr)
+		{
+			m_locked = std::chrono::steady_clock::now();
+		}
+	}
+	
+	OperationLatencies::OperationLatencies()
+		: m_entries{}
+		, m_size{0}
+		, m_addMutex{}
+	{
+	}
+	
+	OperationLatencies::Timer OperationLatencies::begin(char const * operation)
+	{
+		return Timer{find(operation)};
+	}
+	
+	std::vector<OperationLatencySnapshot> OperationLatencies::snapshot() const
+	{
+		std::vector<OperationLatencySnapshot> snapshots;
+		
+		auto const size = m_size.load(std::memory_order_acquire);
+		snapshots.reserve(size);
+		
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			auto const & entry = m_entries[i];
+			snapshots.push_back(OperationLatencySnapshot{entry.Operation.load(std::memory_order_relaxed), entry.LockWait.snapshot(), entry.Io.snapshot()});
+		}
+		
+		return snapshots;
+	}
+	
+	OperationLatencies::Entry* OperationLatencies::find(char const * operation)
+	{
+		auto const matches = [operation] (Entry const & entry)
+		{
+			auto const name = entry.Operation.load(std::memory_order_relaxed);
+			return name == operation || std::strcmp(name, operation) == 0;
+		};
+		
+		// Entries are only ever added, and published through m_size
+		auto size = m_size.load(std::memory_order_acquire);
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			if(matches(m_entries[i]))
+			{
+				return &m_entries[i];
+			}
+		}
+		
+		std::lock_guard<std::mutex> lock{m_addMutex};
+		
+		// Another thread may have added it in the meantime
+		for(auto const current = m_size.load(std::memory_order_relaxed); size < current; ++size)
+		{
+			if(matches(m_entries[size]))
+			{
+				return &m_entries[size];
+			}
+		}
+		
+		if(size == MaxOperations)
+		{
+			return nullptr;
+		}
+		
+		m_entries[size].Operation.store(operation, std::memory_order_relaxed);
+		m_size.store(size + 1, std::memory_order_release);
+		
+		return &m_entries[size];
+	}
+}
@@ -0,0 +1,129 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <gphoto2pp/property_changed_event.hpp>
+
+#include <cctype>
+#include <cstring>
+
+namespace gphoto2pp
+{
+	namespace detail
+	{
+		struct PropertyWidgetName
+		{
+			int PropertyCode;
+			char const * WidgetName;
+		};
+		
+		// The standard PTP device properties (PTP 1.0, section 13) and the widget names the ptp2 driver gives them
+		PropertyWidgetName const StandardProperties[] =
+		{
+			{0x5001, "batterylevel"},
+			{0x5003, "imagesize"},
+			{0x5004, "imagequality"},
+			{0x5005, "whitebalance"},
+			{0x5007, "f-number"},
+			{0x5008, "focallength"},
+			{0x500A, "focusmode"},
+			{0x500B, "exposuremetermode"},
+			{0x500C, "flashmode"},
+			{0x500D, "shutterspeed"},
+			{0x500E, "expprogram"},
+			{0x500F, "iso"},
+			{0x5010, "exposurecompensation"},
+			{0x5011, "datetime"},
+			{0x5013, "capturemode"},
+			{0x501C, "focusmetermode"},
+		};
+		
+		char const PropertyChangedPrefix[] = "PTP Property ";
+		char const PropertyChangedSuffix[] = " changed";
+	}
+	
+	bool parsePropertyChangedEvent(std::string const & eventText, PropertyChangedEvent& event)
+	{
+		int propertyCode = 0;
+		
+		if(!parsePropertyCode(eventText.c_str(), propertyCode))
+		{
+			return false;
+		}
+		
+		event.PropertyCode = propertyCode;
+		event.WidgetName = propertyCodeToWidgetName(propertyCode);
+		
+		return true;
+	}
+	
+	bool parsePropertyCode(char const * eventText, int& propertyCode)
+	{
+		auto const prefixLength = std::strlen(detail::PropertyChangedPrefix);
+		
+		if(std::strncmp(eventText, detail::PropertyChangedPrefix, prefixLength) != 0)
+		{
+			return false;
+		}
+		
+		// The driver prints the code with "%04x", so we expect exactly 4 hex digits (the terminating null isn't one)
+		int code = 0;
+		char const * position = eventText + prefixLength;
+		
+		for(; position < eventText + prefixLength + 4; ++position)
+		{
+			char digit = *position;
+			
+			if(!std::isxdigit(static_cast<unsigned char>(digit)))
+			{
+				return false;
+			}
+			
+			code = code * 16 + (std::isdigit(static_cast<unsigned char>(digit)) ? digit - '0' : std::tolower(static_cast<unsigned char>(digit)) - 'a' + 10);
+		}
+		
+		// Newer drivers append the old and new values after "changed", which we don't need
+		if(std::strncmp(position, detail::PropertyChangedSuffix, std::strlen(detail::PropertyChangedSuffix)) != 0)
+		{
+			return false;
+		}
+		
+		propertyCode = code;
+		
+		return true;
+	}
+	
+	std::string propertyCodeToWidgetName(int propertyCode)
+	{
+		for(auto const & property : detail::StandardProperties)
+		{
+			if(property.PropertyCode == propertyCode)
+			{
+				return property.WidgetName;
+			}
+		}
+		
+		return "";
+	}
+}
@@ -0,0 +1,238 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#define FILELOG_SUBSYSTEM logsysCAMERA
+
+#include <gphoto2pp/timelapse_scheduler.hpp>
+
+#include <gphoto2pp/camera_wrapper.hpp>
+
+#include <gphoto2pp/log.h>
+
+#include <algorithm>
+
+namespace gphoto2pp
+{
+	TimelapseScheduler::TimelapseScheduler(CameraWrapper& cameraWrapper, std::chrono::milliseconds interval, std::size_t frames, CapturePipeline::FileHandler fileHandler)
+		: m_cameraWrapper(cameraWrapper)
+		, m_interval{interval}
+		, m_frames{frames}
+		, m_fileHandler{std::move(fileHandler)}
+		, m_tolerance{interval / 4}
+		, m_running{false}
+		, m_stopRequested{false}
+		, m_thread{}
+		, m_mutex{}
+		, m_stopCondition{}
+		, m_jitters{}
+		, m_missedSlots{}
+		, m_failed{0}
+	{
+	}
+	
+	TimelapseScheduler::~TimelapseScheduler()
+	{
+		stop();
+	}
+	
+	void TimelapseScheduler::setTolerance(std::chrono::milliseconds tolerance)
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_tolerance = tolerance;
+	}
+	
+	bool TimelapseScheduler::start()
+	{
+		// A schedule which finished by itself left its thread to be joined
+		if(!m_running)
+		{
+			wait();
+		}
+		
+		if(m_thread.joinable())
+		{
+			FILE_LOG(logWARN1) << "TimelapseScheduler already started";
+			return false;
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stopRequested = false;
+			m_jitters.clear();
+			// Only up front for a reasonable count, a huge frame count would throw here
+			m_jitters.reserve(std::min<std::size_t>(m_frames, 10000));
+			m_missedSlots.clear();
+			m_failed = 0;
+		}
+		
+		m_running = true;
+		m_thread = std::thread(&TimelapseScheduler::run, this);
+		
+		return true;
+	}
+	
+	void TimelapseScheduler::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stopRequested = true;
+		}
+		m_stopCondition.notify_all();
+		
+		wait();
+	}
+	
+	void TimelapseScheduler::wait()
+	{
+		if(m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+	
+	bool TimelapseScheduler::isRunning() const
+	{
+		return m_running;
+	}
+	
+	TimelapseStatistics TimelapseScheduler::getStatistics() const
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		auto statistics = computeJitterStatistics(m_jitters);
+		statistics.Missed = m_missedSlots.size() - m_failed;
+		statistics.Failed = m_failed;
+		
+		return statistics;
+	}
+	
+	std::vector<std::size_t> TimelapseScheduler::getMissedSlots() const
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		
+		return m_missedSlots;
+	}
+	
+	TimelapseStatistics TimelapseScheduler::computeJitterStatistics(std::vector<std::chrono::microseconds> jitters)
+	{
+		using std::chrono::microseconds;
+		
+		TimelapseStatistics statistics{jitters.size(), 0, 0, microseconds(0), microseconds(0), microseconds(0), microseconds(0), microseconds(0)};
+		
+		if(jitters.empty())
+		{
+			return statistics;
+		}
+		
+		std::sort(std::begin(jitters), std::end(jitters));
+		
+		microseconds::rep total = 0;
+		for(auto jitter : jitters)
+		{
+			total += jitter.count();
+		}
+		
+		// Nearest rank percentiles
+		auto percentile = [&jitters](std::size_t percent)
+		{
+			auto rank = (percent * jitters.size() + 99) / 100;
+			return jitters[std::max<std::size_t>(rank, 1) - 1];
+		};
+		
+		statistics.MinJitter = jitters.front();
+		statistics.MaxJitter = jitters.back();
+		statistics.MeanJitter = microseconds(total / static_cast<microseconds::rep>(jitters.size()));
+		statistics.P50Jitter = percentile(50);
+		statistics.P99Jitter = percentile(99);
+		
+		return statistics;
+	}
+	
+	void TimelapseScheduler::run()
+	{
+		FILE_LOG(logINFO) << "TimelapseScheduler starting, interval[" << m_interval.count() << "ms] frames[" << m_frames << "]";
+		
+		try
+		{
+			CapturePipeline pipeline(m_cameraWrapper, m_fileHandler);
+			
+			auto start = std::chrono::steady_clock::now();
+			
+			for(std::size_t slot = 0; m_frames == 0 || slot < m_frames; ++slot)
+			{
+				auto planned = start + m_interval * static_cast<std::chrono::milliseconds::rep>(slot);
+				auto tolerance = std::chrono::milliseconds(0);
+				
+				{
+					std::unique_lock<std::mutex> lock{m_mutex};
+					if(m_stopCondition.wait_until(lock, planned, [this]() { return m_stopRequested; }))
+					{
+						break;
+					}
+					
+					// Read under the lock, since setTolerance(...) may be called while running
+					tolerance = m_tolerance;
+				}
+				
+				auto triggered = std::chrono::steady_clock::now();
+				
+				if(triggered - planned > tolerance)
+				{
+					FILE_LOG(logWARN) << "TimelapseScheduler missed slot [" << slot << "] by [" << std::chrono::duration_cast<std::chrono::milliseconds>(triggered - planned).count() << "ms]";
+					
+					std::lock_guard<std::mutex> lock{m_mutex};
+					m_missedSlots.push_back(slot);
+					continue;
+				}
+				
+				try
+				{
+					pipeline.capture();
+					
+					std::lock_guard<std::mutex> lock{m_mutex};
+					m_jitters.push_back(std::chrono::duration_cast<std::chrono::microseconds>(triggered - planned));
+				}
+				catch(std::exception const & e)
+				{
+					FILE_LOG(logERROR) << "TimelapseScheduler slot [" << slot << "] failed: " << e.what();
+					
+					std::lock_guard<std::mutex> lock{m_mutex};
+					m_missedSlots.push_back(slot);
+					++m_failed;
+				}
+			}
+			
+			pipeline.flush();
+		}
+		catch(std::exception const & e)
+		{
+			FILE_LOG(logERROR) << "TimelapseScheduler stopped: " << e.what();
+		}
+		
+		m_running = false;
+		
+		FILE_LOG(logINFO) << "TimelapseScheduler finished";
+	}
+}
@@ -0,0 +1,161 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <gphoto2pp/widget_view.hpp>
+
+#include <gphoto2pp/helper_gphoto2.hpp>
+#include <gphoto2pp/camera_widget_type_wrapper.hpp>
+
+namespace gphoto2
+{
+#include <gphoto2/gphoto2-widget.h>
+}
+
+namespace gphoto2pp
+{
+	WidgetView::WidgetView(gphoto2::_CameraWidget* cameraWidget)
+		: m_cameraWidget{cameraWidget}
+	{
+	}
+	
+	gphoto2::_CameraWidget* WidgetView::getPtr() const
+	{
+		return m_cameraWidget;
+	}
+	
+	char const * WidgetView::getName() const
+	{
+		const char* temp = nullptr;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_name(m_cameraWidget, &temp),"gp_widget_get_name");
+		
+		return temp;
+	}
+	
+	CameraWidgetTypeWrapper WidgetView::getType() const
+	{
+		gphoto2::CameraWidgetType temp;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_type(m_cameraWidget, &temp),"gp_widget_get_type");
+		
+		return static_cast<CameraWidgetTypeWrapper>(temp);
+	}
+	
+	char const * WidgetView::getLabel() const
+	{
+		const char* temp = nullptr;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_label(m_cameraWidget, &temp),"gp_widget_get_label");
+		
+		return temp;
+	}
+	
+	char const * WidgetView::getInfo() const
+	{
+		const char* temp = nullptr;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_info(m_cameraWidget, &temp),"gp_widget_get_info");
+		
+		return temp;
+	}
+	
+	int WidgetView::getId() const
+	{
+		int id = 0;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_id(m_cameraWidget, &id),"gp_widget_get_id");
+		
+		return id;
+	}
+	
+	bool WidgetView::isReadOnly() const
+	{
+		int readonly = 0;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_readonly(m_cameraWidget, &readonly),"gp_widget_get_readonly");
+		
+		return readonly != 0;
+	}
+	
+	bool WidgetView::isChanged() const
+	{
+		// gp_widget_changed returns the flag itself, or an error code
+		int const changed = gphoto2::gp_widget_changed(m_cameraWidget);
+		
+		gphoto2pp::checkResponse(changed,"gp_widget_changed");
+		
+		return changed != 0;
+	}
+	
+	int WidgetView::countChildren() const
+	{
+		return gphoto2pp::checkResponse(gphoto2::gp_widget_count_children(m_cameraWidget),"gp_widget_count_children");
+	}
+	
+	WidgetView WidgetView::getChild(int index) const
+	{
+		gphoto2::_CameraWidget* childWidget = nullptr;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_child(m_cameraWidget, index, &childWidget),"gp_widget_get_child");
+		
+		return WidgetView(childWidget);
+	}
+	
+	WidgetView WidgetView::getChildByName(std::string const & name) const
+	{
+		gphoto2::_CameraWidget* childWidget = nullptr;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_child_by_name(m_cameraWidget, name.c_str(), &childWidget),"gp_widget_get_child_by_name");
+		
+		return WidgetView(childWidget);
+	}
+	
+	char const * WidgetView::getStringValue() const
+	{
+		char* temp = nullptr;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_value(m_cameraWidget, &temp),"gp_widget_get_value");
+		
+		return temp;
+	}
+	
+	int WidgetView::getIntValue() const
+	{
+		int temp = 0;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_value(m_cameraWidget, &temp),"gp_widget_get_value");
+		
+		return temp;
+	}
+	
+	float WidgetView::getFloatValue() const
+	{
+		float temp = 0;
+		
+		gphoto2pp::checkResponse(gphoto2::gp_widget_get_value(m_cameraWidget, &temp),"gp_widget_get_value");
+		
+		return temp;
+	}
+}
@@ -0,0 +1,128 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/abilities_cache.hpp>
+#include <gphoto2pp/camera_abilities_list_wrapper.hpp>
+#include <gphoto2pp/log.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+class AbilitiesCache_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+		std::remove(cacheFile());
+	}
+	
+	void tearDown()
+	{
+		std::remove(cacheFile());
+	}
+	
+	void testKeyIsStable()
+	{
+		gphoto2pp::AbilitiesCache cache(cacheFile(), {"."});
+		
+		TS_ASSERT_EQUALS(cache.computeKey(), cache.computeKey());
+		
+		gphoto2pp::AbilitiesCache otherDirectories(cacheFile(), {"./does-not-exist"});
+		
+		TS_ASSERT_DIFFERS(cache.computeKey(), otherDirectories.computeKey());
+	}
+	
+	void testSaveThenLoad()
+	{
+		gphoto2pp::AbilitiesCache cache(cacheFile(), {"."});
+		
+		gphoto2pp::CameraAbilitiesListWrapper first(cache);
+		
+		TS_ASSERT(!first.getLoadStatistics().FromCache);
+		
+		gphoto2pp::CameraAbilitiesListWrapper second(cache);
+		
+		TS_ASSERT(second.getLoadStatistics().FromCache);
+		TS_ASSERT_EQUALS(first.count(), second.count());
+	}
+	
+	void testStaleKeyIsIgnored()
+	{
+		gphoto2pp::CameraAbilitiesListWrapper first(gphoto2pp::AbilitiesCache(cacheFile(), {"."}));
+		
+		gphoto2pp::CameraAbilitiesListWrapper second(gphoto2pp::AbilitiesCache(cacheFile(), {"./does-not-exist"}));
+		
+		TS_ASSERT(!second.getLoadStatistics().FromCache);
+		TS_ASSERT_EQUALS(first.count(), second.count());
+	}
+	
+	void testCorruptFileIsIgnored()
+	{
+		{
+			std::ofstream output(cacheFile(), std::ios::binary);
+			output << "GPAC this is not a cache";
+		}
+		
+		gphoto2pp::AbilitiesCache cache(cacheFile(), {"."});
+		gphoto2pp::CameraAbilitiesListWrapper abilitiesList(cache);
+		
+		TS_ASSERT(!abilitiesList.getLoadStatistics().FromCache);
+		
+		// The corrupt file was replaced with a valid one
+		gphoto2pp::CameraAbilitiesListWrapper reloaded(cache);
+		
+		TS_ASSERT(reloaded.getLoadStatistics().FromCache);
+	}
+	
+	void testSaveFailureIsNotThrown()
+	{
+		gphoto2pp::AbilitiesCache cache(cacheFile(), {"."});
+		
+		// A moved-from list has no gphoto2 list, so reading it fails half way through the write
+		gphoto2pp::CameraAbilitiesListWrapper abilitiesList;
+		gphoto2pp::CameraAbilitiesListWrapper movedList(std::move(abilitiesList));
+		
+		bool saved = true;
+		TS_ASSERT_THROWS_NOTHING(saved = cache.save(abilitiesList));
+		TS_ASSERT(!saved);
+		
+		// Neither the cache file nor the temporary file is left behind
+		TS_ASSERT(!std::ifstream(cacheFile()).good());
+		TS_ASSERT(!std::ifstream(std::string(cacheFile()) + ".tmp." + std::to_string(::getpid())).good());
+	}
+	
+private:
+	static char const * cacheFile()
+	{
+		return "gphoto2pp_abilities_cache_test.bin";
+	}
+};
@@ -0,0 +1,150 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/async_log_writer.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+class AsyncLogWriter_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+		m_stream = std::tmpfile();
+		Output2FILE::Stream() = m_stream;
+	}
+	
+	void tearDown()
+	{
+		Output2FILE::Stream() = stderr;
+		std::fclose(m_stream);
+	}
+	
+	void testSubsystemLevels()
+	{
+		TS_ASSERT_EQUALS(FILELog::ReportingLevel(logsysPORT), logCRITICAL);
+		
+		FILELog::SetSubsystemLevel(logsysPORT, logDEBUG);
+		TS_ASSERT_EQUALS(FILELog::ReportingLevel(logsysPORT), logDEBUG);
+		TS_ASSERT_EQUALS(FILELog::ReportingLevel(logsysCAMERA), logCRITICAL);
+		
+		FILELog::ResetSubsystemLevel(logsysPORT);
+		TS_ASSERT_EQUALS(FILELog::ReportingLevel(logsysPORT), logCRITICAL);
+	}
+	
+	void testMessagesAreWrittenOnFlush()
+	{
+		FILELog::ReportingLevel() = logINFO;
+		
+		gphoto2pp::AsyncLogWriter writer{16, std::chrono::milliseconds(10000)};
+		
+		FILE_LOG(logINFO) << "first " << 1;
+		std::thread([] { FILE_LOG_S(logsysCAMERA, logERROR) << "second"; }).join();
+		FILE_LOG(logDEBUG) << "filtered";
+		
+		writer.flush();
+		
+		TS_ASSERT_EQUALS(writer.getWrittenCount(), 2u);
+		TS_ASSERT_EQUALS(writer.getDroppedCount(), 0u);
+		
+		auto const output = read();
+		TS_ASSERT(output.find(" INFO: first 1\n") != std::string::npos);
+		TS_ASSERT(output.find(" ERROR: [CAMERA] second\n") != std::string::npos);
+		TS_ASSERT(output.find("filtered") == std::string::npos);
+	}
+	
+	void testFullRingDropsMessages()
+	{
+		FILELog::ReportingLevel() = logINFO;
+		
+		{
+			gphoto2pp::AsyncLogWriter writer{2, std::chrono::milliseconds(10000)};
+			
+			for(int i = 0; i < 5; ++i)
+			{
+				FILE_LOG(logINFO) << "message " << i;
+			}
+			
+			writer.flush();
+			
+			TS_ASSERT_EQUALS(writer.getWrittenCount(), 2u);
+			TS_ASSERT_EQUALS(writer.getDroppedCount(), 3u);
+			
+			// Room again once written
+			FILE_LOG(logINFO) << "after flush";
+		}
+		
+		auto const output = read();
+		TS_ASSERT(output.find("message 1\n") != std::string::npos);
+		TS_ASSERT(output.find("message 2") == std::string::npos);
+		TS_ASSERT(output.find("3 log messages were dropped") != std::string::npos);
+		TS_ASSERT(output.find("after flush\n") != std::string::npos);
+	}
+	
+	void testOnlyOneWriter()
+	{
+		gphoto2pp::AsyncLogWriter writer;
+		
+		TS_ASSERT_THROWS(gphoto2pp::AsyncLogWriter{}, gphoto2pp::exceptions::GPhoto2ppException);
+	}
+	
+	void testLongMessageIsTruncated()
+	{
+		FILELog::ReportingLevel() = logINFO;
+		
+		{
+			gphoto2pp::AsyncLogWriter writer;
+			FILE_LOG(logINFO) << std::string(gphoto2pp::AsyncLogWriter::MaxMessageLength + 10, 'x');
+		}
+		
+		auto const output = read();
+		TS_ASSERT(output.find(std::string(gphoto2pp::AsyncLogWriter::MaxMessageLength, 'x') + " [truncated]\n") != std::string::npos);
+	}
+	
+private:
+	std::string read()
+	{
+		std::fflush(m_stream);
+		std::rewind(m_stream);
+		
+		std::string output;
+		char buffer[256];
+		std::size_t count;
+		while((count = std::fread(buffer, 1, sizeof(buffer), m_stream)) > 0)
+		{
+			output.append(buffer, count);
+		}
+		return output;
+	}
+	
+	FILE* m_stream;
+};
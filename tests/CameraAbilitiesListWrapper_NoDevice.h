@@ -0,0 +1,84 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/camera_abilities_list_wrapper.hpp>
+#include <gphoto2pp/abilities_cache.hpp>
+#include <gphoto2pp/log.h>
+
+#include <cstdio>
+#include <fstream>
+#include <future>
+
+class CameraAbilitiesListWrapper_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+		std::remove(cacheFile());
+	}
+	
+	void tearDown()
+	{
+		std::remove(cacheFile());
+	}
+	
+	// Runs first, since the shared cache can only be set before the shared list is loaded
+	void testSetSharedCache()
+	{
+		TS_ASSERT(gphoto2pp::CameraAbilitiesListWrapper::setSharedCache(gphoto2pp::AbilitiesCache(cacheFile())));
+		
+		auto const & sharedList = gphoto2pp::CameraAbilitiesListWrapper::getShared();
+		
+		// The cache file didn't exist, so the list came from the drivers and was saved
+		TS_ASSERT(!sharedList.getLoadStatistics().FromCache);
+		TS_ASSERT(std::ifstream(cacheFile()).good());
+		
+		TS_ASSERT(!gphoto2pp::CameraAbilitiesListWrapper::setSharedCache(gphoto2pp::AbilitiesCache(cacheFile())));
+	}
+	
+	void testGetShared()
+	{
+		auto const & sharedList = gphoto2pp::CameraAbilitiesListWrapper::getShared();
+		
+		TS_ASSERT_EQUALS(&gphoto2pp::CameraAbilitiesListWrapper::getShared(), &sharedList);
+		
+		auto fromThread = std::async(std::launch::async, []() { return &gphoto2pp::CameraAbilitiesListWrapper::getShared(); });
+		TS_ASSERT_EQUALS(fromThread.get(), &sharedList);
+		
+		gphoto2pp::CameraAbilitiesListWrapper freshList;
+		
+		TS_ASSERT(sharedList.count() > 0);
+		TS_ASSERT_EQUALS(sharedList.count(), freshList.count());
+		TS_ASSERT_DIFFERS(sharedList.getPtr(), freshList.getPtr());
+	}
+	
+private:
+	static char const * cacheFile()
+	{
+		return "gphoto2pp_shared_abilities_test.cache";
+	}
+};
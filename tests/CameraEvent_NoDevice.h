@@ -0,0 +1,105 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/camera_event.hpp>
+#include <gphoto2pp/camera_event_type_wrapper.hpp>
+#include <gphoto2pp/camera_file_path_wrapper.hpp>
+#include <gphoto2pp/log.h>
+
+#include <string>
+
+class CameraEvent_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testWithoutPayload()
+	{
+		gphoto2pp::CameraEvent event{gphoto2pp::CameraEventTypeWrapper::Timeout};
+		
+		TS_ASSERT_EQUALS(event.getType(), gphoto2pp::CameraEventTypeWrapper::Timeout);
+		TS_ASSERT(!event.hasFilePath());
+		TS_ASSERT(!event.hasText());
+		TS_ASSERT(!event.isPropertyChanged());
+		TS_ASSERT_EQUALS(std::string(event.getFolder()), "");
+		TS_ASSERT_EQUALS(event.toText(), "");
+	}
+	
+	void testFilePath()
+	{
+		gphoto2pp::CameraEvent event{gphoto2pp::CameraEventTypeWrapper::FileAdded, "/store_00010001/DCIM/100CANON", "IMG_0001.JPG"};
+		
+		TS_ASSERT(event.hasFilePath());
+		TS_ASSERT(!event.hasText());
+		TS_ASSERT_EQUALS(std::string(event.getFolder()), "/store_00010001/DCIM/100CANON");
+		TS_ASSERT_EQUALS(std::string(event.getName()), "IMG_0001.JPG");
+		
+		auto const path = event.toFilePath();
+		TS_ASSERT_EQUALS(path.Folder, "/store_00010001/DCIM/100CANON");
+		TS_ASSERT_EQUALS(path.Name, "IMG_0001.JPG");
+	}
+	
+	void testLongPayloadOverflows()
+	{
+		std::string const folder(300, 'f');
+		std::string const name(64, 'n');
+		
+		gphoto2pp::CameraEvent event{gphoto2pp::CameraEventTypeWrapper::FolderAdded, folder.c_str(), name.c_str()};
+		
+		TS_ASSERT_EQUALS(std::string(event.getFolder()), folder);
+		TS_ASSERT_EQUALS(std::string(event.getName()), name);
+		
+		// Copies must stay valid
+		gphoto2pp::CameraEvent copy = event;
+		TS_ASSERT_EQUALS(std::string(copy.getFolder()), folder);
+		TS_ASSERT_EQUALS(std::string(copy.getName()), name);
+	}
+	
+	void testPropertyChangedText()
+	{
+		gphoto2pp::CameraEvent event{"PTP Property 500f changed"};
+		
+		TS_ASSERT_EQUALS(event.getType(), gphoto2pp::CameraEventTypeWrapper::Unknown);
+		TS_ASSERT(event.hasText());
+		TS_ASSERT(event.isPropertyChanged());
+		TS_ASSERT_EQUALS(event.getPropertyCode(), 0x500f);
+		TS_ASSERT_EQUALS(event.toText(), "PTP Property 500f changed");
+	}
+	
+	void testPlainText()
+	{
+		gphoto2pp::CameraEvent event{"Button 1"};
+		
+		TS_ASSERT(event.hasText());
+		TS_ASSERT(!event.isPropertyChanged());
+		TS_ASSERT_EQUALS(event.getPropertyCode(), 0);
+		TS_ASSERT_EQUALS(std::string(event.getText()), "Button 1");
+	}
+};
@@ -0,0 +1,157 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/camera_metrics.hpp>
+#include <gphoto2pp/log.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+class CameraMetrics_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+		std::remove(metricsFile());
+	}
+	
+	void tearDown()
+	{
+		std::remove(metricsFile());
+	}
+	
+	void testCounters()
+	{
+		gphoto2pp::CameraMetrics metrics{"Nikon DSC D90", "usb:001,004"};
+		
+		metrics.addCapture();
+		metrics.addCapture();
+		metrics.addPreviewFrame();
+		metrics.addBytesDownloaded(1000);
+		metrics.addBytesDownloaded(24);
+		metrics.addError(-7);
+		metrics.addError(-7);
+		metrics.addError(-1000);
+		metrics.addWaitingCall();
+		
+		TS_ASSERT_EQUALS(metrics.getCaptures(), 2u);
+		TS_ASSERT_EQUALS(metrics.getPreviewFrames(), 1u);
+		TS_ASSERT_EQUALS(metrics.getBytesDownloaded(), 1024u);
+		TS_ASSERT_EQUALS(metrics.getErrors(-7), 2u);
+		TS_ASSERT_EQUALS(metrics.getErrors(-1), 0u);
+		TS_ASSERT_EQUALS(metrics.getErrors(0), 1u);
+		TS_ASSERT_EQUALS(metrics.getWaitingCalls(), 1);
+		
+		metrics.removeWaitingCall();
+		TS_ASSERT_EQUALS(metrics.getWaitingCalls(), 0);
+	}
+	
+	void testReconnectKeepsCounters()
+	{
+		gphoto2pp::MetricsRegistry registry;
+		
+		auto first = registry.connectCamera("Nikon DSC D90", "usb:001,004");
+		first->addCapture();
+		
+		auto again = registry.connectCamera("Nikon DSC D90", "usb:001,004");
+		auto other = registry.connectCamera("Nikon DSC D90", "usb:001,005");
+		
+		TS_ASSERT_EQUALS(again, first);
+		TS_ASSERT_EQUALS(again->getCaptures(), 1u);
+		TS_ASSERT_EQUALS(again->getReconnects(), 1u);
+		TS_ASSERT_EQUALS(other->getReconnects(), 0u);
+		TS_ASSERT_EQUALS(registry.getCameras().size(), 2u);
+	}
+	
+	void testRenderPrometheus()
+	{
+		gphoto2pp::MetricsRegistry registry;
+		
+		auto camera = registry.connectCamera("Canon \"EOS\"", "usb:001,004");
+		camera->addCapture();
+		camera->addError(-110);
+		
+		auto const text = registry.renderPrometheus();
+		
+		TS_ASSERT(text.find("# TYPE gphoto2pp_captures_total counter\n") != std::string::npos);
+		TS_ASSERT(text.find("gphoto2pp_captures_total{model=\"Canon \\\"EOS\\\"\",port=\"usb:001,004\"} 1\n") != std::string::npos);
+		TS_ASSERT(text.find("# TYPE gphoto2pp_waiting_calls gauge\n") != std::string::npos);
+		TS_ASSERT(text.find("gphoto2pp_camera_errors_total{model=\"Canon \\\"EOS\\\"\",port=\"usb:001,004\",code=\"-110\"} 1\n") != std::string::npos);
+		TS_ASSERT(text.find("code=\"other\"") == std::string::npos);
+	}
+	
+	void testFileWriter()
+	{
+		gphoto2pp::MetricsRegistry registry;
+		registry.connectCamera("Nikon DSC D90", "usb:001,004")->addPreviewFrame();
+		
+		{
+			gphoto2pp::MetricsFileWriter writer{registry, metricsFile(), std::chrono::milliseconds(10000)};
+		}
+		
+		std::ifstream input{metricsFile()};
+		std::stringstream text;
+		text << input.rdbuf();
+		
+		TS_ASSERT_EQUALS(text.str(), registry.renderPrometheus());
+	}
+	
+	void testConcurrentWrites()
+	{
+		gphoto2pp::MetricsRegistry registry;
+		registry.connectCamera("Nikon DSC D90", "usb:001,004")->addPreviewFrame();
+		
+		gphoto2pp::MetricsFileWriter writer{registry, metricsFile(), std::chrono::milliseconds(1)};
+		
+		// Both threads and the writer's own thread share the temporary file
+		bool firstWritten = true;
+		bool secondWritten = true;
+		std::thread first{[&]() { for(int i = 0; i < 200; ++i) { firstWritten = writer.write() && firstWritten; } }};
+		std::thread second{[&]() { for(int i = 0; i < 200; ++i) { secondWritten = writer.write() && secondWritten; } }};
+		first.join();
+		second.join();
+		
+		TS_ASSERT(firstWritten);
+		TS_ASSERT(secondWritten);
+		
+		std::ifstream input{metricsFile()};
+		std::stringstream text;
+		text << input.rdbuf();
+		
+		TS_ASSERT_EQUALS(text.str(), registry.renderPrometheus());
+	}
+	
+private:
+	static char const * metricsFile()
+	{
+		return "gphoto2pp_metrics_test.prom";
+	}
+};
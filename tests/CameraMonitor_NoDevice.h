@@ -0,0 +1,84 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/camera_monitor.hpp>
+#include <gphoto2pp/log.h>
+
+class CameraMonitor_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testDiffNothingChanged()
+	{
+		std::vector<gphoto2pp::DetectedCamera> cameras{{"Nikon DSC D90", "usb:001,004"}};
+		std::vector<gphoto2pp::DetectedCamera> arrived, departed;
+		
+		TS_ASSERT(!gphoto2pp::CameraMonitor::diff(cameras, cameras, arrived, departed));
+		TS_ASSERT(arrived.empty());
+		TS_ASSERT(departed.empty());
+	}
+	
+	void testDiffArrivedAndDeparted()
+	{
+		std::vector<gphoto2pp::DetectedCamera> previous{{"Canon EOS 5D", "usb:001,003"}, {"Nikon DSC D90", "usb:001,004"}};
+		std::vector<gphoto2pp::DetectedCamera> current{{"Nikon DSC D90", "usb:001,004"}, {"Nikon DSC D90", "usb:002,007"}};
+		std::vector<gphoto2pp::DetectedCamera> arrived, departed;
+		
+		TS_ASSERT(gphoto2pp::CameraMonitor::diff(previous, current, arrived, departed));
+		
+		TS_ASSERT_EQUALS(arrived.size(), 1);
+		TS_ASSERT_EQUALS(arrived[0].Port, "usb:002,007");
+		
+		TS_ASSERT_EQUALS(departed.size(), 1);
+		TS_ASSERT_EQUALS(departed[0].Model, "Canon EOS 5D");
+	}
+	
+	void testDiffSamePortOtherModel()
+	{
+		// A camera swapped on the same port is one departure and one arrival
+		std::vector<gphoto2pp::DetectedCamera> previous{{"Canon EOS 5D", "usb:001,003"}};
+		std::vector<gphoto2pp::DetectedCamera> current{{"Nikon DSC D90", "usb:001,003"}};
+		std::vector<gphoto2pp::DetectedCamera> arrived, departed;
+		
+		TS_ASSERT(gphoto2pp::CameraMonitor::diff(previous, current, arrived, departed));
+		TS_ASSERT_EQUALS(arrived.size(), 1);
+		TS_ASSERT_EQUALS(departed.size(), 1);
+	}
+	
+	void testInitialInterval()
+	{
+		gphoto2pp::CameraMonitor monitor(std::chrono::milliseconds(100), std::chrono::milliseconds(800));
+		
+		TS_ASSERT(!monitor.isRunning());
+		TS_ASSERT_EQUALS(monitor.getCurrentInterval().count(), 100);
+		TS_ASSERT(monitor.getCameras().empty());
+	}
+};
@@ -0,0 +1,188 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/camera_watchdog.hpp>
+#include <gphoto2pp/context_cancellation.hpp>
+#include <gphoto2pp/log.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class CameraWatchdog_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testCallWithinDeadline()
+	{
+		gphoto2pp::CameraWatchdog watchdog(std::chrono::milliseconds(5));
+		std::atomic<int> hungCount{0};
+		
+		auto registration = watchdog.subscribeToCameraHung([&](gphoto2pp::CameraHungEvent const &){ ++hungCount; });
+		
+		{
+			auto call = watchdog.begin("camera", "gp_camera_file_get", std::chrono::steady_clock::now() + std::chrono::seconds(10), nullptr);
+			
+			TS_ASSERT_EQUALS(watchdog.getInFlightCount(), 1);
+		}
+		
+		TS_ASSERT_EQUALS(watchdog.getInFlightCount(), 0);
+		
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		
+		TS_ASSERT_EQUALS(hungCount, 0);
+	}
+	
+	void testHungCallIsReportedOnceAndCancelled()
+	{
+		gphoto2pp::CameraWatchdog watchdog(std::chrono::milliseconds(5));
+		gphoto2pp::ContextCancellation cancellation;
+		
+		std::mutex mutex;
+		std::vector<gphoto2pp::CameraHungEvent> hungEvents;
+		
+		auto registration = watchdog.subscribeToCameraHung([&](gphoto2pp::CameraHungEvent const & e)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			hungEvents.push_back(e);
+		});
+		
+		gphoto2pp::ContextCancellation::Scope scope(cancellation, gphoto2pp::CancellationToken::none());
+		
+		{
+			auto call = watchdog.begin("Nikon DSC D90 on usb:001,004", "gp_camera_file_get", std::chrono::steady_clock::now() + std::chrono::milliseconds(10), &cancellation);
+			call.locked();
+			
+			std::this_thread::sleep_for(std::chrono::milliseconds(60));
+			
+			TS_ASSERT(cancellation.isCancelled());
+		}
+		
+		std::lock_guard<std::mutex> lock{mutex};
+		
+		TS_ASSERT_EQUALS(hungEvents.size(), 1);
+		TS_ASSERT_EQUALS(hungEvents[0].Operation, "gp_camera_file_get");
+		TS_ASSERT_EQUALS(hungEvents[0].Camera, "Nikon DSC D90 on usb:001,004");
+		TS_ASSERT(hungEvents[0].Elapsed >= hungEvents[0].Allowed);
+		TS_ASSERT(hungEvents[0].HoldsCamera);
+	}
+	
+	void testCallWaitingForTheCameraIsOnlyReported()
+	{
+		gphoto2pp::CameraWatchdog watchdog(std::chrono::milliseconds(5));
+		gphoto2pp::ContextCancellation cancellation;
+		
+		std::mutex mutex;
+		std::vector<gphoto2pp::CameraHungEvent> hungEvents;
+		
+		auto registration = watchdog.subscribeToCameraHung([&](gphoto2pp::CameraHungEvent const & e)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			hungEvents.push_back(e);
+		});
+		
+		gphoto2pp::ContextCancellation::Scope scope(cancellation, gphoto2pp::CancellationToken::none());
+		
+		// A healthy call holds the camera, while another one runs out of time waiting for it
+		auto holding = watchdog.begin("camera", "gp_camera_wait_for_event", std::chrono::steady_clock::now() + std::chrono::seconds(10), &cancellation);
+		holding.locked();
+		
+		{
+			auto waiting = watchdog.begin("camera", "gp_camera_file_get", std::chrono::steady_clock::now() + std::chrono::milliseconds(10), &cancellation);
+			
+			std::this_thread::sleep_for(std::chrono::milliseconds(60));
+			
+			TS_ASSERT(!cancellation.isCancelled());
+		}
+		
+		std::lock_guard<std::mutex> lock{mutex};
+		
+		TS_ASSERT_EQUALS(hungEvents.size(), 1);
+		TS_ASSERT_EQUALS(hungEvents[0].Operation, "gp_camera_file_get");
+		TS_ASSERT(!hungEvents[0].HoldsCamera);
+	}
+	
+	void testThrowingSubscriberKeepsTheWatchdogRunning()
+	{
+		gphoto2pp::CameraWatchdog watchdog(std::chrono::milliseconds(5));
+		std::atomic<int> hungCount{0};
+		
+		auto registration = watchdog.subscribeToCameraHung([&](gphoto2pp::CameraHungEvent const &)
+		{
+			++hungCount;
+			throw std::runtime_error("subscriber failed");
+		});
+		
+		auto first = watchdog.begin("camera", "gp_camera_capture", std::chrono::steady_clock::now() + std::chrono::milliseconds(10), nullptr);
+		std::this_thread::sleep_for(std::chrono::milliseconds(60));
+		
+		// Still checking after the first subscriber threw
+		auto second = watchdog.begin("camera", "gp_camera_file_get", std::chrono::steady_clock::now() + std::chrono::milliseconds(10), nullptr);
+		std::this_thread::sleep_for(std::chrono::milliseconds(60));
+		
+		TS_ASSERT_EQUALS(hungCount, 2);
+	}
+	
+	void testEndedCallDoesntCancelTheNextOne()
+	{
+		gphoto2pp::CameraWatchdog watchdog(std::chrono::milliseconds(5));
+		gphoto2pp::ContextCancellation cancellation;
+		
+		gphoto2pp::ContextCancellation::Scope scope(cancellation, gphoto2pp::CancellationToken::none());
+		
+		auto hung = watchdog.begin("camera", "gp_camera_capture", std::chrono::steady_clock::now() + std::chrono::milliseconds(10), &cancellation);
+		hung.locked();
+		
+		// The hung call released the camera to the next call, but hasn't ended its registration yet
+		auto next = watchdog.begin("camera", "gp_camera_file_get", std::chrono::steady_clock::now() + std::chrono::seconds(10), &cancellation);
+		next.locked();
+		
+		std::this_thread::sleep_for(std::chrono::milliseconds(60));
+		
+		TS_ASSERT(!cancellation.isCancelled());
+	}
+	
+	void testMovedCallEndsOnce()
+	{
+		gphoto2pp::CameraWatchdog watchdog;
+		
+		auto first = watchdog.begin("camera", "gp_camera_capture", std::chrono::steady_clock::now() + std::chrono::seconds(10), nullptr);
+		auto second = std::move(first);
+		
+		TS_ASSERT_EQUALS(watchdog.getInFlightCount(), 1);
+		
+		second = gphoto2pp::CameraWatchdog::Call();
+		
+		TS_ASSERT_EQUALS(watchdog.getInFlightCount(), 0);
+	}
+};
@@ -113,5 +113,20 @@ public:
 		TS_ASSERT_EQUALS(windowWidget.getType(), gphoto2pp::CameraWidgetTypeWrapper::Window);
 	}
 	
+	void testGetView()
+	{
+		auto windowWidget = _camera.getConfig();
+		auto windowView = windowWidget.getView();
+		
+		TS_ASSERT_EQUALS(std::string(windowView.getName()), windowWidget.getName());
+		TS_ASSERT_EQUALS(windowView.getType(), gphoto2pp::CameraWidgetTypeWrapper::Window);
+		TS_ASSERT_EQUALS(windowView.countChildren(), windowWidget.countChildren());
+		
+		// Promoting the view gives back an owning wrapper of the same widget
+		auto windowCopy = windowView.toWidget<gphoto2pp::WindowWidget>();
+		
+		TS_ASSERT_EQUALS(windowCopy.getPtr(), windowWidget.getPtr());
+	}
+	
 	
 };
@@ -0,0 +1,143 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/cancellation_token.hpp>
+#include <gphoto2pp/context_cancellation.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+#include <thread>
+
+class CancellationToken_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testCancelIsShared()
+	{
+		gphoto2pp::CancellationToken token;
+		auto copy = token;
+		
+		TS_ASSERT(!copy.isCancelled());
+		
+		token.cancel();
+		
+		TS_ASSERT(copy.isCancelled());
+	}
+	
+	void testDeadline()
+	{
+		auto token = gphoto2pp::CancellationToken::withTimeout(std::chrono::milliseconds(20));
+		
+		TS_ASSERT(!token.isCancelled());
+		
+		std::this_thread::sleep_for(std::chrono::milliseconds(30));
+		
+		TS_ASSERT(token.isCancelled());
+	}
+	
+	void testNoneIsNeverCancelled()
+	{
+		auto token = gphoto2pp::CancellationToken::none();
+		token.cancel();
+		
+		TS_ASSERT(!gphoto2pp::CancellationToken::none().isCancelled());
+		TS_ASSERT(gphoto2pp::CancellationToken::none().getDeadline() == std::chrono::steady_clock::time_point::max());
+	}
+	
+	void testScopeFollowsTheCurrentToken()
+	{
+		gphoto2pp::ContextCancellation cancellation;
+		gphoto2pp::CancellationToken token;
+		
+		{
+			gphoto2pp::ContextCancellation::Scope scope(cancellation, token);
+			
+			TS_ASSERT(!cancellation.isCancelled());
+			
+			token.cancel();
+			
+			TS_ASSERT(cancellation.isCancelled());
+		}
+		
+		// Out of the scope, the cancelled token no longer applies
+		TS_ASSERT(!cancellation.isCancelled());
+	}
+	
+	void testCancelCurrentOnlyAffectsTheCurrentOperation()
+	{
+		gphoto2pp::ContextCancellation cancellation;
+		
+		{
+			gphoto2pp::ContextCancellation::Scope scope(cancellation, gphoto2pp::CancellationToken::none());
+			cancellation.cancelCurrent();
+			
+			TS_ASSERT(cancellation.isCancelled());
+		}
+		
+		gphoto2pp::ContextCancellation::Scope nextScope(cancellation, gphoto2pp::CancellationToken::none());
+		
+		TS_ASSERT(!cancellation.isCancelled());
+	}
+	
+	void testCancelledTokenFailsBeforeStarting()
+	{
+		gphoto2pp::ContextCancellation cancellation;
+		gphoto2pp::CancellationToken token;
+		token.cancel();
+		
+		TS_ASSERT_THROWS(gphoto2pp::ContextCancellation::Scope(cancellation, token), gphoto2pp::exceptions::gphoto2_exception);
+	}
+	
+	void testCancelCall()
+	{
+		gphoto2pp::ContextCancellation cancellation;
+		
+		gphoto2pp::ContextCancellation::Scope scope(cancellation, gphoto2pp::CancellationToken::none());
+		
+		cancellation.beginCall(1);
+		
+		TS_ASSERT(!cancellation.cancelCall(2));
+		TS_ASSERT(!cancellation.isCancelled());
+		
+		TS_ASSERT(cancellation.cancelCall(1));
+		TS_ASSERT(cancellation.isCancelled());
+		
+		// The next call starts clean, and the end of the previous one doesn't untag it
+		cancellation.beginCall(2);
+		TS_ASSERT(!cancellation.isCancelled());
+		
+		cancellation.endCall(1);
+		TS_ASSERT(cancellation.cancelCall(2));
+		
+		cancellation.endCall(2);
+		TS_ASSERT(!cancellation.cancelCall(2));
+	}
+};
@@ -0,0 +1,105 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/config_cache.hpp>
+#include <gphoto2pp/config_snapshot.hpp>
+#include <gphoto2pp/log.h>
+
+#include <thread>
+
+class ConfigCache_NoDevice : public CxxTest::TestSuite 
+{
+	std::shared_ptr<gphoto2pp::ConfigSnapshot const> _snapshot = std::make_shared<gphoto2pp::ConfigSnapshot const>(gphoto2pp::ConfigSnapshot::fromJson(R"({"version": 1, "widgets": [
+		{"path": "/main/imgsettings/iso", "type": "radio", "readonly": false, "value": "200", "choice": 3},
+		{"path": "/main/capturesettings/zoom", "type": "range", "readonly": false, "value": 3.5}
+	]})"));
+	
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testEmpty()
+	{
+		gphoto2pp::ConfigCache cache;
+		
+		TS_ASSERT(cache.getSnapshot() == nullptr);
+		TS_ASSERT(cache.getSnapshot("iso") == nullptr);
+	}
+	
+	void testInvalidateWidget()
+	{
+		gphoto2pp::ConfigCache cache;
+		cache.publish(_snapshot, cache.beginRefresh());
+		
+		TS_ASSERT_EQUALS(cache.getSnapshot(), _snapshot);
+		
+		cache.invalidate("iso");
+		
+		// Only the stale widget needs a refresh
+		TS_ASSERT(cache.getSnapshot() == nullptr);
+		TS_ASSERT(cache.getSnapshot("iso") == nullptr);
+		TS_ASSERT_EQUALS(cache.getSnapshot("zoom"), _snapshot);
+		
+		cache.publish(_snapshot, cache.beginRefresh());
+		TS_ASSERT_EQUALS(cache.getSnapshot(), _snapshot);
+		
+		cache.invalidate();
+		TS_ASSERT(cache.getSnapshot("zoom") == nullptr);
+	}
+	
+	void testInvalidatedDuringRefresh()
+	{
+		gphoto2pp::ConfigCache cache;
+		
+		auto refreshToken = cache.beginRefresh();
+		cache.invalidate("iso"); // the refresh might have read the old value
+		cache.publish(_snapshot, refreshToken);
+		
+		TS_ASSERT(cache.getSnapshot("iso") == nullptr);
+		TS_ASSERT_EQUALS(cache.getSnapshot("zoom"), _snapshot);
+		
+		refreshToken = cache.beginRefresh();
+		cache.invalidate();
+		cache.publish(_snapshot, refreshToken);
+		
+		TS_ASSERT(cache.getSnapshot("zoom") == nullptr);
+	}
+	
+	void testMaxAge()
+	{
+		gphoto2pp::ConfigCache cache;
+		cache.setMaxAge(std::chrono::milliseconds(20));
+		cache.publish(_snapshot, cache.beginRefresh());
+		
+		TS_ASSERT_EQUALS(cache.getSnapshot(), _snapshot);
+		
+		std::this_thread::sleep_for(std::chrono::milliseconds(40));
+		
+		TS_ASSERT(cache.getSnapshot() == nullptr);
+	}
+};
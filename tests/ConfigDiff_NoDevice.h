@@ -0,0 +1,121 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/config_diff.hpp>
+#include <gphoto2pp/log.h>
+
+class ConfigDiff_NoDevice : public CxxTest::TestSuite 
+{
+	gphoto2pp::ConfigSnapshot _profile = gphoto2pp::ConfigSnapshot::fromJson(R"({"version": 1, "widgets": [
+		{"path": "/main/imgsettings/iso", "type": "radio", "readonly": false, "value": "200", "choice": 3},
+		{"path": "/main/capturesettings/zoom", "type": "range", "readonly": false, "value": 3.5},
+		{"path": "/main/settings/capture", "type": "toggle", "readonly": false, "value": 1},
+		{"path": "/main/status/batterylevel", "type": "text", "readonly": true, "value": "100%"}
+	]})");
+	
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testSameConfig()
+	{
+		TS_ASSERT(gphoto2pp::diffConfig(_profile, _profile).empty());
+		TS_ASSERT(gphoto2pp::diffConfig(_profile, _profile, true).empty());
+	}
+	
+	void testModified()
+	{
+		auto current = gphoto2pp::ConfigSnapshot::fromJson(R"({"version": 1, "widgets": [
+			{"path": "/main/imgsettings/iso", "type": "radio", "readonly": false, "value": "800", "choice": 5},
+			{"path": "/main/capturesettings/zoom", "type": "range", "readonly": false, "value": 3.5},
+			{"path": "/main/settings/capture", "type": "toggle", "readonly": false, "value": 1},
+			{"path": "/main/status/batterylevel", "type": "text", "readonly": true, "value": "50%"}
+		]})");
+		
+		auto changes = gphoto2pp::diffConfig(_profile, current);
+		
+		TS_ASSERT_EQUALS(changes.size(), 1);
+		TS_ASSERT_EQUALS(changes[0].Kind, gphoto2pp::ConfigChangeKind::Modified);
+		TS_ASSERT_EQUALS(changes[0].Path, "/main/imgsettings/iso");
+		TS_ASSERT_EQUALS(changes[0].Old.StringValue, "200");
+		TS_ASSERT_EQUALS(changes[0].Old.ChoiceIndex, 3);
+		TS_ASSERT_EQUALS(changes[0].New.StringValue, "800");
+		TS_ASSERT_EQUALS(changes[0].New.ChoiceIndex, 5);
+		
+		// The battery level only shows up when read only widgets are compared
+		TS_ASSERT_EQUALS(gphoto2pp::diffConfig(_profile, current, true).size(), 2);
+	}
+	
+	void testReorderedAddedRemoved()
+	{
+		auto current = gphoto2pp::ConfigSnapshot::fromJson(R"({"version": 1, "widgets": [
+			{"path": "/main/settings/capture", "type": "toggle", "readonly": false, "value": 0},
+			{"path": "/main/imgsettings/iso", "type": "radio", "readonly": false, "value": "200", "choice": 3},
+			{"path": "/main/imgsettings/whitebalance", "type": "radio", "readonly": false, "value": "Auto", "choice": 0},
+			{"path": "/main/status/batterylevel", "type": "text", "readonly": true, "value": "100%"}
+		]})");
+		
+		auto changes = gphoto2pp::diffConfig(_profile, current);
+		
+		TS_ASSERT_EQUALS(changes.size(), 3);
+		TS_ASSERT_EQUALS(changes[0].Kind, gphoto2pp::ConfigChangeKind::Removed);
+		TS_ASSERT_EQUALS(changes[0].Path, "/main/capturesettings/zoom");
+		TS_ASSERT_EQUALS(changes[1].Kind, gphoto2pp::ConfigChangeKind::Modified);
+		TS_ASSERT_EQUALS(changes[1].Path, "/main/settings/capture");
+		TS_ASSERT_EQUALS(changes[1].Old.IntValue, 1);
+		TS_ASSERT_EQUALS(changes[1].New.IntValue, 0);
+		TS_ASSERT_EQUALS(changes[2].Kind, gphoto2pp::ConfigChangeKind::Added);
+		TS_ASSERT_EQUALS(changes[2].Path, "/main/imgsettings/whitebalance");
+	}
+	
+	void testDuplicatedPath()
+	{
+		// Some drivers have two widgets with the same label in one section
+		auto from = gphoto2pp::ConfigSnapshot::fromJson(R"({"version": 1, "widgets": [
+			{"path": "/main/settings/capture", "type": "toggle", "readonly": false, "value": 1},
+			{"path": "/main/other/d1a0", "type": "text", "readonly": false, "value": "1"},
+			{"path": "/main/capturesettings/zoom", "type": "range", "readonly": false, "value": 3.5},
+			{"path": "/main/other/d1a0", "type": "text", "readonly": false, "value": "2"}
+		]})");
+		
+		auto to = gphoto2pp::ConfigSnapshot::fromJson(R"({"version": 1, "widgets": [
+			{"path": "/main/other/d1a0", "type": "text", "readonly": false, "value": "1"},
+			{"path": "/main/other/d1a0", "type": "text", "readonly": false, "value": "5"},
+			{"path": "/main/capturesettings/zoom", "type": "range", "readonly": false, "value": 3.5},
+			{"path": "/main/settings/capture", "type": "toggle", "readonly": false, "value": 1}
+		]})");
+		
+		auto changes = gphoto2pp::diffConfig(from, to);
+		
+		TS_ASSERT_EQUALS(changes.size(), 1);
+		TS_ASSERT_EQUALS(changes[0].Kind, gphoto2pp::ConfigChangeKind::Modified);
+		TS_ASSERT_EQUALS(changes[0].Path, "/main/other/d1a0");
+		TS_ASSERT_EQUALS(changes[0].Old.StringValue, "2");
+		TS_ASSERT_EQUALS(changes[0].New.StringValue, "5");
+	}
+};
@@ -0,0 +1,130 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/config_snapshot.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+#include <cmath>
+#include <limits>
+
+class ConfigSnapshot_NoDevice : public CxxTest::TestSuite 
+{
+	std::string _json = R"({
+	"version": 1,
+	"widgets": [
+		{"path": "/main/imgsettings/iso", "type": "radio", "readonly": false, "value": "200", "choice": 3},
+		{"path": "/main/capturesettings/zoom", "type": "range", "readonly": false, "value": 3.5},
+		{"path": "/main/settings/capture", "type": "toggle", "readonly": false, "value": 1},
+		{"path": "/main/settings/artist", "type": "text", "readonly": false, "value": "A \"quoted\" name\n"},
+		{"path": "/main/status/batterylevel", "type": "text", "readonly": true, "value": "100%", "unknown": [1, {"a": null}]}
+	]
+})";
+	
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testFromJson()
+	{
+		auto snapshot = gphoto2pp::ConfigSnapshot::fromJson(_json);
+		
+		TS_ASSERT_EQUALS(snapshot.getEntries().size(), 5);
+		
+		auto iso = snapshot.find("iso");
+		TS_ASSERT(iso != nullptr);
+		TS_ASSERT_EQUALS(iso->Path, "/main/imgsettings/iso");
+		TS_ASSERT_EQUALS(iso->Type, gphoto2pp::CameraWidgetTypeWrapper::Radio);
+		TS_ASSERT_EQUALS(iso->StringValue, "200");
+		TS_ASSERT_EQUALS(iso->ChoiceIndex, 3);
+		
+		TS_ASSERT_EQUALS(snapshot.find("/main/capturesettings/zoom")->FloatValue, 3.5f);
+		TS_ASSERT_EQUALS(snapshot.find("capture")->IntValue, 1);
+		TS_ASSERT_EQUALS(snapshot.find("artist")->StringValue, "A \"quoted\" name\n");
+		TS_ASSERT(snapshot.find("batterylevel")->ReadOnly);
+		TS_ASSERT(snapshot.find("missing") == nullptr);
+	}
+	
+	void testRoundTrips()
+	{
+		auto snapshot = gphoto2pp::ConfigSnapshot::fromJson(_json);
+		
+		auto fromBinary = gphoto2pp::ConfigSnapshot::fromBinary(snapshot.toBinary());
+		auto fromJson = gphoto2pp::ConfigSnapshot::fromJson(snapshot.toJson());
+		
+		for(auto const & copy : {fromBinary, fromJson})
+		{
+			TS_ASSERT_EQUALS(copy.getEntries().size(), snapshot.getEntries().size());
+			
+			for(std::size_t i = 0; i < snapshot.getEntries().size(); ++i)
+			{
+				auto const & expected = snapshot.getEntries()[i];
+				auto const & actual = copy.getEntries()[i];
+				
+				TS_ASSERT_EQUALS(actual.Path, expected.Path);
+				TS_ASSERT_EQUALS(actual.Name, expected.Name);
+				TS_ASSERT_EQUALS(actual.Type, expected.Type);
+				TS_ASSERT_EQUALS(actual.ReadOnly, expected.ReadOnly);
+				TS_ASSERT_EQUALS(actual.StringValue, expected.StringValue);
+				TS_ASSERT_EQUALS(actual.FloatValue, expected.FloatValue);
+				TS_ASSERT_EQUALS(actual.IntValue, expected.IntValue);
+				TS_ASSERT_EQUALS(actual.ChoiceIndex, expected.ChoiceIndex);
+			}
+		}
+	}
+	
+	void testInvalidData()
+	{
+		auto binary = gphoto2pp::ConfigSnapshot::fromJson(_json).toBinary();
+		
+		TS_ASSERT_THROWS(gphoto2pp::ConfigSnapshot::fromBinary("nope"), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(gphoto2pp::ConfigSnapshot::fromBinary(binary.substr(0, binary.size() - 1)), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(gphoto2pp::ConfigSnapshot::fromJson("{\"widgets\": [{\"path\": \"/a\", \"type\": \"button\"}]}"), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(gphoto2pp::ConfigSnapshot::fromJson("{\"widgets\": ["), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(gphoto2pp::ConfigSnapshot::fromJson("{\"widgets\": [{\"path\": \"/a\\u12zz\", \"type\": \"text\"}]}"), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(gphoto2pp::ConfigSnapshot::fromJson("{\"widgets\": [{\"path\": \"/a\\u-123\", \"type\": \"text\"}]}"), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(gphoto2pp::ConfigSnapshot::fromJson("{\"widgets\": [{\"path\": \"/a\", \"type\": \"range\", \"value\": \"3.5\"}]}"), gphoto2pp::exceptions::ArgumentException);
+	}
+	
+	void testNonFiniteRange()
+	{
+		auto snapshot = gphoto2pp::ConfigSnapshot::fromJson(R"({"widgets": [
+			{"path": "/a", "type": "range", "value": "NaN"},
+			{"path": "/b", "type": "range", "value": "Infinity"},
+			{"path": "/c", "type": "range", "value": "-Infinity"},
+			{"path": "/d\u00e9", "type": "text", "value": ""}
+		]})");
+		
+		auto copy = gphoto2pp::ConfigSnapshot::fromJson(snapshot.toJson());
+		
+		TS_ASSERT(std::isnan(copy.find("/a")->FloatValue));
+		TS_ASSERT_EQUALS(copy.find("/b")->FloatValue, std::numeric_limits<float>::infinity());
+		TS_ASSERT_EQUALS(copy.find("/c")->FloatValue, -std::numeric_limits<float>::infinity());
+		TS_ASSERT_EQUALS(copy.find("/d\xc3\xa9")->Name, "d\xc3\xa9");
+	}
+};
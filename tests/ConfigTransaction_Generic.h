@@ -0,0 +1,103 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/config_transaction.hpp>
+#include <gphoto2pp/helper_widgets.hpp>
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/camera_widget_type_wrapper.hpp>
+#include <gphoto2pp/window_widget.hpp>
+#include <gphoto2pp/radio_widget.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+class ConfigTransaction_Generic : public CxxTest::TestSuite 
+{
+	gphoto2pp::CameraWrapper _camera;
+	
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testCommitNothing()
+	{
+		gphoto2pp::ConfigTransaction transaction(_camera);
+		
+		TS_ASSERT_EQUALS(transaction.commit(), 0);
+	}
+	
+	void testCommitSameValue()
+	{
+		gphoto2pp::ConfigTransaction transaction(_camera);
+		
+		auto radioNames = gphoto2pp::helper::getAllWidgetsNamesOfType(transaction.getRootWidget(), gphoto2pp::CameraWidgetTypeWrapper::Radio);
+		TS_ASSERT(!radioNames.empty());
+		
+		// Writing back the value the widget already has shouldn't send anything to the camera
+		auto radioWidget = transaction.getRootWidget().getChildByName<gphoto2pp::RadioWidget>(radioNames.front());
+		transaction.stage(radioWidget, radioWidget.getValue());
+		
+		TS_ASSERT_EQUALS(transaction.countChanged(), 0);
+		TS_ASSERT_EQUALS(transaction.commit(), 0);
+	}
+	
+	void testCommitUnstagedChange()
+	{
+		gphoto2pp::ConfigTransaction transaction(_camera);
+		
+		auto radioNames = gphoto2pp::helper::getAllWidgetsNamesOfType(transaction.getRootWidget(), gphoto2pp::CameraWidgetTypeWrapper::Radio);
+		TS_ASSERT(!radioNames.empty());
+		
+		// Flagged through the tree without being staged, it is still written (with the value it already has)
+		auto radioWidget = transaction.getRootWidget().getChildByName<gphoto2pp::RadioWidget>(radioNames.front());
+		radioWidget.setChanged(true);
+		
+		TS_ASSERT_EQUALS(transaction.countChanged(), 0);
+		TS_ASSERT_EQUALS(transaction.commit(), 1);
+	}
+	
+	void testRollback()
+	{
+		gphoto2pp::ConfigTransaction transaction(_camera);
+		
+		auto radioNames = gphoto2pp::helper::getAllWidgetsNamesOfType(transaction.getRootWidget(), gphoto2pp::CameraWidgetTypeWrapper::Radio);
+		auto radioWidget = transaction.getRootWidget().getChildByName<gphoto2pp::RadioWidget>(radioNames.front());
+		auto originalValue = radioWidget.getValue();
+		
+		if(radioWidget.countChoices() > 1)
+		{
+			transaction.stage(radioWidget, radioWidget.choiceToString(radioWidget.getChoice() == 0 ? 1 : 0));
+			TS_ASSERT_EQUALS(transaction.countChanged(), 1);
+		}
+		
+		transaction.rollback();
+		
+		TS_ASSERT_EQUALS(radioWidget.getValue(), originalValue);
+		TS_ASSERT_EQUALS(transaction.commit(), 0);
+	}
+};
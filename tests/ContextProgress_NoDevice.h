@@ -0,0 +1,96 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/context_progress.hpp>
+#include <gphoto2pp/log.h>
+
+#include <thread>
+#include <vector>
+
+class ContextProgress_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testEventsOfOneOperation()
+	{
+		gphoto2pp::ContextProgress progress;
+		std::vector<gphoto2pp::ProgressEvent> started, updated, stopped;
+		
+		auto r1 = progress.subscribe(gphoto2pp::ProgressEventType::Started, [&](gphoto2pp::ProgressEvent const & e){ started.push_back(e); });
+		auto r2 = progress.subscribe(gphoto2pp::ProgressEventType::Updated, [&](gphoto2pp::ProgressEvent const & e){ updated.push_back(e); });
+		auto r3 = progress.subscribe(gphoto2pp::ProgressEventType::Stopped, [&](gphoto2pp::ProgressEvent const & e){ stopped.push_back(e); });
+		
+		auto id = progress.start(1000, "Downloading 'DSC_0001.NEF'");
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		progress.update(id, 500);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		progress.update(id, 1000);
+		progress.stop(id);
+		
+		TS_ASSERT_EQUALS(started.size(), 1);
+		TS_ASSERT_EQUALS(started[0].Id, id);
+		TS_ASSERT_EQUALS(started[0].Text, "Downloading 'DSC_0001.NEF'");
+		TS_ASSERT_EQUALS(started[0].Target, 1000);
+		
+		TS_ASSERT_EQUALS(updated.size(), 2);
+		TS_ASSERT_EQUALS(updated[1].Current, 1000);
+		TS_ASSERT(updated[0].InstantRate > 0);
+		TS_ASSERT(updated[1].AverageRate > 0);
+		TS_ASSERT(updated[1].Elapsed >= updated[0].Elapsed);
+		
+		TS_ASSERT_EQUALS(stopped.size(), 1);
+		TS_ASSERT_EQUALS(stopped[0].Current, 1000);
+		TS_ASSERT(stopped[0].Elapsed >= std::chrono::milliseconds(20));
+	}
+	
+	void testUnknownIdIsIgnored()
+	{
+		gphoto2pp::ContextProgress progress;
+		int count = 0;
+		
+		auto registration = progress.subscribe(gphoto2pp::ProgressEventType::Updated, [&](gphoto2pp::ProgressEvent const &){ ++count; });
+		
+		progress.update(42, 10);
+		progress.stop(42);
+		
+		TS_ASSERT_EQUALS(count, 0);
+	}
+	
+	void testIdsAreUnique()
+	{
+		gphoto2pp::ContextProgress progress;
+		
+		auto first = progress.start(10, "first");
+		auto second = progress.start(10, "second");
+		
+		TS_ASSERT_DIFFERS(first, second);
+	}
+};
@@ -0,0 +1,90 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/exposure_bracketing.hpp>
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/camera_file_wrapper.hpp>
+#include <gphoto2pp/config_snapshot.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+class ExposureBracketing_Generic : public CxxTest::TestSuite 
+{
+	gphoto2pp::CameraWrapper _camera;
+	
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testSetSteps()
+	{
+		gphoto2pp::ExposureBracketing bracketing(_camera);
+		
+		auto original = _camera.getCachedValue("shutterspeed").StringValue;
+		
+		TS_ASSERT_THROWS(bracketing.setSteps(3, 100000), gphoto2pp::exceptions::IndexOutOfRange);
+		TS_ASSERT_THROWS(bracketing.setSteps(3, 0), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(bracketing.setSteps(3, -1), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(bracketing.setValues({"not a shutter speed"}), gphoto2pp::exceptions::ValueOutOfLimits);
+		
+		bracketing.setSteps(1, 1);
+		TS_ASSERT_EQUALS(bracketing.getValues().size(), 1);
+		TS_ASSERT_EQUALS(bracketing.getValues().front(), original);
+	}
+	
+	void testRun()
+	{
+		gphoto2pp::ExposureBracketing bracketing(_camera);
+		
+		auto original = _camera.getCachedValue("shutterspeed").StringValue;
+		
+		try
+		{
+			bracketing.setSteps(3, 1);
+		}
+		catch(gphoto2pp::exceptions::IndexOutOfRange const &)
+		{
+			TS_WARN("The current shutter speed is the first or last choice, so it can't be bracketed");
+			return;
+		}
+		
+		int downloaded = 0;
+		auto result = bracketing.run([&downloaded](gphoto2pp::CameraFilePathWrapper const &, gphoto2pp::CameraFileWrapper& cameraFile)
+		{
+			TS_ASSERT(cameraFile.getDataAndSize().size() > 0);
+			++downloaded;
+		});
+		
+		TS_ASSERT_EQUALS(downloaded, 3);
+		TS_ASSERT_EQUALS(result.Files.size(), 3);
+		TS_ASSERT_EQUALS(result.FrameIntervals.size(), 3);
+		
+		// The original value is written back
+		TS_ASSERT_EQUALS(_camera.getCachedValue("shutterspeed").StringValue, original);
+	}
+};
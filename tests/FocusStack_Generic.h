@@ -0,0 +1,106 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/focus_stack.hpp>
+#include <gphoto2pp/camera_wrapper.hpp>
+#include <gphoto2pp/camera_file_wrapper.hpp>
+#include <gphoto2pp/camera_widget_type_wrapper.hpp>
+#include <gphoto2pp/config_snapshot.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+#include <memory>
+
+class FocusStack_Generic : public CxxTest::TestSuite 
+{
+	gphoto2pp::CameraWrapper _camera;
+	
+	// Not every camera can drive its focus, the tests are skipped on those
+	std::unique_ptr<gphoto2pp::FocusStack> createFocusStack()
+	{
+		try
+		{
+			return std::unique_ptr<gphoto2pp::FocusStack>(new gphoto2pp::FocusStack(_camera));
+		}
+		catch(gphoto2pp::exceptions::GPhoto2ppException const &)
+		{
+			TS_WARN("The camera has no viewfinder or manual focus drive");
+			return nullptr;
+		}
+	}
+	
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testSetSteps()
+	{
+		auto focusStack = createFocusStack();
+		if(!focusStack)
+		{
+			return;
+		}
+		
+		TS_ASSERT_THROWS(focusStack->setSteps(0), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(focusStack->setSteps(-1), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS(focusStack->setRangeStep(0), gphoto2pp::exceptions::ArgumentException);
+		TS_ASSERT_THROWS_NOTHING(focusStack->setSteps(1));
+		
+		if(_camera.getCachedValue("manualfocusdrive").Type == gphoto2pp::CameraWidgetTypeWrapper::Range)
+		{
+			TS_ASSERT_THROWS(focusStack->setRangeStep(1e9f), gphoto2pp::exceptions::ValueOutOfLimits);
+			TS_ASSERT_THROWS(focusStack->setRangeStep(-1e9f), gphoto2pp::exceptions::ValueOutOfLimits);
+		}
+		else
+		{
+			TS_ASSERT_THROWS(focusStack->setChoiceStep("not a focus drive"), gphoto2pp::exceptions::ValueOutOfLimits);
+		}
+	}
+	
+	void testRun()
+	{
+		auto focusStack = createFocusStack();
+		if(!focusStack)
+		{
+			return;
+		}
+		
+		focusStack->setSteps(2);
+		
+		int handled = 0;
+		auto result = focusStack->run([&handled](gphoto2pp::CameraFilePathWrapper const & cameraFilePath, gphoto2pp::CameraFileWrapper& cameraFile)
+		{
+			TS_ASSERT_EQUALS(cameraFilePath.Name, "preview_" + std::to_string(handled) + ".jpg");
+			TS_ASSERT(cameraFile.getDataAndSize().size() > 0);
+			++handled;
+		});
+		
+		TS_ASSERT_EQUALS(handled, 2);
+		TS_ASSERT_EQUALS(result.Steps.size(), 2);
+	}
+};
@@ -0,0 +1,71 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/gp_port_info_list_wrapper.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+#include <future>
+#include <utility>
+
+class GPPortInfoListWrapper_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testGetShared()
+	{
+		auto const & sharedList = gphoto2pp::GPPortInfoListWrapper::getShared();
+		
+		TS_ASSERT_EQUALS(&gphoto2pp::GPPortInfoListWrapper::getShared(), &sharedList);
+		
+		auto fromThread = std::async(std::launch::async, []() { return &gphoto2pp::GPPortInfoListWrapper::getShared(); });
+		TS_ASSERT_EQUALS(fromThread.get(), &sharedList);
+		
+		TS_ASSERT(sharedList.count() >= 0);
+		TS_ASSERT_THROWS(sharedList.lookupPath("not a port"), gphoto2pp::exceptions::gphoto2_exception);
+	}
+	
+	void testMove()
+	{
+		gphoto2pp::GPPortInfoListWrapper portInfoList;
+		auto ptr = portInfoList.getPtr();
+		auto count = portInfoList.count();
+		
+		gphoto2pp::GPPortInfoListWrapper movedList(std::move(portInfoList));
+		TS_ASSERT_EQUALS(movedList.getPtr(), ptr);
+		TS_ASSERT(portInfoList.getPtr() == nullptr);
+		TS_ASSERT_EQUALS(movedList.count(), count);
+		
+		gphoto2pp::GPPortInfoListWrapper assignedList;
+		assignedList = std::move(movedList);
+		TS_ASSERT_EQUALS(assignedList.getPtr(), ptr);
+		TS_ASSERT(movedList.getPtr() == nullptr);
+	}
+};
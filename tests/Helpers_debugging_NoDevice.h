@@ -0,0 +1,91 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/helper_debugging.hpp>
+#include <gphoto2pp/helper_gphoto2.hpp>
+#include <gphoto2pp/exceptions.hpp>
+#include <gphoto2pp/log.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+class Helpers_debugging_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+		std::remove(dumpFile());
+	}
+	
+	void tearDown()
+	{
+		gphoto2pp::helper::debugging::stopPortLogRing();
+		std::remove(dumpFile());
+	}
+	
+	void testRingIsBounded()
+	{
+		gphoto2pp::helper::debugging::startPortLogRing(gphoto2pp::helper::debugging::LogLevelWrapper::Debug, 4);
+		
+		for(int i = 0; i < 8; ++i)
+		{
+			gphoto2pp::checkResponseSilent(-1, "invalid_method");
+		}
+		
+		TS_ASSERT(gphoto2pp::helper::debugging::getPortLogRecords().size() <= 4u);
+	}
+	
+	void testRingDumpedOnError()
+	{
+		gphoto2pp::helper::debugging::startPortLogRing(gphoto2pp::helper::debugging::LogLevelWrapper::Debug, 16, dumpFile());
+		
+		TS_ASSERT_THROWS(gphoto2pp::checkResponse(-1, "invalid_method"), gphoto2pp::exceptions::gphoto2_exception);
+		
+		std::ifstream dump{dumpFile()};
+		std::string firstLine;
+		std::getline(dump, firstLine);
+		
+		TS_ASSERT_EQUALS(firstLine.compare(0, 17, "# invalid_method:"), 0);
+	}
+	
+	void testNoDumpWithoutFile()
+	{
+		gphoto2pp::helper::debugging::startPortLogRing(gphoto2pp::helper::debugging::LogLevelWrapper::Error);
+		
+		TS_ASSERT_THROWS(gphoto2pp::checkResponse(-1, "invalid_method"), gphoto2pp::exceptions::gphoto2_exception);
+		
+		TS_ASSERT(!std::ifstream{dumpFile()}.good());
+	}
+	
+private:
+	static char const * dumpFile()
+	{
+		return "gphoto2pp_port_log_test.txt";
+	}
+};
@@ -29,6 +29,9 @@
 #include <gphoto2pp/exceptions.hpp>
 #include <gphoto2pp/log.h>
 
+#include <cstdint>
+#include <string>
+
 class Helpers_gphoto2_NoDevice : public CxxTest::TestSuite 
 {	
 public:
@@ -57,6 +60,41 @@ public:
 		TS_ASSERT_EQUALS(gphoto2pp::checkResponseSilent(-1,"invalid_method"), -1);
 	}
 	
+	void testCheckResponseRuntimeName()
+	{
+		TS_ASSERT_EQUALS(gphoto2pp::checkResponse(2, std::string("runtime_") + "method"), 2);
+		TS_ASSERT_THROWS(gphoto2pp::checkResponse(-1, std::string("runtime_") + "method"), gphoto2pp::exceptions::gphoto2_exception);
+	}
+	
+	void testErrorCounts()
+	{
+		auto const countOf = [] (std::string const & operation, int resultCode) -> std::uint64_t
+		{
+			for(auto const & count : gphoto2pp::getResponseErrorCounts())
+			{
+				if(count.Operation == operation && count.ResultCode == resultCode)
+				{
+					return count.Count;
+				}
+			}
+			return 0;
+		};
+		
+		gphoto2pp::checkResponseSilent(0, "counted_method");
+		gphoto2pp::checkResponseSilent(-1, "counted_method");
+		gphoto2pp::checkResponseSilent(-1, "counted_method");
+		gphoto2pp::checkResponseSilent(-2, "counted_method");
+		
+		TS_ASSERT_EQUALS(countOf("counted_method", -1), 2u);
+		TS_ASSERT_EQUALS(countOf("counted_method", -2), 1u);
+		TS_ASSERT_EQUALS(countOf("counted_method", 0), 0u);
+		
+		// Still thrown, but a cancellation isn't a failure of the method
+		int const cancelled = -112; // GP_ERROR_CANCEL
+		TS_ASSERT_THROWS(gphoto2pp::checkResponse(cancelled, "cancelled_method"), gphoto2pp::exceptions::gphoto2_exception);
+		TS_ASSERT_EQUALS(countOf("cancelled_method", cancelled), 0u);
+	}
+	
 	void testLibraryVersion()
 	{
 		auto version = gphoto2pp::LibraryVersion();
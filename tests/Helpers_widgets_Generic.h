@@ -44,4 +44,32 @@ public:
 	{
 		TS_ASSERT_THROWS_NOTHING(gphoto2pp::helper::getAllWidgetsNames(_camera.getConfig()));
 	}
+	
+	void testVisitWidgets()
+	{
+		auto rootWidget = _camera.getConfig();
+		auto allNames = gphoto2pp::helper::getAllWidgetsNames(rootWidget, true);
+		
+		std::size_t visited = 0;
+		bool completed = gphoto2pp::helper::visitWidgets(rootWidget, [&](gphoto2pp::WidgetView const & widget, gphoto2pp::helper::WidgetPath const & parentPath)
+		{
+			TS_ASSERT_EQUALS(allNames.at(visited), parentPath.toString() + "/" + widget.getName());
+			++visited;
+			return gphoto2pp::helper::VisitResult::Continue;
+		});
+		
+		TS_ASSERT(completed);
+		TS_ASSERT_EQUALS(visited, allNames.size());
+		
+		// Stopping on the first widget must not visit anything else
+		visited = 0;
+		completed = gphoto2pp::helper::visitWidgets(rootWidget, [&](gphoto2pp::WidgetView const &, gphoto2pp::helper::WidgetPath const &)
+		{
+			++visited;
+			return gphoto2pp::helper::VisitResult::Stop;
+		});
+		
+		TS_ASSERT(!completed);
+		TS_ASSERT_EQUALS(visited, 1);
+	}
 };
@@ -0,0 +1,126 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/latency_histogram.hpp>
+#include <gphoto2pp/log.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+class LatencyHistogram_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testBucketsAreOrderedAndClose()
+	{
+		std::size_t previous = 0;
+		
+		for(std::uint64_t microseconds = 0; microseconds < 1000000; microseconds += 1 + microseconds / 16)
+		{
+			auto const index = gphoto2pp::LatencyHistogram::bucketIndex(microseconds);
+			auto const value = gphoto2pp::LatencyHistogram::bucketValue(index);
+			
+			TS_ASSERT(index >= previous);
+			TS_ASSERT(value * 8 <= microseconds * 9 + 8);
+			TS_ASSERT(value * 8 + 8 >= microseconds * 7);
+			
+			previous = index;
+		}
+		
+		TS_ASSERT_EQUALS(gphoto2pp::LatencyHistogram::bucketIndex(~std::uint64_t{0}), gphoto2pp::LatencyHistogram::BucketCount - 1);
+	}
+	
+	void testEmptySnapshot()
+	{
+		gphoto2pp::LatencyHistogram histogram;
+		auto const snapshot = histogram.snapshot();
+		
+		TS_ASSERT_EQUALS(snapshot.Count, 0u);
+		TS_ASSERT_EQUALS(snapshot.P99.count(), 0);
+		TS_ASSERT_EQUALS(snapshot.Max.count(), 0);
+	}
+	
+	void testPercentiles()
+	{
+		gphoto2pp::LatencyHistogram histogram;
+		
+		// 98 fast calls and 2 slow ones
+		for(int i = 0; i < 98; ++i)
+		{
+			histogram.record(std::chrono::microseconds(1000));
+		}
+		histogram.record(std::chrono::microseconds(50000));
+		histogram.record(std::chrono::microseconds(80000));
+		
+		auto const snapshot = histogram.snapshot();
+		
+		TS_ASSERT_EQUALS(snapshot.Count, 100u);
+		TS_ASSERT_EQUALS(snapshot.Max.count(), 80000);
+		TS_ASSERT_EQUALS(snapshot.Mean.count(), (98 * 1000 + 50000 + 80000) / 100);
+		TS_ASSERT(snapshot.P50.count() >= 875 && snapshot.P50.count() <= 1125);
+		TS_ASSERT(snapshot.P99.count() >= 43750 && snapshot.P99.count() <= 56250);
+	}
+	
+	void testOperationsAreTimedApart()
+	{
+		gphoto2pp::OperationLatencies latencies;
+		
+		{
+			auto timer = latencies.begin("gp_camera_capture");
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			timer.locked();
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		
+		{
+			// Found by name, not only by address
+			std::string const name{"gp_camera_capture"};
+			auto timer = latencies.begin(name.c_str());
+			timer.locked();
+		}
+		
+		{
+			// Never got the lock, so not recorded
+			auto timer = latencies.begin("gp_camera_file_get");
+		}
+		
+		auto const snapshots = latencies.snapshot();
+		
+		TS_ASSERT_EQUALS(snapshots.size(), 2u);
+		TS_ASSERT_EQUALS(snapshots[0].Operation, "gp_camera_capture");
+		TS_ASSERT_EQUALS(snapshots[0].Io.Count, 2u);
+		TS_ASSERT(snapshots[0].LockWait.Max >= std::chrono::milliseconds(5));
+		TS_ASSERT(snapshots[0].Io.Max >= std::chrono::milliseconds(10));
+		TS_ASSERT_EQUALS(snapshots[1].Operation, "gp_camera_file_get");
+		TS_ASSERT_EQUALS(snapshots[1].Io.Count, 0u);
+	}
+};
@@ -83,6 +83,17 @@ public:
 		auto isoWidget = _camera.getConfig().getChildByName<gphoto2pp::RadioWidget>("iso");
 		
 		TS_ASSERT_THROWS(isoWidget.setChoice(99), gphoto2pp::exceptions::IndexOutOfRange);
+		TS_ASSERT_THROWS(isoWidget.setChoice(-1), gphoto2pp::exceptions::IndexOutOfRange);
+	}
+	
+	void testChoiceLookups()
+	{
+		auto isoWidget = _camera.getConfig().getChildByName<gphoto2pp::RadioWidget>("iso");
+		
+		// 0 should be ISO=100
+		TS_ASSERT_EQUALS(isoWidget.stringToChoice(isoWidget.choiceToString(0)), 0);
+		TS_ASSERT_EQUALS(isoWidget.stringToChoice(isoWidget.getValue()), isoWidget.getChoice());
+		TS_ASSERT_THROWS(isoWidget.stringToChoice("not an iso"), gphoto2pp::exceptions::ValueOutOfLimits);
 	}
 	
 	void testISO_RadioWidget()
@@ -0,0 +1,220 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/observer.hpp>
+#include <gphoto2pp/log.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	enum class DenseTestEvent : int { First, Second, Third };
+}
+
+namespace gphoto2pp
+{
+	namespace observer
+	{
+		template <>
+		struct DenseEventTraits<DenseTestEvent>
+		{
+			static const std::size_t Count = 3;
+		};
+	}
+}
+
+class Observer_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	enum class TestEvent : int { First, Second };
+	
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testSubjectNotifiesUntilUnregistered()
+	{
+		gphoto2pp::observer::Subject<void(int)> subject;
+		int sum = 0;
+		
+		auto registration = subject.registerObserver([&](int value){ sum += value; });
+		subject(2);
+		
+		registration.reset();
+		subject(3);
+		
+		TS_ASSERT_EQUALS(sum, 2);
+	}
+	
+	void testSubjectEventOnlyNotifiesItsType()
+	{
+		gphoto2pp::observer::SubjectEvent<TestEvent, void(int)> subject;
+		int first = 0, second = 0;
+		
+		auto r1 = subject.registerObserver(TestEvent::First, [&](int value){ first += value; });
+		subject(TestEvent::First, 1);
+		subject(TestEvent::Second, 10);
+		
+		auto r2 = subject.registerObserver(TestEvent::Second, [&](int value){ second += value; });
+		subject(TestEvent::Second, 10);
+		
+		TS_ASSERT_EQUALS(first, 1);
+		TS_ASSERT_EQUALS(second, 10);
+	}
+	
+	void testRegistrationFollowsAMovedSubject()
+	{
+		gphoto2pp::observer::SubjectEvent<TestEvent, void(int)> original;
+		int count = 0;
+		
+		auto registration = original.registerObserver(TestEvent::First, [&](int){ ++count; });
+		
+		auto moved = std::move(original);
+		moved(TestEvent::First, 0);
+		
+		// Unregisters from the moved subject, the original is no longer involved
+		registration.reset();
+		moved(TestEvent::First, 0);
+		original(TestEvent::First, 0);
+		
+		TS_ASSERT_EQUALS(count, 1);
+	}
+	
+	void testRegistrationOutlivesSubject()
+	{
+		gphoto2pp::observer::Registration registration;
+		
+		{
+			gphoto2pp::observer::Subject<void()> subject;
+			registration = subject.registerObserver([]{});
+		}
+		
+		// Must not touch the destroyed subject
+		registration.reset();
+	}
+	
+	void testUnregisterWhileNotifying()
+	{
+		gphoto2pp::observer::Subject<void()> subject;
+		gphoto2pp::observer::Registration registration;
+		int count = 0;
+		
+		registration = subject.registerObserver([&]{ ++count; registration.reset(); });
+		
+		subject();
+		subject();
+		
+		TS_ASSERT_EQUALS(count, 1);
+	}
+	
+	void testRegisterFromOtherThreadsWhileNotifying()
+	{
+		gphoto2pp::observer::SubjectEvent<TestEvent, void()> subject;
+		std::atomic<bool> done{false};
+		std::atomic<int> calls{0};
+		
+		std::thread notifier([&]
+		{
+			while(!done)
+			{
+				subject(TestEvent::First);
+			}
+		});
+		
+		std::vector<std::thread> subscribers;
+		for(int t = 0; t < 4; ++t)
+		{
+			subscribers.emplace_back([&]
+			{
+				for(int i = 0; i < 200; ++i)
+				{
+					auto registration = subject.registerObserver(TestEvent::First, [&]{ ++calls; });
+				}
+			});
+		}
+		
+		for(auto& subscriber : subscribers)
+		{
+			subscriber.join();
+		}
+		done = true;
+		notifier.join();
+		
+		// Every registration expired, so nothing is left to call
+		int const before = calls;
+		subject(TestEvent::First);
+		TS_ASSERT_EQUALS(calls, before);
+	}
+	
+	void testDenseSubjectEvent()
+	{
+		gphoto2pp::observer::SubjectEvent<DenseTestEvent, void(int)> subject;
+		int first = 0, third = 0;
+		
+		TS_ASSERT(!subject.hasObservers(DenseTestEvent::First));
+		
+		auto r1 = subject.registerObserver(DenseTestEvent::First, [&](int value){ first += value; });
+		auto r3 = subject.registerObserver(DenseTestEvent::Third, [&](int value){ third += value; });
+		
+		TS_ASSERT(subject.hasObservers(DenseTestEvent::First));
+		TS_ASSERT(!subject.hasObservers(DenseTestEvent::Second));
+		
+		subject(DenseTestEvent::First, 1);
+		subject(DenseTestEvent::Second, 10);
+		subject(DenseTestEvent::Third, 100);
+		
+		// Values outside of the enum are ignored
+		subject(static_cast<DenseTestEvent>(7), 1000);
+		
+		r1.reset();
+		subject(DenseTestEvent::First, 1);
+		
+		TS_ASSERT(!subject.hasObservers(DenseTestEvent::First));
+		TS_ASSERT_EQUALS(first, 1);
+		TS_ASSERT_EQUALS(third, 100);
+	}
+	
+	void testDenseRegisterOutOfRange()
+	{
+		gphoto2pp::observer::SubjectEvent<DenseTestEvent, void()> subject;
+		
+		TS_ASSERT_THROWS(subject.registerObserver(static_cast<DenseTestEvent>(3), []{}), std::out_of_range);
+	}
+	
+	void testMapSubjectHasObservers()
+	{
+		gphoto2pp::observer::SubjectEvent<TestEvent, void()> subject;
+		
+		auto registration = subject.registerObserver(TestEvent::Second, []{});
+		
+		TS_ASSERT(subject.hasObservers(TestEvent::Second));
+		TS_ASSERT(!subject.hasObservers(TestEvent::First));
+	}
+};
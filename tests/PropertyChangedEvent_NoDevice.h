@@ -0,0 +1,75 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/property_changed_event.hpp>
+#include <gphoto2pp/log.h>
+
+class PropertyChangedEvent_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testStandardProperty()
+	{
+		gphoto2pp::PropertyChangedEvent event;
+		
+		TS_ASSERT(gphoto2pp::parsePropertyChangedEvent("PTP Property 500f changed", event));
+		TS_ASSERT_EQUALS(event.PropertyCode, 0x500f);
+		TS_ASSERT_EQUALS(event.WidgetName, "iso");
+		
+		// Newer drivers append the values
+		TS_ASSERT(gphoto2pp::parsePropertyChangedEvent("PTP Property 500D changed, \"1/60\" to \"1/125\"", event));
+		TS_ASSERT_EQUALS(event.PropertyCode, 0x500d);
+		TS_ASSERT_EQUALS(event.WidgetName, "shutterspeed");
+	}
+	
+	void testVendorProperty()
+	{
+		gphoto2pp::PropertyChangedEvent event;
+		
+		TS_ASSERT(gphoto2pp::parsePropertyChangedEvent("PTP Property d00e changed", event));
+		TS_ASSERT_EQUALS(event.PropertyCode, 0xd00e);
+		TS_ASSERT(event.WidgetName.empty());
+	}
+	
+	void testNotAPropertyChange()
+	{
+		gphoto2pp::PropertyChangedEvent event{0x1234, "unchanged"};
+		
+		TS_ASSERT(!gphoto2pp::parsePropertyChangedEvent("", event));
+		TS_ASSERT(!gphoto2pp::parsePropertyChangedEvent("No Event Data Returned", event));
+		TS_ASSERT(!gphoto2pp::parsePropertyChangedEvent("PTP Property 50 changed", event));
+		TS_ASSERT(!gphoto2pp::parsePropertyChangedEvent("PTP Property 500fa changed", event));
+		TS_ASSERT(!gphoto2pp::parsePropertyChangedEvent("PTP Property zzzz changed", event));
+		TS_ASSERT(!gphoto2pp::parsePropertyChangedEvent("PTP Property 500f", event));
+		
+		TS_ASSERT_EQUALS(event.PropertyCode, 0x1234);
+		TS_ASSERT_EQUALS(event.WidgetName, "unchanged");
+	}
+};
@@ -0,0 +1,73 @@
+/** \file 
+ * \author Copyright (c) 2013 maldworth <https://github.com/maldworth>
+ *
+ * \note
+ * This file is part of gphoto2pp
+ * 
+ * \note
+ * gphoto2pp is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * \note
+ * gphoto2pp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * \note
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with gphoto2pp.
+ * If not, see http://www.gnu.org/licenses
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include <gphoto2pp/timelapse_scheduler.hpp>
+#include <gphoto2pp/log.h>
+
+class TimelapseScheduler_NoDevice : public CxxTest::TestSuite 
+{
+public:
+	void setUp()
+	{
+		FILELog::ReportingLevel() = logCRITICAL;
+	}
+	
+	void testEmptyStatistics()
+	{
+		auto statistics = gphoto2pp::TimelapseScheduler::computeJitterStatistics({});
+		
+		TS_ASSERT_EQUALS(statistics.Triggered, 0);
+		TS_ASSERT_EQUALS(statistics.MaxJitter.count(), 0);
+	}
+	
+	void testJitterStatistics()
+	{
+		std::vector<std::chrono::microseconds> jitters;
+		
+		// 1..100 in reverse, the statistics must not depend on the order
+		for(int i = 100; i > 0; --i)
+		{
+			jitters.push_back(std::chrono::microseconds(i));
+		}
+		
+		auto statistics = gphoto2pp::TimelapseScheduler::computeJitterStatistics(jitters);
+		
+		TS_ASSERT_EQUALS(statistics.Triggered, 100);
+		TS_ASSERT_EQUALS(statistics.MinJitter.count(), 1);
+		TS_ASSERT_EQUALS(statistics.MaxJitter.count(), 100);
+		TS_ASSERT_EQUALS(statistics.MeanJitter.count(), 50);
+		TS_ASSERT_EQUALS(statistics.P50Jitter.count(), 50);
+		TS_ASSERT_EQUALS(statistics.P99Jitter.count(), 99);
+	}
+	
+	void testSingleJitter()
+	{
+		auto statistics = gphoto2pp::TimelapseScheduler::computeJitterStatistics({std::chrono::microseconds(7)});
+		
+		TS_ASSERT_EQUALS(statistics.P50Jitter.count(), 7);
+		TS_ASSERT_EQUALS(statistics.P99Jitter.count(), 7);
+	}
+};